@@ -28,6 +28,7 @@ public:
     // Utility methods
     bool hasValidPosition() const;
     void reset();
+    void setSeed(unsigned int seed);
     
 private:
     Position position_;
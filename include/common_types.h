@@ -23,6 +23,7 @@ struct GameConfig {
     static constexpr double CELL_HEIGHT = 2.0 / GRID_SIZE_Y;
     static constexpr unsigned long MAX_DELAY = 200000;
     static constexpr int DEFAULT_GAME_SPEED = 1;
+    static constexpr int BASE_STEP_INTERVAL_MS = 150; // Simulation step at game speed 1
 };
 
 // Direction enumeration with better naming
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "common_types.h"
+#include <array>
+#include <chrono>
 #include <memory>
 #include <functional>
+#include <optional>
 
 namespace SnakeGame {
 
@@ -28,6 +31,7 @@ public:
     void reset();
     void step();
     bool isGameOver() const;
+    void setSeed(unsigned int seed); // Apple placements after this call are reproducible
     
     // Game state management
     void setState(GameStateType state);
@@ -41,10 +45,12 @@ public:
     // Speed management
     void setGameSpeed(int speed);
     int getGameSpeed() const;
+    std::chrono::microseconds getStepInterval() const; // Simulation time per step at the current speed
     
-    // Direction control (for human players)
+    // Direction control (for human players): turns are queued and applied one per step
     void setDirection(Direction dir);
     Direction getCurrentDirection() const;
+    std::optional<std::chrono::steady_clock::time_point> takeAppliedInputTime(); // Key time of the turn the last step made
     
     // RL Interface methods
     std::vector<double> getStateVector() const;
@@ -78,11 +84,25 @@ private:
     // RL callback - function pointer
     std::function<void(double)> reward_callback_;
     
+    // Buffered turns, so several key presses within one step are all kept
+    struct QueuedInput {
+        Direction direction;
+        std::chrono::steady_clock::time_point time;
+    };
+    static constexpr size_t INPUT_QUEUE_CAPACITY = 4;
+    std::array<QueuedInput, INPUT_QUEUE_CAPACITY> input_queue_;
+    size_t input_head_;
+    size_t input_count_;
+    std::optional<std::chrono::steady_clock::time_point> applied_input_time_;
+    
     // Internal helper methods
     void handleCollision();
     void handleAppleEaten();
     double calculateReward() const;
     void updateGameLogic();
+    void applyDirection(Direction dir);
+    void clearInputQueue();
+    static bool isReversal(Direction from, Direction to);
     
     // Prevent copying
     Game(const Game&) = delete;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "common_types.h"
+#include <chrono>
+#include <cstdio>
 #include <string>
 #include <memory>
 
@@ -22,6 +24,7 @@ public:
     
     // Core rendering interface
     virtual void initialize() = 0;
+    virtual bool isFrameDue() const { return true; } // false lets callers skip drawing a frame
     virtual void clear() = 0;
     virtual void present() = 0;
     virtual void shutdown() = 0;
@@ -47,7 +50,11 @@ public:
  * @brief OpenGL-based graphics implementation
  * 
  * This class implements the Graphics interface using OpenGL and FreeGLUT
- * for traditional windowed gameplay.
+ * for traditional windowed gameplay. Cells are not drawn one by one: each
+ * draw call appends a quad to a client-side vertex array, using grid-to-NDC
+ * tables computed once, and the whole batch is submitted with a single
+ * glDrawArrays() before text or at present(). Only OpenGL 1.1 vertex arrays
+ * are used, so this also runs on Mesa's software renderer.
  */
 class OpenGLGraphics : public Graphics {
 public:
@@ -81,12 +88,24 @@ public:
     void setKeyboardCallbacks();
     
 private:
+    // One corner of a batched cell quad
+    struct Vertex {
+        float x, y;
+        unsigned char r, g, b, a;
+    };
+    
     int window_id_;
     bool initialized_;
     std::optional<Direction> pending_direction_;
     
+    // Cell batch for the current frame and precomputed cell centers
+    std::vector<Vertex> vertices_;
+    std::vector<float> cell_x_;
+    std::vector<float> cell_y_;
+    
     // Helper methods
-    void drawRectangle(const Position& pos, EntityType type);
+    void queueCell(const Position& pos, EntityType type);
+    void flushCells();
     void drawText(double x, double y, const std::string& text, void* font);
     Position worldToScreen(const Position& world_pos) const;
     
@@ -121,33 +140,60 @@ public:
     void present() override {}
     void shutdown() override {}
     
-    void drawSnake(const Snake& snake) override {}
-    void drawApple(const Apple& apple) override {}
-    void drawScore(unsigned int score, unsigned int high_score) override {}
+    void drawSnake(const Snake& /*snake*/) override {}
+    void drawApple(const Apple& /*apple*/) override {}
+    void drawScore(unsigned int /*score*/, unsigned int /*high_score*/) override {}
     void drawGameOver() override {}
     void drawPaused() override {}
     void drawHelp() override {}
     
-    void setWindowTitle(const std::string& title) override {}
+    void setWindowTitle(const std::string& /*title*/) override {}
     bool shouldClose() const override { return false; }
     
     std::optional<Direction> getInputDirection() override { return std::nullopt; }
-    bool isKeyPressed(char key) const override { return false; }
+    bool isKeyPressed(char /*key*/) const override { return false; }
+};
+
+/**
+ * @brief Settings for ConsoleGraphics
+ */
+struct ConsoleConfig {
+    double max_fps = 30.0;          // Frames written per second at most (0 writes every frame)
+    bool diff = true;               // false rewrites the whole frame every time
+    bool color = true;              // ANSI colors for the snake and apple
+    std::FILE* output = stdout;
+};
+
+/**
+ * @brief Output counters of a ConsoleGraphics instance
+ */
+struct ConsoleStats {
+    size_t frames_written = 0;
+    size_t cells_written = 0;       // Characters that differed from the previous frame
+    size_t bytes_written = 0;       // Including escape sequences
 };
 
 /**
  * @brief Console-based graphics implementation
  * 
- * This class provides a simple text-based rendering for debugging
- * or lightweight testing.
+ * Draws the board with ANSI escape sequences in a fixed block at the top of
+ * the terminal. The last written frame is kept, and present() only emits the
+ * characters that changed, each reached by a cursor move unless it directly
+ * follows the previous one, in a single write. isFrameDue() turns false until
+ * 1/max_fps has passed since the last frame, so Game::render() skips drawing
+ * altogether and watching a fast environment costs about one clock read per
+ * step. Lines below the board form a scroll region, so ordinary console
+ * output such as training progress keeps working underneath.
  */
 class ConsoleGraphics : public Graphics {
 public:
     ConsoleGraphics();
-    ~ConsoleGraphics() override = default;
+    explicit ConsoleGraphics(const ConsoleConfig& config);
+    ~ConsoleGraphics() override;
     
     // Console-specific implementations
     void initialize() override;
+    bool isFrameDue() const override;
     void clear() override;
     void present() override;
     void shutdown() override;
@@ -165,13 +211,33 @@ public:
     std::optional<Direction> getInputDirection() override;
     bool isKeyPressed(char key) const override;
     
+    ConsoleStats getStats() const;
+    
 private:
-    std::vector<std::vector<char>> screen_buffer_;
+    ConsoleConfig config_;
+    ConsoleStats stats_;
+    bool initialized_;
     bool should_close_;
     
+    // Frame being drawn, the last frame written and the empty board
+    std::vector<std::vector<char>> screen_buffer_;
+    std::vector<std::vector<char>> previous_buffer_;
+    std::vector<std::vector<char>> blank_buffer_;
+    std::string output_;
+    
+    std::chrono::steady_clock::duration frame_interval_;
+    std::chrono::steady_clock::time_point next_frame_time_;
+    
     void initializeScreenBuffer();
-    void printScreenBuffer() const;
+    void writeChanges();
+    void writeText(int row, const std::string& text);
+    void setCell(const Position& pos, EntityType type);
     char getEntityChar(EntityType type) const;
+    const char* getCharColor(char c) const;
+    
+    // Copy prevention
+    ConsoleGraphics(const ConsoleGraphics&) = delete;
+    ConsoleGraphics& operator=(const ConsoleGraphics&) = delete;
 };
 
 // Factory function for creating graphics instances
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Appends compact binary values to a byte buffer
+ *
+ * Unsigned integers are LEB128 varints (7 bits per byte), signed integers are
+ * zigzag-mapped first so small negative numbers stay short, and floating point
+ * values are copied in host byte order (both ends run on the same machine).
+ */
+class ByteWriter {
+public:
+    void putVarint(uint64_t value) {
+        while (value >= 0x80) {
+            bytes_.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes_.push_back(static_cast<uint8_t>(value));
+    }
+
+    void putZigzag(int64_t value) {
+        putVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void putByte(uint8_t value) {
+        bytes_.push_back(value);
+    }
+
+    void putFloat(float value) {
+        putRaw(&value, sizeof(value));
+    }
+
+    void putDouble(double value) {
+        putRaw(&value, sizeof(value));
+    }
+
+    void putFloats(const float* values, size_t count) {
+        putRaw(values, count * sizeof(float));
+    }
+
+    void putUint64(uint64_t value) {
+        putRaw(&value, sizeof(value));
+    }
+
+    void clear() { bytes_.clear(); }
+    size_t size() const { return bytes_.size(); }
+    const uint8_t* data() const { return bytes_.data(); }
+    std::vector<uint8_t>& buffer() { return bytes_; }
+
+private:
+    std::vector<uint8_t> bytes_;
+
+    void putRaw(const void* data, size_t size) {
+        const uint8_t* begin = static_cast<const uint8_t*>(data);
+        bytes_.insert(bytes_.end(), begin, begin + size);
+    }
+};
+
+/**
+ * @brief Reads values written by ByteWriter, throwing on truncated input
+ */
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size), offset_(0) {}
+
+    uint64_t getVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = getByte();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Malformed varint in binary message");
+    }
+
+    int64_t getZigzag() {
+        uint64_t value = getVarint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    uint8_t getByte() {
+        require(1);
+        return data_[offset_++];
+    }
+
+    float getFloat() {
+        float value;
+        getRaw(&value, sizeof(value));
+        return value;
+    }
+
+    double getDouble() {
+        double value;
+        getRaw(&value, sizeof(value));
+        return value;
+    }
+
+    void getFloats(float* values, size_t count) {
+        getRaw(values, count * sizeof(float));
+    }
+
+    uint64_t getUint64() {
+        uint64_t value;
+        getRaw(&value, sizeof(value));
+        return value;
+    }
+
+    size_t remaining() const { return size_ - offset_; }
+    size_t position() const { return offset_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t offset_;
+
+    void require(size_t count) const {
+        if (count > size_ - offset_) {
+            throw std::runtime_error("Truncated binary message");
+        }
+    }
+
+    void getRaw(void* out, size_t count) {
+        require(count);
+        std::memcpy(out, data_ + offset_, count);
+        offset_ += count;
+    }
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "q_learning_agent.h"
+#include "delta_checkpoint.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief On-disk layout of background checkpoints
+ */
+enum class CheckpointFormat {
+    TEXT, // One full <prefix>_<episode>.txt per checkpoint (QLearningAgent::save format)
+    DELTA // <prefix>.qck base plus one file of changed rows per checkpoint
+};
+
+/**
+ * @brief Settings for periodic background checkpoints
+ */
+struct CheckpointConfig {
+    std::string prefix = "q_checkpoint";
+    CheckpointFormat format = CheckpointFormat::TEXT;
+    size_t keep_last = 3; // TEXT: older checkpoints of this run are deleted
+};
+
+/**
+ * @brief Totals reported by a CheckpointWriter
+ */
+struct CheckpointStats {
+    size_t written = 0;
+    size_t skipped = 0;  // Submitted while the previous checkpoint was still pending
+    size_t failed = 0;
+    double snapshot_seconds = 0.0; // Spent on the training thread
+    double write_seconds = 0.0;    // Spent on the writer thread
+    size_t bytes_written = 0;
+    std::string last_path;
+};
+
+/**
+ * @brief Writes Q-learning checkpoints on a background thread
+ *
+ * The writer owns two snapshot buffers. submit() copies the agent's model
+ * into the back buffer on the calling thread; the copy is the only cost
+ * training sees, and it is a consistent view because training is paused for
+ * it. The writer thread then swaps the buffers and formats the front one
+ * while training carries on. If a checkpoint is still waiting for the
+ * writer when the next one is submitted, the new one is skipped, so training
+ * never blocks on disk.
+ *
+ * Each file is written to "<path>.tmp", flushed to disk and renamed over the
+ * final name, so a crash leaves either the previous or the new checkpoint,
+ * never a torn one. Text checkpoints keep only the newest keep_last files
+ * written by this instance; delta checkpoints keep one chain, which
+ * DeltaCheckpointWriter compacts into a new base when it gets long.
+ */
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(const CheckpointConfig& config = CheckpointConfig());
+    ~CheckpointWriter(); // Finishes the pending checkpoint first
+
+    // Returns false if the checkpoint was skipped
+    bool submit(const QLearningAgent& agent, size_t episode);
+    void flush();
+
+    CheckpointStats getStats() const;
+    std::string pathFor(size_t episode) const;
+
+private:
+    CheckpointConfig config_;
+
+    // Double buffer: the trainer fills back_, the writer thread drains front_
+    ModelSnapshot front_;
+    ModelSnapshot back_;
+    size_t back_episode_;
+    bool pending_;
+    bool writing_;
+    bool stopping_;
+
+    std::deque<std::string> retained_;
+    std::unique_ptr<DeltaCheckpointWriter> delta_writer_;
+    CheckpointStats stats_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable work_done_;
+    std::thread thread_;
+
+    void run();
+    size_t writeFile(const ModelSnapshot& snapshot, const std::string& path);
+
+    // Copy prevention
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+};
+
+} // namespace SnakeGame::RL
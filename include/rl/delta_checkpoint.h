@@ -0,0 +1,93 @@
+#pragma once
+
+#include "binary_codec.h"
+#include "q_learning_agent.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Size and content of one file written by a DeltaCheckpointWriter
+ */
+struct DeltaCheckpointStats {
+    bool base = false;       // Full snapshot starting a new chain
+    size_t sequence = 0;     // Position in the chain (0 for the base)
+    size_t changed_rows = 0; // New rows or rows with at least one changed value
+    size_t removed_rows = 0;
+    size_t bytes = 0;
+};
+
+/**
+ * @brief Chain found on disk by DeltaCheckpointWriter::load()
+ */
+struct DeltaChainInfo {
+    size_t files = 0;                // Base plus replayed deltas
+    size_t bytes = 0;
+    double quantization_step = 0.0;
+};
+
+/**
+ * @brief Writes Q-table checkpoints as a base file plus a chain of deltas
+ *
+ * The first write stores every row in "<path>"; each later write stores only
+ * the rows whose quantized values changed since the previous write (plus the
+ * keys of rows that disappeared) in "<path>.1", "<path>.2", ... Values are
+ * quantized to a fixed step and stored as zigzag varints of the change from
+ * the previous file, and the sorted keys are varint-encoded as differences
+ * from the previous key, so a typical row costs a few bytes instead of ~100
+ * characters of text. Reconstruction is exact up to the quantization step:
+ * deltas are taken between quantized values, so errors never accumulate.
+ *
+ * Every file carries the chain id of its base and a checksum, and is written
+ * to a temporary name and renamed into place. Once the chain reaches its
+ * maximum length the next write starts a new base, which is the same as
+ * compacting the chain; compact() does this offline for an existing chain.
+ */
+class DeltaCheckpointWriter {
+public:
+    static constexpr double DEFAULT_QUANTIZATION_STEP = 1.0 / 1024.0;
+
+    explicit DeltaCheckpointWriter(const std::string& path,
+                                   double quantization_step = DEFAULT_QUANTIZATION_STEP,
+                                   size_t max_chain_length = 32);
+
+    DeltaCheckpointStats write(const ModelSnapshot& snapshot);
+    const std::string& getPath() const;
+    size_t getChainLength() const;
+
+    // Chain replay and maintenance
+    static bool isDeltaCheckpoint(const std::string& path);
+    static DeltaChainInfo load(const std::string& path, ModelSnapshot& snapshot);
+    static DeltaChainInfo compact(const std::string& path);
+    static std::string deltaPath(const std::string& path, size_t sequence);
+
+private:
+    using QuantizedRow = std::array<int32_t, QTable::NUM_ACTIONS>;
+
+    std::string path_;
+    double quantization_step_;
+    size_t max_chain_length_;
+    uint64_t chain_id_;
+    size_t sequence_;
+    bool has_base_;
+
+    // State as of the last write (sorted by key), as a reader would rebuild it
+    std::vector<StateKey> keys_;
+    std::vector<QuantizedRow> rows_;
+
+    // Scratch reused across writes
+    std::vector<StateKey> next_keys_;
+    std::vector<QuantizedRow> next_rows_;
+    std::vector<uint32_t> order_;
+    ByteWriter buffer_;
+
+    void quantize(const ModelSnapshot& snapshot);
+    size_t encodeChanges(const std::vector<StateKey>& previous_keys,
+                         const std::vector<QuantizedRow>& previous_rows, size_t& removed);
+    void removeStaleDeltas(size_t first_sequence) const;
+};
+
+} // namespace SnakeGame::RL
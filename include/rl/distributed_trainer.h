@@ -0,0 +1,76 @@
+#pragma once
+
+#include "q_table.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Learner run by every worker process
+ */
+enum class DistributedAlgorithm {
+    Q_LEARNING, // Workers send Q-table row deltas
+    DQN         // Workers send quantized network weight deltas
+};
+
+/**
+ * @brief Settings for multi-process training
+ */
+struct DistributedConfig {
+    DistributedAlgorithm algorithm = DistributedAlgorithm::Q_LEARNING;
+    size_t num_workers = 4;
+    size_t episodes_per_worker = 1000;
+    size_t sync_interval = 50;   // Episodes a worker plays between synchronizations
+    size_t max_steps = 500;      // Environment step limit per episode
+    std::string model_path;      // Merged model is saved here when non-empty
+};
+
+/**
+ * @brief Totals reported by the parameter server after training
+ */
+struct DistributedStats {
+    size_t syncs = 0;
+    size_t episodes = 0;
+    size_t bytes_received = 0;
+    size_t bytes_sent = 0;
+    double seconds = 0.0;
+};
+
+/**
+ * @brief Parameter server that trains agents in forked worker processes
+ *
+ * The calling process becomes the server. Every worker is forked with its
+ * own AF_UNIX socket pair, trains a private agent for sync_interval episodes,
+ * then sends what changed since its last synchronization and blocks until the
+ * server answers with the merged state. The server multiplexes all workers
+ * with poll(), so fast workers never wait for slow ones.
+ *
+ * Q-learning deltas are the rows whose values moved, with sorted keys
+ * delta-varint encoded; the server adds them to the global table and replies
+ * with every value other workers changed since the worker last synced. DQN
+ * deltas are weight differences quantized to zigzag varints against a per
+ * message scale; the server applies their average over the workers and
+ * replies with the full parameter vector. Only POSIX systems are supported.
+ */
+class DistributedTrainer {
+public:
+    explicit DistributedTrainer(const DistributedConfig& config = DistributedConfig());
+
+    DistributedStats run();
+    static bool isSupported();
+
+private:
+    DistributedConfig config_;
+
+    // Server state
+    QTable global_table_;
+    std::vector<float> global_parameters_;
+
+    void runServer(const std::vector<int>& sockets, DistributedStats& stats);
+    void saveModel() const;
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "rl_interface.h"
+#include "mlp.h"
+#include "replay_buffer.h"
+#include <random>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Hyperparameters for the DQN agent
+ */
+struct DQNConfig {
+    std::vector<size_t> hidden_layers = {64, 64};
+    double learning_rate = 1e-3;
+    double discount_factor = 0.95;
+    double epsilon = 1.0;
+    double epsilon_decay = 0.995;   // Applied once per finished episode
+    double min_epsilon = 0.05;
+    size_t batch_size = 64;
+    size_t replay_capacity = 100000;
+    size_t min_replay_size = 1000;  // Transitions collected before learning starts
+    size_t train_interval = 4;      // Environment steps per gradient step
+    size_t target_update_interval = 500; // Gradient steps per target network sync
+    bool prioritized_replay = false;
+    unsigned int seed = 0;
+};
+
+/**
+ * @brief Deep Q-Network agent running entirely on the CPU
+ *
+ * Approximates Q(s, .) with an in-tree MLP instead of a table, so memory does not
+ * grow with the number of visited states. Learns from replayed minibatches with a
+ * periodically synchronized target network, and can act for many environments at
+ * once through a single batched forward pass.
+ */
+class DQNAgent : public Agent {
+public:
+    DQNAgent(size_t state_size = 17, size_t action_size = 4, const DQNConfig& config = DQNConfig());
+
+    // Agent interface implementation
+    int selectAction(const std::vector<double>& state) override;
+    void selectActions(const StateBatch& states, std::vector<int>& actions) override;
+    void update(const std::vector<double>& state, int action,
+                double reward, const std::vector<double>& next_state, bool done) override;
+
+    // Training interface
+    void train(Environment& env, size_t episodes) override;
+    void evaluate(Environment& env, size_t episodes) override;
+
+    // Model management
+    void save(const std::string& filepath) override;
+    void load(const std::string& filepath) override;
+
+    // Configuration
+    void setLearningRate(double lr) override;
+    void setEpsilon(double epsilon) override;
+    void setDiscountFactor(double gamma) override;
+    void setSeed(unsigned int seed) override; // Exploration and replay sampling
+
+    // Copies both networks and the tunable hyperparameters; replay memory stays
+    // with each agent (a clone starts with an empty buffer)
+    std::unique_ptr<Agent> clone() const override;
+    void copyFrom(const Agent& other) override;
+    void copyFrom(const DQNAgent& other);
+
+    // DQN specific methods
+    void selectActions(const float* states, size_t batch_size, int* actions);
+    void trainVectorized(std::vector<Environment*>& envs, size_t episodes);
+    double trainStep();
+    void syncTargetNetwork();
+    MLP& getNetwork();
+    const MLP& getNetwork() const;
+
+private:
+    size_t state_size_;
+    size_t action_size_;
+    DQNConfig config_;
+    double epsilon_;
+
+    // Networks and experience
+    MLP online_network_;
+    MLP target_network_;
+    ReplayBuffer replay_buffer_;
+    TransitionBatch batch_;
+
+    // Scratch buffers reused across steps
+    std::vector<float> state_scratch_;
+    std::vector<float> batch_scratch_;
+    std::vector<float> next_state_scratch_;
+    std::vector<float> output_grad_;
+    std::vector<float> targets_;
+    std::vector<float> td_errors_;
+
+    // Random number generation
+    std::mt19937 gen_;
+    std::uniform_real_distribution<double> uniform_dist_;
+    std::uniform_int_distribution<int> action_dist_;
+
+    // Statistics
+    size_t env_steps_;
+    size_t gradient_steps_;
+    double last_loss_;
+
+    // Helper methods
+    int greedyAction(const float* q_values) const;
+    void decayEpsilon();
+};
+
+} // namespace SnakeGame::RL
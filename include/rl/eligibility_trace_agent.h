@@ -0,0 +1,75 @@
+#pragma once
+
+#include "q_learning_agent.h"
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Target used by the eligibility trace agent
+ */
+enum class TraceMode {
+    WATKINS_Q, // Q(lambda): bootstrap from the greedy action, cut traces after exploring
+    SARSA      // SARSA(lambda): bootstrap from the action actually taken next
+};
+
+/**
+ * @brief Tabular Q(lambda) / SARSA(lambda) agent with sparse eligibility traces
+ *
+ * Every TD error is applied to all recently visited (state, action) pairs,
+ * weighted by a trace that decays by gamma * lambda per step, so a reward
+ * reaches the whole approach path in one episode instead of moving back one
+ * state per episode. Traces live in a short flat list (replacing traces,
+ * oldest first); entries below the threshold or beyond the length limit are
+ * dropped, which bounds the per-step cost to one pass over that list.
+ *
+ * SARSA(lambda) picks the next action inside update() to form its target and
+ * hands the same action out from the following selectAction() call.
+ */
+class EligibilityTraceAgent : public QLearningAgent {
+public:
+    EligibilityTraceAgent(double learning_rate = 0.1,
+                          double discount_factor = 0.95,
+                          double epsilon = 0.1,
+                          double lambda = 0.9,
+                          TraceMode mode = TraceMode::WATKINS_Q);
+
+    // Agent interface implementation
+    int selectAction(const std::vector<double>& state) override;
+    void update(const std::vector<double>& state, int action,
+                double reward, const std::vector<double>& next_state, bool done) override;
+    std::unique_ptr<Agent> clone() const override; // Traces start empty in the copy
+    void copyFrom(const Agent& other) override;
+
+    // Trace configuration
+    void setLambda(double lambda);
+    void setTraceLimit(size_t max_traces);
+    void setTraceThreshold(double threshold);
+    size_t getActiveTraces() const;
+    TraceMode getTraceMode() const;
+
+private:
+    double lambda_;
+    TraceMode mode_;
+    size_t max_traces_;
+    double trace_threshold_;
+
+    // Active traces, oldest first (canonical keys and actions)
+    std::vector<StateKey> trace_keys_;
+    std::vector<uint8_t> trace_actions_;
+    std::vector<double> traces_;
+
+    // SARSA: next action chosen during update()
+    bool has_cached_action_;
+    StateKey cached_key_;
+    int cached_action_;
+
+    // Helper methods
+    double lookupQValue(StateKey state, int action) const;
+    bool isGreedyAction(StateKey state, int action) const;
+    void markVisited(StateKey state, int action);
+    void applyTraces(double td_error);
+    void clearTraces();
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "evaluation_engine.h"
+#include "trajectory_log.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+enum class ExportFormat {
+    GIF,            // One animated GIF per episode
+    PPM_SEQUENCE    // One binary PPM image per kept frame
+};
+
+/**
+ * @brief Settings for EpisodeExporter
+ */
+struct ExportConfig {
+    ExportFormat format = ExportFormat::GIF;
+    size_t cell_pixels = 16;           // Board cells are cell_pixels squares
+    size_t frame_skip = 1;             // Keep every Nth step; plays N times faster
+    unsigned int frame_delay_cs = 10;  // GIF delay per kept frame, in 1/100 s
+    unsigned int final_delay_cs = 100; // Extra hold on the last frame
+    std::string directory = ".";
+    std::string prefix = "episode";
+    size_t num_threads = 0;            // 0 uses every hardware thread
+};
+
+/**
+ * @brief Files written for one episode
+ */
+struct ExportResult {
+    std::string path;               // GIF file, or the first image of a sequence
+    size_t steps = 0;
+    size_t frames = 0;              // Frames kept after skipping
+    size_t bytes = 0;
+    double score = 0.0;
+};
+
+/**
+ * @brief Offline episode video export, without a display
+ *
+ * record() plays seeded episodes in parallel and keeps only their actions.
+ * exportEpisodes() replays recordings with a TrajectoryReplayer, draws
+ * every kept step with PixelRenderer and writes either an animated GIF (with
+ * the in-tree GifEncoder) or a PPM image sequence. Episodes are exported in
+ * parallel on a ThreadPool, longest first, each worker owning its renderer
+ * and encoder; files are named <prefix>_<index>.gif or
+ * <prefix>_<index>_<frame>.ppm in the configured directory.
+ */
+class EpisodeExporter {
+public:
+    explicit EpisodeExporter(const ExportConfig& config = ExportConfig());
+
+    std::vector<EpisodeRecording> record(const AgentFactory& make_agent, size_t episodes,
+                                         uint64_t seed = 1, size_t max_steps = 500);
+    std::vector<ExportResult> exportEpisodes(const std::vector<EpisodeRecording>& recordings);
+
+private:
+    ExportConfig config_;
+    ThreadPool pool_;
+
+    ExportResult exportEpisode(const EpisodeRecording& recording, size_t index) const;
+
+    // Copy prevention
+    EpisodeExporter(const EpisodeExporter&) = delete;
+    EpisodeExporter& operator=(const EpisodeExporter&) = delete;
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "rl_interface.h"
+#include "evaluation_engine.h"
+#include "mlp.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Hyperparameters for the evolution-strategies agent
+ */
+struct ESConfig {
+    std::vector<size_t> hidden_layers;  // Empty gives a linear policy
+    size_t population = 256;            // Perturbed policies per generation (pairs of +/- noise)
+    double sigma = 0.05;                // Perturbation scale
+    double learning_rate = 0.01;        // Adam step size
+    double weight_decay = 0.005;
+    size_t noise_table_size = 1 << 24;  // Shared Gaussian samples (64 MB of floats)
+    size_t max_steps = 500;
+    uint64_t seed = 1;
+    size_t num_threads = 0;             // 0 uses every hardware thread
+};
+
+/**
+ * @brief Results of one ES generation
+ */
+struct ESGenerationStats {
+    size_t generation = 0;
+    size_t episodes = 0;
+    size_t steps = 0;
+    double mean_reward = 0.0;           // Over all perturbed policies
+    double max_reward = 0.0;
+    double mean_score = 0.0;
+    double seconds = 0.0;
+    double episodes_per_second = 0.0;
+};
+
+/**
+ * @brief Block of precomputed standard normal samples shared by all workers
+ *
+ * A perturbation is just an offset into the table, so it is identified by a
+ * single integer and any thread can rebuild it without communication.
+ */
+class NoiseTable {
+public:
+    NoiseTable(size_t size, uint64_t seed);
+
+    const float* at(size_t offset) const;
+    size_t size() const;
+
+    // Offset of a dim-long slice chosen by hashing key
+    size_t sampleOffset(uint64_t key, size_t dim) const;
+
+private:
+    std::vector<float> noise_;
+};
+
+/**
+ * @brief Gradient-free agent trained with antithetic evolution strategies
+ *
+ * The policy is a linear map or small MLP from the 17 state features to
+ * action scores, acting greedily. Each generation evaluates population
+ * perturbed copies theta +/- sigma * eps in parallel on a ThreadPool. Every
+ * eps is a slice of the shared NoiseTable whose offset derives from
+ * (seed, generation, pair), so workers receive only the pair index and return
+ * only two episode returns. Both members of a pair play the same seeded game.
+ * The update uses centered ranks of the returns; the gradient is accumulated
+ * in parallel over parameter blocks and applied with Adam plus weight decay.
+ *
+ * Workers own their policy copy and environment and write results to
+ * per-pair slots, so generations scale with core count without locking and
+ * produce the same parameters for any thread count.
+ */
+class ESAgent : public Agent {
+public:
+    ESAgent(size_t state_size = 17, size_t action_size = 4, const ESConfig& config = ESConfig());
+
+    // Agent interface implementation
+    int selectAction(const std::vector<double>& state) override;
+
+    // Training interface: train() runs generations until at least episodes
+    // perturbed episodes have been played. It ignores env: every worker needs
+    // its own environment, built by the factory from setEnvironmentFactory()
+    // (default: headless SnakeEnvironment with config max_steps), so settings,
+    // recorders and live views on env do not apply to training
+    void train(Environment& env, size_t episodes) override;
+    void evaluate(Environment& env, size_t episodes) override;
+
+    // Model management
+    void save(const std::string& filepath) override;
+    void load(const std::string& filepath) override;
+
+    // Configuration
+    void setLearningRate(double lr) override;
+    void setSeed(unsigned int seed) override;
+    std::unique_ptr<Agent> clone() const override; // Shares the noise table
+    void setEnvironmentFactory(EnvironmentFactory factory);
+
+    // ES specific methods
+    ESGenerationStats runGeneration();
+    MLP& getPolicy();
+    const MLP& getPolicy() const;
+
+private:
+    size_t state_size_;
+    size_t action_size_;
+    ESConfig config_;
+
+    // Current policy and optimizer state
+    MLP policy_;
+    std::vector<float> adam_m_;
+    std::vector<float> adam_v_;
+    size_t generation_;
+
+    // Shared noise and per-worker copies
+    std::shared_ptr<const NoiseTable> noise_;
+    std::unique_ptr<ThreadPool> pool_;
+    EnvironmentFactory make_environment_;
+    std::vector<MLP> worker_policies_;
+    std::vector<std::unique_ptr<Environment>> worker_environments_;
+    std::vector<std::vector<float>> worker_states_;
+
+    // Per-pair results and the reduced gradient
+    std::vector<size_t> offsets_;
+    std::vector<double> returns_;       // 2 per pair: +eps, -eps
+    std::vector<double> scores_;
+    std::vector<size_t> steps_;
+    std::vector<float> weights_;        // Centered-rank difference per pair
+    std::vector<float> gradient_;
+
+    std::vector<float> state_scratch_;
+
+    // Clones reuse the noise table instead of generating their own
+    ESAgent(size_t state_size, size_t action_size, const ESConfig& config,
+            std::shared_ptr<const NoiseTable> noise);
+
+    // Helper methods
+    void prepareWorkers();
+    double playEpisode(MLP& policy, Environment& env, std::vector<float>& state_scratch,
+                       unsigned int seed, double& score, size_t& steps);
+    static int greedyAction(const float* scores, size_t count);
+};
+
+} // namespace SnakeGame::RL
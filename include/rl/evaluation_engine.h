@@ -0,0 +1,101 @@
+#pragma once
+
+#include "rl_interface.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Settings for a batch of evaluation episodes
+ */
+struct EvaluationConfig {
+    size_t episodes = 1000;
+    size_t max_steps = 500;   // Step limit of the default environment
+    uint64_t seed = 1;        // Base seed; episode i always gets the same derived seed
+    size_t num_threads = 0;   // 0 uses every hardware thread
+    double epsilon = 0.0;     // Exploration rate set on every agent copy
+};
+
+/**
+ * @brief Outcome of one evaluation episode
+ */
+struct EpisodeResult {
+    double score = 0.0;
+    double reward = 0.0;
+    size_t length = 0;
+};
+
+/**
+ * @brief Distribution of one per-episode metric
+ */
+struct MetricSummary {
+    double mean = 0.0;
+    double stddev = 0.0;  // Sample standard deviation
+    double min = 0.0;
+    double max = 0.0;
+    double p5 = 0.0;
+    double p25 = 0.0;
+    double median = 0.0;
+    double p75 = 0.0;
+    double p95 = 0.0;
+    double ci_low = 0.0;  // 95% confidence interval of the mean (normal approximation)
+    double ci_high = 0.0;
+};
+
+/**
+ * @brief Aggregated results of EvaluationEngine::evaluate()
+ */
+struct EvaluationReport {
+    std::string agent_name;
+    size_t episodes = 0;
+    size_t threads = 0;
+    uint64_t seed = 0;
+    double seconds = 0.0;
+    MetricSummary score;
+    MetricSummary length;
+    MetricSummary reward;
+
+    std::string toJson() const;
+    void writeJson(const std::string& filepath) const;
+};
+
+using AgentFactory = std::function<std::unique_ptr<Agent>()>;
+using EnvironmentFactory = std::function<std::unique_ptr<Environment>()>;
+
+/**
+ * @brief Runs evaluation episodes in parallel with reproducible results
+ *
+ * Every worker thread gets its own agent and environment from the factories
+ * (agents keep mutable state such as RNGs and lookup counters, so they are
+ * never shared). Before episode i the environment and the agent are seeded
+ * from a SplitMix64 hash of (seed, i), so an episode's outcome depends only
+ * on its index and never on which thread ran it or in what order. Each
+ * episode writes its result to its own slot, so no locks are needed, and the
+ * statistics are computed afterwards in episode order. The report is
+ * therefore identical for any thread count. Agents must not learn during
+ * evaluation for this to hold.
+ */
+class EvaluationEngine {
+public:
+    explicit EvaluationEngine(const EvaluationConfig& config = EvaluationConfig());
+
+    EvaluationReport evaluate(const AgentFactory& make_agent, const std::string& agent_name = "agent");
+    EvaluationReport evaluate(const AgentFactory& make_agent, const EnvironmentFactory& make_environment,
+                              const std::string& agent_name = "agent");
+
+    const std::vector<EpisodeResult>& getEpisodes() const;
+    static uint64_t episodeSeed(uint64_t seed, size_t episode);
+    static MetricSummary summarize(std::vector<double> values);
+
+private:
+    EvaluationConfig config_;
+    ThreadPool pool_;
+    std::vector<EpisodeResult> episodes_;
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Minimal animated GIF89a encoder for palette images
+ *
+ * Frames are arrays of palette indices. Each frame encodes only the bounding
+ * box of the pixels that differ from the previous frame (drawn over it), and
+ * a frame identical to the previous one just extends that frame's delay, so
+ * a mostly static board costs a few dozen bytes per frame. Pixel data is
+ * LZW-compressed with the standard variable-width codes (clear code when the
+ * 4096-entry dictionary is full); the dictionary is a dense child table, which
+ * is small because game palettes have only a handful of colors.
+ */
+class GifEncoder {
+public:
+    // palette holds RGB triples, at most 256 colors; loop repeats the animation forever
+    GifEncoder(size_t width, size_t height, const std::vector<uint8_t>& palette, bool loop = true);
+
+    void addFrame(const uint8_t* indices, unsigned int delay_cs); // Delay in hundredths of a second
+    const std::vector<uint8_t>& finish();                        // Appends the trailer
+    void save(const std::string& filepath);                      // finish() and write the file
+
+    size_t getFrameCount() const;
+    size_t size() const;
+
+private:
+    size_t width_;
+    size_t height_;
+    int min_code_size_;
+    bool finished_;
+    size_t frames_;
+    size_t last_delay_offset_;      // Position of the previous frame's delay field
+
+    std::vector<uint8_t> bytes_;
+    std::vector<uint8_t> previous_;
+
+    // LZW state
+    std::vector<uint16_t> children_; // code * alphabet + index -> code, 0 if absent
+    std::vector<uint8_t> packed_;
+    uint32_t bit_buffer_;
+    int bit_count_;
+
+    void writeShort(size_t value);
+    void encodeImage(const uint8_t* indices, size_t left, size_t top, size_t width, size_t height);
+    void writeCode(uint32_t code, int code_size);
+    void flushBits();
+};
+
+} // namespace SnakeGame::RL
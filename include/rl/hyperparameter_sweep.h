@@ -0,0 +1,111 @@
+#pragma once
+
+#include "rl_interface.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief One Q-learning configuration tried by a sweep
+ */
+struct HyperParameters {
+    double learning_rate = 0.1;
+    double discount_factor = 0.95;
+    double epsilon = 0.3;
+    double epsilon_decay = 0.995;
+};
+
+/**
+ * @brief Values to search over, one list per hyperparameter
+ *
+ * Grid search tries every combination of the listed values. Random search
+ * samples each parameter between the smallest and largest listed value:
+ * log-uniformly for the learning rate, and log-uniformly in (1 - value) for
+ * the discount factor and epsilon decay, which only matter close to 1.
+ */
+struct SweepSpace {
+    std::vector<double> learning_rates = {0.05, 0.1, 0.2};
+    std::vector<double> discount_factors = {0.9, 0.95, 0.99};
+    std::vector<double> epsilons = {0.1, 0.3};
+    std::vector<double> epsilon_decays = {0.995, 0.999};
+
+    std::vector<HyperParameters> grid() const;
+    std::vector<HyperParameters> sample(size_t count, uint64_t seed) const;
+};
+
+/**
+ * @brief Settings for SweepRunner
+ */
+struct SweepConfig {
+    size_t min_episodes = 100;    // Training episodes before the first cut
+    size_t max_episodes = 2700;   // Training episodes of the surviving configurations
+    size_t eta = 3;               // Keep the best 1/eta after each rung
+    size_t eval_episodes = 50;    // Greedy episodes scored after each rung
+    size_t max_steps = 500;
+    uint64_t seed = 1;
+    size_t num_threads = 0;       // 0 uses every hardware thread
+};
+
+/**
+ * @brief Outcome of one configuration, from the last rung it reached
+ */
+struct TrialResult {
+    size_t id = 0;
+    HyperParameters params;
+    size_t rung = 0;
+    size_t episodes = 0;          // Training episodes completed
+    double score = 0.0;           // Mean greedy evaluation score
+    double reward = 0.0;
+    double length = 0.0;
+    double train_seconds = 0.0;
+    size_t table_size = 0;
+};
+
+/**
+ * @brief Summary table of a sweep, best configuration first
+ */
+struct SweepReport {
+    std::vector<TrialResult> trials; // Sorted by rung reached, then score
+    size_t rungs = 0;
+    size_t threads = 0;
+    double seconds = 0.0;
+    double busy_seconds = 0.0;       // Sum of per-trial work across all rungs
+
+    std::string toTable(size_t max_rows = 0) const; // 0 prints every trial
+    void writeCsv(const std::string& filepath) const;
+};
+
+/**
+ * @brief Parallel successive-halving search over Q-learning hyperparameters
+ *
+ * Every configuration gets its own agent and headless environment and is
+ * trained for min_episodes, then scored by greedy evaluation on a fixed set
+ * of seeded episodes shared by all trials. The best 1/eta continue training
+ * (they are not restarted) to eta times the budget, and so on until
+ * max_episodes, so most of the compute goes to promising configurations.
+ *
+ * Within a rung, trials run concurrently on a ThreadPool. Jobs are handed out
+ * longest expected cost first (LPT scheduling): a trial's cost is its
+ * episodes for the rung times its measured seconds per episode so far, since
+ * agents that play better also play longer episodes. Trials are seeded from
+ * their index, so the results do not depend on the thread count.
+ */
+class SweepRunner {
+public:
+    explicit SweepRunner(const SweepConfig& config = SweepConfig());
+
+    SweepReport run(const std::vector<HyperParameters>& configurations);
+
+private:
+    SweepConfig config_;
+    ThreadPool pool_;
+
+    // Copy prevention
+    SweepRunner(const SweepRunner&) = delete;
+    SweepRunner& operator=(const SweepRunner&) = delete;
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "binary_codec.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Mean of the last N values in O(1) per update
+ *
+ * Keeps a ring of the values and a running sum, which is recomputed from the
+ * ring once per full turn so floating-point drift cannot build up.
+ */
+class RollingWindow {
+public:
+    explicit RollingWindow(size_t capacity = 100);
+
+    void push(double value);
+    double mean() const;
+    size_t count() const;
+    size_t capacity() const;
+    void clear();
+
+private:
+    std::vector<double> values_;
+    size_t next_;
+    size_t count_;
+    double sum_;
+};
+
+/**
+ * @brief Lets an action through at most once per interval
+ */
+class RateLimiter {
+public:
+    explicit RateLimiter(std::chrono::milliseconds interval);
+
+    bool allow();
+
+private:
+    std::chrono::steady_clock::duration interval_;
+    std::chrono::steady_clock::time_point next_;
+};
+
+/**
+ * @brief Bounded lock-free queue for one producer thread and one consumer thread
+ *
+ * Head and tail live on separate cache lines and each side only writes its
+ * own index, so push and pop are a load, a store and a release/acquire pair.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) : head_(0), tail_(0) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        buffer_.resize(rounded);
+        mask_ = rounded - 1;
+    }
+
+    bool tryPush(const T& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == buffer_.size()) {
+            return false;
+        }
+        buffer_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = buffer_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return buffer_.size(); }
+
+private:
+    std::vector<T> buffer_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> head_; // Next slot to read, written by the consumer
+    alignas(64) std::atomic<size_t> tail_; // Next slot to write, written by the producer
+};
+
+/**
+ * @brief One training episode as reported to a MetricsSink
+ */
+struct EpisodeMetrics {
+    uint64_t episode = 0;
+    double reward = 0.0;
+    uint32_t length = 0;
+    uint32_t score = 0;
+    double epsilon = 0.0;
+    uint64_t table_size = 0;
+};
+
+/**
+ * @brief Output format of a MetricsSink
+ */
+enum class MetricsFormat {
+    CSV,   // Header line plus one text line per episode
+    BINARY // Magic number plus varint/float records (see MetricsSink)
+};
+
+/**
+ * @brief Settings for a MetricsSink
+ */
+struct MetricsConfig {
+    std::string path;                        // No file is written when empty
+    MetricsFormat format = MetricsFormat::CSV;
+    size_t queue_capacity = 4096;            // Records per channel before new ones are dropped
+    size_t window = 100;                     // Episodes in the console rolling averages
+    std::chrono::milliseconds console_interval{1000}; // Zero disables console output
+};
+
+/**
+ * @brief Producer end of a MetricsSink, owned by exactly one thread
+ */
+class MetricsChannel {
+public:
+    MetricsChannel(uint32_t source, size_t capacity);
+
+    // Never blocks; returns false and counts a drop when the queue is full
+    bool record(const EpisodeMetrics& metrics);
+
+    uint32_t getSource() const;
+    size_t getAccepted() const;
+    size_t getDropped() const;
+
+private:
+    friend class MetricsSink;
+
+    uint32_t source_;
+    SpscQueue<EpisodeMetrics> queue_;
+    std::atomic<size_t> accepted_;
+    std::atomic<size_t> dropped_;
+};
+
+/**
+ * @brief Background writer for training metrics
+ *
+ * Training threads each open a channel and push one small record per episode
+ * into its lock-free queue, which costs the same few nanoseconds however
+ * long the run is. A background thread drains all channels. It appends the
+ * records to a CSV or binary file through a buffered stream, keeps O(1)
+ * rolling averages, and prints one progress line per console interval at
+ * most. When a queue is full, records are dropped and counted rather than
+ * stalling training. The stream is checked after every flush; if a write
+ * failed (disk full, I/O error), the records since the last good flush are
+ * counted as write failures and later flushes try again.
+ *
+ * Binary records are: varint source, varint episode, float reward, varint
+ * length, varint score, float epsilon, varint table size, after an 8-byte
+ * magic "SNKMET01".
+ */
+class MetricsSink {
+public:
+    explicit MetricsSink(const MetricsConfig& config = MetricsConfig());
+    ~MetricsSink(); // Drains every channel first
+
+    std::shared_ptr<MetricsChannel> openChannel();
+    void flush(); // Waits until everything recorded so far is written
+
+    size_t getWritten() const;
+    size_t getDropped() const;
+    size_t getWriteFailures() const; // Records lost to file errors
+
+private:
+    MetricsConfig config_;
+    std::ofstream file_;
+
+    mutable std::mutex channels_mutex_;
+    std::vector<std::shared_ptr<MetricsChannel>> channels_;
+
+    // Writer thread state
+    RollingWindow rewards_;
+    RollingWindow lengths_;
+    RollingWindow scores_;
+    RateLimiter console_limiter_;
+    EpisodeMetrics last_;
+    std::chrono::steady_clock::time_point start_;
+    ByteWriter buffer_; // Encoded records not yet handed to the file
+    std::atomic<size_t> written_;
+    std::atomic<size_t> flushed_;
+    std::atomic<size_t> write_failures_;
+    std::atomic<bool> stopping_;
+    std::thread thread_;
+
+    void run();
+    size_t drain(std::vector<std::shared_ptr<MetricsChannel>>& channels);
+    void write(uint32_t source, const EpisodeMetrics& metrics);
+    void flushFile();
+    void printProgress(bool final);
+    size_t acceptedTotal();
+
+    // Copy prevention
+    MetricsSink(const MetricsSink&) = delete;
+    MetricsSink& operator=(const MetricsSink&) = delete;
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Small dense multi-layer perceptron with ReLU hidden layers
+ *
+ * All parameters live in one flat float array so the network can be copied,
+ * averaged or serialized cheaply. Matrix multiplies are cache-blocked and use
+ * AVX2/FMA or NEON when the compiler targets them (e.g. -march=native), with a
+ * portable scalar fallback otherwise. Forward activations are cached so that
+ * backward() can be called on the batch most recently passed to forward().
+ */
+class MLP {
+public:
+    explicit MLP(const std::vector<size_t>& layer_sizes, unsigned int seed = 0);
+
+    // Inference and training
+    const float* forward(const float* input, size_t batch_size);
+    void backward(const float* output_grad, size_t batch_size);
+    void zeroGradients();
+    void adamStep(float learning_rate, float beta1 = 0.9f, float beta2 = 0.999f, float epsilon = 1e-8f);
+    float clipGradientNorm(float max_norm);
+
+    // Parameter access
+    void copyParametersFrom(const MLP& other);
+    std::vector<float>& getParameters();
+    const std::vector<float>& getParameters() const;
+    size_t getParameterCount() const;
+
+    // Shape information
+    size_t getInputSize() const;
+    size_t getOutputSize() const;
+    const std::vector<size_t>& getLayerSizes() const;
+
+    // Serialization (plain text, matches the agents' save format)
+    void save(std::ostream& out) const;
+    void load(std::istream& in);
+
+    // Name of the SIMD code path compiled in ("AVX2", "NEON" or "scalar")
+    static const char* simdBackend();
+
+private:
+    struct Layer {
+        size_t inputs;
+        size_t outputs;
+        size_t weight_offset; // inputs x outputs, row-major
+        size_t bias_offset;
+    };
+
+    std::vector<size_t> layer_sizes_;
+    std::vector<Layer> layers_;
+
+    // Flat parameter storage and optimizer state
+    std::vector<float> parameters_;
+    std::vector<float> gradients_;
+    std::vector<float> adam_m_;
+    std::vector<float> adam_v_;
+    size_t adam_step_;
+
+    // Per-layer activations for the last forward batch (index 0 is the input)
+    std::vector<std::vector<float>> activations_;
+    std::vector<float> delta_;
+    std::vector<float> delta_prev_;
+    size_t cached_batch_size_;
+
+    // Helper methods
+    void reserveBatch(size_t batch_size);
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "common_types.h"
+#include <cstdint>
+#include <vector>
+
+namespace SnakeGame {
+    class Game;
+    class Snake;
+    class Apple;
+}
+
+namespace SnakeGame::RL {
+
+enum class PixelFormat {
+    GRAYSCALE,  // 1 byte per pixel
+    RGB,        // 3 bytes per pixel, interleaved
+    PALETTE     // 1 byte per pixel: index into PixelRenderer::palette()
+};
+
+/**
+ * @brief Image size and format of PixelRenderer frames
+ */
+struct PixelConfig {
+    size_t width = 84;
+    size_t height = 84;
+    PixelFormat format = PixelFormat::GRAYSCALE;
+};
+
+/**
+ * @brief CPU rasterizer turning the board into a uint8 image for vision agents
+ *
+ * The image is split into GRID_SIZE_X x GRID_SIZE_Y cell rectangles (edges
+ * rounded so sizes that are not a multiple of the grid still cover every
+ * pixel) and each cell is filled with its entity's color, row 0 at the top.
+ * Cells are filled a row at a time from a precomputed row of the target
+ * color, with 16-byte SIMD stores (8-byte moves for narrow cells).
+ *
+ * The renderer owns the current frame and remembers what each cell holds, so
+ * render() only repaints cells whose contents changed since the previous call
+ * (usually the old head, the new head and the old tail). A fresh renderer or
+ * invalidate() repaints everything.
+ */
+class PixelRenderer {
+public:
+    explicit PixelRenderer(const PixelConfig& config = PixelConfig());
+
+    // Updates and returns the frame (frameSize() bytes, valid until the next call)
+    const uint8_t* render(const Snake& snake, const Apple& apple);
+    const uint8_t* render(const Game& game);
+    void invalidate();
+
+    const uint8_t* frame() const;
+    size_t width() const;
+    size_t height() const;
+    size_t channels() const;
+    size_t frameSize() const;
+    size_t getCellsPainted() const; // Total over all render() calls
+
+    // RGB triples of the PALETTE indices: empty, body, head, apple
+    static std::vector<uint8_t> palette();
+
+private:
+    PixelConfig config_;
+    size_t channels_;
+    std::vector<uint8_t> frame_;
+
+    // Pixel edges of the cell rectangles (GRID_SIZE + 1 entries each)
+    std::vector<size_t> column_edges_;
+    std::vector<size_t> row_edges_;
+
+    // Contents of every cell in the current frame and the one being built
+    std::vector<uint8_t> cells_;
+    std::vector<uint8_t> next_cells_;
+    bool valid_;
+    size_t cells_painted_;
+
+    // One cell row of pixels per entity color, for row copies
+    std::vector<std::vector<uint8_t>> color_rows_;
+
+    void paintCell(size_t column, size_t row, uint8_t contents);
+};
+
+/**
+ * @brief Ring buffer of the last depth frames, readable without copying
+ *
+ * Every frame is stored twice, depth slots apart, in a buffer of 2 * depth
+ * slots. The depth most recent frames then always occupy consecutive slots,
+ * so observation() returns a pointer to them, oldest first, and a push costs
+ * two frame copies however deep the stack is.
+ */
+class FrameStack {
+public:
+    FrameStack(size_t frame_size, size_t depth);
+
+    void reset(const uint8_t* frame); // Episode start: every slot holds frame
+    void push(const uint8_t* frame);  // Drops the oldest frame
+    const uint8_t* observation() const;
+
+    size_t depth() const;
+    size_t frameSize() const;
+    size_t observationSize() const;
+
+private:
+    size_t frame_size_;
+    size_t depth_;
+    size_t oldest_;                 // Slot of the oldest frame, in [0, depth)
+    std::vector<uint8_t> buffer_;
+};
+
+} // namespace SnakeGame::RL
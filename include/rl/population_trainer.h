@@ -0,0 +1,102 @@
+#pragma once
+
+#include "hyperparameter_sweep.h"
+#include "rl_interface.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Settings for PopulationTrainer
+ */
+struct PopulationConfig {
+    size_t ready_episodes = 100;   // Training episodes per member between exploit/explore steps
+    size_t max_episodes = 5000;    // Training episodes per member at most
+    size_t fitness_window = 50;    // Recent training episodes whose mean score is the fitness
+    double truncation = 0.25;      // Bottom fraction replaced by copies of the top fraction
+    double perturb_factor = 1.2;   // Explore multiplies or divides each hyperparameter by this
+    double target_score = 0.0;     // Stop once the best fitness reaches this (0 never stops early)
+    bool exploit = true;           // false trains independent runs, for comparison
+    double min_epsilon = 0.01;
+    size_t max_steps = 500;
+    uint64_t seed = 1;
+    size_t num_threads = 0;        // 0 uses every hardware thread
+};
+
+/**
+ * @brief Population state after one round of training
+ */
+struct PopulationRound {
+    size_t episodes = 0;           // Training episodes per member so far
+    double seconds = 0.0;          // Wall-clock time since the start
+    double best_fitness = 0.0;
+    double mean_fitness = 0.0;
+    size_t exploits = 0;           // Members replaced at the end of this round
+};
+
+/**
+ * @brief Final state of one population member
+ */
+struct MemberResult {
+    size_t id = 0;
+    HyperParameters params;        // Current values, after any perturbations
+    double fitness = 0.0;
+    size_t exploits = 0;           // Times this member was overwritten by a better one
+    size_t parent = 0;             // Member last copied from (itself if never)
+};
+
+/**
+ * @brief Outcome of PopulationTrainer::run()
+ */
+struct PopulationReport {
+    std::vector<PopulationRound> rounds;
+    std::vector<MemberResult> members; // Best fitness first
+    size_t threads = 0;
+    double seconds = 0.0;
+    double busy_seconds = 0.0;         // Sum of per-member training time
+    double target_seconds = -1.0;      // Wall-clock time to the target score, -1 if never reached
+    size_t target_episodes = 0;        // Training episodes per member at that point
+    size_t exploits = 0;
+    double clone_seconds = 0.0;        // Time spent copying agents in exploit steps
+};
+
+// Builds a member's agent; the trainer applies epsilon and later perturbations itself
+using PopulationAgentFactory = std::function<std::unique_ptr<Agent>(const HyperParameters& params, unsigned int seed)>;
+
+/**
+ * @brief Population-based training (exploit/explore) for any agent supporting copyFrom()
+ *
+ * Every member owns an agent and a headless environment. Members train
+ * concurrently on a ThreadPool in rounds of ready_episodes, handed out
+ * longest-running first so that all workers stay busy until the round's sync
+ * point. At each sync point the bottom truncation fraction of the population
+ * (by mean score of the last fitness_window episodes) is overwritten in place
+ * with a copy of a random member of the top fraction. This copies the Q-table
+ * or the network weights and the hyperparameters into the existing agent. Each copied hyperparameter is
+ * then multiplied or divided by perturb_factor, with the discount factor and
+ * decay perturbed in (1 - value). Epsilon decays per episode as in train().
+ *
+ * With exploit disabled the same members simply train side by side, which
+ * gives the independent-runs baseline for time-to-target comparisons. Members
+ * and exploit choices are seeded, so a run does not depend on thread count.
+ */
+class PopulationTrainer {
+public:
+    explicit PopulationTrainer(const PopulationConfig& config = PopulationConfig());
+
+    PopulationReport run(const PopulationAgentFactory& make_agent, const std::vector<HyperParameters>& initial);
+
+private:
+    PopulationConfig config_;
+    ThreadPool pool_;
+
+    // Copy prevention
+    PopulationTrainer(const PopulationTrainer&) = delete;
+    PopulationTrainer& operator=(const PopulationTrainer&) = delete;
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "q_learning_agent.h"
+#include <chrono>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Dyna-Q agent that plans with prioritized sweeping over a learned model
+ *
+ * Each real transition updates the Q-table as in Q-learning and is recorded in
+ * a model table holding the last observed reward and successor of every
+ * (state, action) pair. Once a state's value changes, the pairs leading into it
+ * are queued with the magnitude of their TD error as priority. After every real
+ * step up to K queued pairs are replayed from the model, largest error first,
+ * and each replay queues the predecessors of its own state in turn. Planning stops
+ * early when the queue is empty or the per-step time budget is used up.
+ *
+ * The model is stored structure-of-arrays by pair id (state index * 4 + action).
+ * States are found through an open-addressed index of state ids, and
+ * predecessors form intrusive doubly-linked lists through the pairs, so the
+ * model makes no per-state allocations (its arrays grow by doubling) and
+ * relinks a changed successor in O(1).
+ * Values live in the inherited table, private or shared.
+ */
+class PrioritizedSweepingAgent : public QLearningAgent {
+public:
+    PrioritizedSweepingAgent(double learning_rate = 0.1,
+                             double discount_factor = 0.95,
+                             double epsilon = 0.1,
+                             size_t planning_steps = 10);
+
+    // Agent interface implementation
+    void update(const std::vector<double>& state, int action,
+                double reward, const std::vector<double>& next_state, bool done) override;
+    std::unique_ptr<Agent> clone() const override; // Copies the model and its queue as well
+    void copyFrom(const Agent& other) override;
+
+    // Planning configuration
+    void setPlanningSteps(size_t steps);
+    void setPlanningBudget(std::chrono::microseconds budget); // Zero disables the limit
+    void setPriorityThreshold(double threshold);
+    void setPredecessorLimit(size_t limit);
+
+    // Planning statistics
+    size_t getModelSize() const;
+    size_t getModelBytes() const;
+    size_t getQueueSize() const;
+    size_t getPlanningUpdates() const;
+    double getPlanningSeconds() const;
+    double getPlanningUpdatesPerSecond() const;
+
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu; // Missing state or pair index
+
+    struct QueueItem {
+        float priority;
+        uint32_t pair;
+
+        bool operator<(const QueueItem& other) const { return priority < other.priority; }
+    };
+
+    // Planning settings
+    size_t planning_steps_;
+    std::chrono::microseconds planning_budget_;
+    double priority_threshold_;
+    size_t max_predecessors_;
+
+    // Model, per state
+    std::vector<uint32_t> state_slots_;   // Linear-probing index into state_keys_, NONE when empty
+    unsigned int slot_shift_;
+    std::vector<StateKey> state_keys_;
+    std::vector<uint32_t> first_predecessor_;
+
+    // Model, per pair (unseen and terminal pairs have no successor)
+    std::vector<uint32_t> successor_;
+    std::vector<float> reward_;
+    std::vector<uint32_t> next_predecessor_;
+    std::vector<uint32_t> prev_predecessor_;
+
+    // Priority queue with lazy deletion: an item is live only while its
+    // priority still equals the pair's queued priority
+    std::vector<QueueItem> queue_;
+    std::vector<float> queued_priority_;
+    size_t live_items_;
+
+    // Statistics
+    size_t planning_updates_;
+    double planning_seconds_;
+
+    // Helper methods
+    size_t homeSlot(StateKey key) const;
+    uint32_t findOrAddState(StateKey key);
+    void rehashStates(size_t slots);
+    void recordTransition(uint32_t pair, double reward, uint32_t next_state, bool done);
+    void linkPredecessor(uint32_t pair, uint32_t state);
+    void unlinkPredecessor(uint32_t pair);
+    double tdError(uint32_t pair) const;
+    void backup(uint32_t pair);
+    void queuePair(uint32_t pair, double priority);
+    void queuePredecessors(uint32_t state);
+    bool popPair(uint32_t& pair);
+    void compactQueue();
+    void plan();
+};
+
+} // namespace SnakeGame::RL
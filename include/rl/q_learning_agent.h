@@ -1,11 +1,40 @@
 #pragma once
 
 #include "rl_interface.h"
-#include <map>
+#include "q_table.h"
+#include "state_symmetry.h"
+#include "shared_q_table.h"
+#include <memory>
+#include <ostream>
 #include <random>
 
 namespace SnakeGame::RL {
 
+class CheckpointWriter;
+class DeltaCheckpointWriter;
+class MetricsSink;
+class MetricsChannel;
+
+/**
+ * @brief Self-contained copy of a Q-learning model (hyperparameters and table)
+ *
+ * Snapshots reuse their buffers, so refilling one costs a linear copy of the
+ * table and no allocations once it has grown to size.
+ */
+struct ModelSnapshot {
+    double learning_rate = 0.0;
+    double discount_factor = 0.0;
+    double epsilon = 0.0;
+    double epsilon_decay = 0.0;
+    double min_epsilon = 0.0;
+    bool symmetric = false;
+    std::vector<StateKey> keys;
+    std::vector<QTable::Row> rows;
+    
+    // Writes the snapshot in the text format read by QLearningAgent::load()
+    void write(std::ostream& out) const;
+};
+
 /**
  * @brief Q-Learning agent implementation
  * 
@@ -20,6 +49,7 @@ public:
     
     // Agent interface implementation
     int selectAction(const std::vector<double>& state) override;
+    void selectActions(const StateBatch& states, std::vector<int>& actions) override;
     void update(const std::vector<double>& state, int action, 
                 double reward, const std::vector<double>& next_state, bool done) override;
     
@@ -27,30 +57,71 @@ public:
     void train(Environment& env, size_t episodes) override;
     void evaluate(Environment& env, size_t episodes) override;
     
-    // Model management
+    // Model management (paths ending in .qck use incremental binary checkpoints:
+    // repeated saves to one path append only the rows changed since the last)
     void save(const std::string& filepath) override;
     void load(const std::string& filepath) override;
+    void takeSnapshot(ModelSnapshot& snapshot) const;
+    void restoreSnapshot(const ModelSnapshot& snapshot);
+    
+    // Hand a snapshot to a background writer every interval episodes of train()
+    void setCheckpointWriter(std::shared_ptr<CheckpointWriter> writer, size_t interval_episodes);
+    
+    // Report every train() episode to a background metrics sink instead of the console
+    void setMetricsSink(std::shared_ptr<MetricsSink> sink);
     
     // Configuration
     void setLearningRate(double lr) override;
     void setEpsilon(double epsilon) override;
+    void setSeed(unsigned int seed) override;
+    void setDiscountFactor(double gamma) override;
+    
+    // Copies table and hyperparameters; checkpoint writers and metrics sinks stay behind.
+    // copyFrom() reuses this agent's table storage, so repeated copies do not allocate.
+    std::unique_ptr<Agent> clone() const override;
+    void copyFrom(const Agent& other) override;
+    void copyFrom(const QLearningAgent& other);
     
     // Q-Learning specific methods
-    void setDiscountFactor(double gamma);
     void setEpsilonDecay(double decay);
     double getQValue(const std::string& state, int action) const;
+    double getQValue(StateKey state, int action) const;
+    void setQValues(StateKey state, const double q_values[QTable::NUM_ACTIONS]);
     void printQTable() const;
+    QTable& getQTable();
+    const QTable& getQTable() const;
+    
+    // Q-table memory management
+    void setMemoryBudget(size_t max_bytes, EvictionPolicy policy = EvictionPolicy::VISIT_COUNT);
+    QTableStats getTableStats() const;
+    
+    // Store one entry per symmetry class of states (rotations/reflections)
+    void setSymmetryCanonicalization(bool enabled);
+    bool isSymmetryCanonicalizationEnabled() const;
+    
+    // Read and update a table in shared memory instead of the private one
+    void useSharedTable(std::shared_ptr<SharedQTable> table);
+    std::shared_ptr<SharedQTable> getSharedTable() const;
     
-private:
+protected:
     // Hyperparameters
     double learning_rate_;
     double discount_factor_;
     double epsilon_;
     double epsilon_decay_;
     double min_epsilon_;
+    bool use_symmetry_;
     
-    // Q-table (state -> action -> value)
-    std::map<std::string, std::map<int, double>> q_table_;
+    // Q-table (state key -> row of action values)
+    QTable q_table_;
+    std::shared_ptr<SharedQTable> shared_table_;
+    std::shared_ptr<CheckpointWriter> checkpoint_writer_;
+    size_t checkpoint_interval_;
+    std::shared_ptr<DeltaCheckpointWriter> delta_writer_;
+    std::shared_ptr<MetricsSink> metrics_sink_;
+    std::shared_ptr<MetricsChannel> metrics_channel_;
+    std::vector<StateKey> key_scratch_;
+    std::vector<uint8_t> transform_scratch_;
     
     // Random number generation
     mutable std::random_device rd_;
@@ -58,11 +129,14 @@ private:
     mutable std::uniform_real_distribution<double> uniform_dist_;
     
     // Helper methods
-    std::string stateToString(const std::vector<double>& state) const;
-    int selectGreedyAction(const std::string& state_str) const;
+    CanonicalState encodeState(const std::vector<double>& state) const;
+    CanonicalState canonicalize(StateKey key) const;
+    int selectGreedyAction(StateKey state) const;
     int selectRandomAction() const;
-    double getMaxQValue(const std::string& state_str) const;
-    void initializeQValue(const std::string& state_str, int action);
+    double getMaxQValue(StateKey state) const;
+    const QTable::Row* findRow(StateKey state, QTable::Row& scratch) const;
+    void prefetchRow(StateKey state) const;
+    void addToQValue(StateKey state, int action, double delta);
     
     // Statistics
     mutable size_t total_steps_;
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "state_encoder.h"
+#include <cstddef>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Replacement policy used when a memory-bounded QTable is full
+ */
+enum class EvictionPolicy {
+    CLOCK,       // Second chance: evict the first entry not touched since the last sweep
+    VISIT_COUNT  // Evict the least-visited entry, with counts halved on every sweep
+};
+
+/**
+ * @brief Live statistics of a QTable
+ */
+struct QTableStats {
+    size_t size = 0;
+    size_t capacity = 0;
+    size_t bytes_used = 0;
+    size_t lookups = 0;
+    size_t hits = 0;
+    size_t evictions = 0;
+    
+    double hitRate() const { return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups; }
+};
+
+/**
+ * @brief Open-addressing hash table from state keys to rows of action values
+ *
+ * Keys and rows are kept in two parallel arrays (linear probing, power-of-two
+ * capacity), so a lookup touches one key cache line and one 32-byte row.
+ * Missing actions read as 0.0, matching the lazy initialization of the
+ * original map-of-maps table.
+ *
+ * An optional memory budget caps the capacity; once the table is full, each
+ * insertion first evicts one entry chosen by a CLOCK hand that inspects a
+ * bounded number of slots, so eviction is O(1) and can run inline.
+ */
+class QTable {
+public:
+    static constexpr int NUM_ACTIONS = 4;
+
+    struct alignas(32) Row {
+        double q[NUM_ACTIONS];
+    };
+
+    explicit QTable(size_t initial_capacity = 1024);
+
+    // Lookup
+    const Row* find(StateKey key) const;
+    Row& findOrInsert(StateKey key);
+    void prefetch(StateKey key) const;
+
+    // Table information
+    size_t size() const;
+    size_t capacity() const;
+    size_t bytesUsed() const;
+    void clear();
+    
+    // Memory bounding (a budget of 0 means unbounded)
+    void setMemoryBudget(size_t max_bytes, EvictionPolicy policy = EvictionPolicy::VISIT_COUNT);
+    size_t getMemoryBudget() const;
+    static size_t bytesPerSlot();
+    
+    // Statistics
+    QTableStats getStats() const;
+    void resetStats();
+
+    // Visits every stored (key, row) pair in slot order
+    template <typename Func>
+    void forEach(Func&& func) const {
+        for (size_t slot = 0; slot < keys_.size(); ++slot) {
+            if (keys_[slot] != EMPTY_KEY) {
+                func(keys_[slot], rows_[slot]);
+            }
+        }
+    }
+
+    // Index of the largest value in a row (lowest index on ties)
+    static int argmax(const Row& row);
+    static double max(const Row& row);
+
+private:
+    static constexpr StateKey EMPTY_KEY = ~StateKey(0);
+    static constexpr double MAX_LOAD_FACTOR = 0.7;
+    static constexpr size_t MIN_CAPACITY = 16;
+    static constexpr size_t MAX_EVICTION_SCAN = 32;
+
+    std::vector<StateKey> keys_;
+    std::vector<Row> rows_;
+    mutable std::vector<uint8_t> visits_; // Reference bit (CLOCK) or saturating visit count
+    size_t size_;
+    size_t mask_;
+    int shift_;
+
+    // Memory budget and eviction state
+    size_t memory_budget_;
+    size_t max_capacity_;
+    EvictionPolicy policy_;
+    size_t clock_hand_;
+
+    // Statistics
+    mutable size_t lookups_;
+    mutable size_t hits_;
+    size_t evictions_;
+
+    // Helper methods
+    size_t homeSlot(StateKey key) const;
+    void touch(size_t slot) const;
+    size_t maxEntries(size_t capacity) const;
+    void rehash(size_t new_capacity);
+    void evictOne();
+    void eraseSlot(size_t slot);
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Binary sum-tree over a fixed number of non-negative priorities
+ *
+ * Leaves hold the priorities and every internal node holds the sum of its
+ * children, so both point updates and prefix-sum lookups are O(log n).
+ * The tree is stored implicitly in a single array (root at index 1).
+ */
+class SumTree {
+public:
+    explicit SumTree(size_t capacity);
+
+    // Priority management
+    void update(size_t index, double priority);
+    double get(size_t index) const;
+    double total() const;
+
+    // Returns the leaf whose cumulative range contains the given prefix sum
+    size_t find(double prefix_sum) const;
+
+    size_t capacity() const;
+    size_t bytesUsed() const;
+    void clear();
+
+private:
+    size_t capacity_;
+    size_t leaf_count_; // Rounded up to a power of two
+    std::vector<double> nodes_;
+};
+
+/**
+ * @brief Sampling strategy used by the replay buffer
+ */
+enum class SamplingMode {
+    UNIFORM,
+    PRIORITIZED  // Proportional prioritization, P(i) = p_i^alpha / sum_k p_k^alpha
+};
+
+/**
+ * @brief Minibatch of transitions in structure-of-arrays layout
+ *
+ * Owned by the caller and reused between calls to ReplayBuffer::sample,
+ * so sampling does not allocate once the batch has been sized.
+ */
+struct TransitionBatch {
+    std::vector<float> states;       // batch_size x state_size, row-major
+    std::vector<float> next_states;  // batch_size x state_size, row-major
+    std::vector<int> actions;
+    std::vector<float> rewards;
+    std::vector<uint8_t> dones;
+    std::vector<size_t> indices;     // Buffer slots, for priority updates
+    std::vector<float> weights;      // Importance-sampling weights (1 for uniform)
+
+    void resize(size_t batch_size, size_t state_size);
+    size_t size() const { return actions.size(); }
+};
+
+/**
+ * @brief Fixed-capacity experience replay buffer
+ *
+ * All storage is preallocated at construction in a structure-of-arrays layout
+ * (one contiguous array per field), and the oldest transitions are overwritten
+ * once the buffer is full. Supports uniform sampling and proportional
+ * prioritized sampling backed by a SumTree.
+ */
+class ReplayBuffer {
+public:
+    ReplayBuffer(size_t capacity,
+                 size_t state_size,
+                 SamplingMode mode = SamplingMode::UNIFORM,
+                 double alpha = 0.6);
+
+    // Insertion
+    void add(const std::vector<double>& state, int action,
+             double reward, const std::vector<double>& next_state, bool done);
+    void add(const float* state, int action,
+             float reward, const float* next_state, bool done);
+
+    // Batched sampling and priority updates
+    void sample(size_t batch_size, TransitionBatch& batch, double beta = 0.4);
+    void updatePriorities(const size_t* indices, const float* td_errors, size_t count);
+    void updatePriorities(const TransitionBatch& batch, const float* td_errors);
+
+    // Buffer information
+    size_t size() const;
+    size_t capacity() const;
+    size_t getStateSize() const;
+    size_t bytesUsed() const;
+    SamplingMode getSamplingMode() const;
+    bool isFull() const;
+
+    // Configuration
+    void setSeed(unsigned int seed);
+    void setPriorityEpsilon(double epsilon);
+    void clear();
+
+private:
+    size_t capacity_;
+    size_t state_size_;
+    size_t size_;
+    size_t next_index_;
+    SamplingMode mode_;
+    double alpha_;
+    double priority_epsilon_;
+    double max_priority_;
+
+    // Structure-of-arrays storage
+    std::vector<float> states_;
+    std::vector<float> next_states_;
+    std::vector<int> actions_;
+    std::vector<float> rewards_;
+    std::vector<uint8_t> dones_;
+
+    // Priorities (only allocated in prioritized mode)
+    SumTree priorities_;
+
+    // Random number generation
+    std::mt19937_64 gen_;
+    std::uniform_real_distribution<double> uniform_dist_;
+
+    // Helper methods
+    void copyTransition(size_t slot, size_t row, TransitionBatch& batch) const;
+    double toPriority(double td_error) const;
+};
+
+} // namespace SnakeGame::RL
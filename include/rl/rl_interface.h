@@ -1,16 +1,30 @@
 #pragma once
 
 #include "../common_types.h"
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <random>
 
 namespace SnakeGame {
     class Game; // Forward declaration
+    class Graphics;
 }
 
 namespace SnakeGame::RL {
 
+/**
+ * @brief SplitMix64 finalizer over a base seed and an index
+ *
+ * Derives well-separated per-episode or per-worker seeds from one base seed.
+ */
+inline uint64_t mixSeed(uint64_t seed, uint64_t index) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL * (index + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
 /**
  * @brief Abstract base class for RL environments
  * 
@@ -37,6 +51,18 @@ public:
     virtual std::vector<double> getInfo() const { return {}; }
 };
 
+/**
+ * @brief Receives every episode an environment plays, for logging or replay
+ */
+class EpisodeRecorder {
+public:
+    virtual ~EpisodeRecorder() = default;
+    
+    virtual void beginEpisode(unsigned int seed, size_t max_steps, const std::vector<double>& initial_state) = 0;
+    virtual void recordStep(int action, double reward) = 0;
+    virtual void endEpisode(double score) = 0; // Also called for episodes cut short by reset()
+};
+
 /**
  * @brief Snake Game environment for RL training
  * 
@@ -61,19 +87,33 @@ public:
     std::vector<int> getActionSpace() const override;
     
     // Snake-specific methods
-    void setSeed(unsigned int seed) override;
+    void setSeed(unsigned int seed) override; // Episodes then start from mixSeed(seed, episode)
+    unsigned int getEpisodeSeed() const;      // Game seed of the current episode, if it was reseeded
     std::vector<double> getInfo() const override;
+    const SnakeGame::Game& getGame() const; // For observers such as PixelRenderer
     
     // Configuration
     void setRewardStructure(double apple_reward, double collision_penalty, double time_penalty);
     void setMaxSteps(size_t max_steps);
+    void setLiveView(std::unique_ptr<SnakeGame::Graphics> graphics); // Rendered after every reset and step
+    
+    // The recorder gets each episode's game seed, so each episode replays on
+    // its own from that seed and its actions. Without setSeed(), a recorder
+    // makes every reset() draw a fresh seed.
+    void setRecorder(std::shared_ptr<EpisodeRecorder> recorder);
     
 private:
     std::unique_ptr<SnakeGame::Game> game_;
     bool headless_mode_;
+    bool live_view_;
+    std::shared_ptr<EpisodeRecorder> recorder_;
+    bool recording_;
+    bool seeded_;
+    uint64_t episode_index_;
     size_t step_count_;
     size_t max_steps_;
     unsigned int seed_;
+    unsigned int episode_seed_;
     
     // Reward configuration
     double apple_reward_;
@@ -89,6 +129,26 @@ private:
     SnakeEnvironment& operator=(const SnakeEnvironment&) = delete;
 };
 
+/**
+ * @brief Contiguous batch of states, one state per row
+ *
+ * Used by vectorized environments so that agents can process many
+ * observations in a single call instead of one virtual call per game.
+ */
+struct StateBatch {
+    std::vector<double> data;
+    size_t state_size = 0;
+    
+    StateBatch() = default;
+    StateBatch(size_t batch_size, size_t state_size);
+    
+    void resize(size_t batch_size, size_t state_size);
+    void setRow(size_t index, const std::vector<double>& state);
+    size_t size() const { return state_size == 0 ? 0 : data.size() / state_size; }
+    const double* row(size_t index) const { return data.data() + index * state_size; }
+    double* row(size_t index) { return data.data() + index * state_size; }
+};
+
 /**
  * @brief Abstract base class for RL agents
  * 
@@ -101,6 +161,7 @@ public:
     
     // Core agent interface
     virtual int selectAction(const std::vector<double>& state) = 0;
+    virtual void selectActions(const StateBatch& states, std::vector<int>& actions);
     virtual void update(const std::vector<double>& state, int action, 
                        double reward, const std::vector<double>& next_state, bool done) {}
     
@@ -115,6 +176,13 @@ public:
     // Configuration
     virtual void setLearningRate(double lr) {}
     virtual void setEpsilon(double epsilon) {}
+    virtual void setDiscountFactor(double /*gamma*/) {}
+    virtual void setSeed(unsigned int /*seed*/) {}
+    
+    // Independent copy of the learned model and hyperparameters (throws if unsupported)
+    virtual std::unique_ptr<Agent> clone() const;
+    // The same copy into this agent, reusing its storage; other must be of the same type
+    virtual void copyFrom(const Agent& other);
 };
 
 /**
@@ -130,6 +198,9 @@ public:
     ~RandomAgent() override = default;
     
     int selectAction(const std::vector<double>& state) override;
+    void selectActions(const StateBatch& states, std::vector<int>& actions) override;
+    void setSeed(unsigned int seed) override;
+    std::unique_ptr<Agent> clone() const override;
     
 private:
     std::random_device rd_;
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "q_table.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Q-table stored in a named POSIX shared-memory segment
+ *
+ * Several processes can attach to the same segment and train one table
+ * concurrently; evaluators can attach read-only and look rows up in place
+ * without copying. The layout is a fixed-capacity open-addressing table of
+ * 40-byte slots (key + 4 values), all accessed through lock-free 64-bit
+ * atomics: a slot is claimed by a compare-and-swap on its key and each value
+ * is updated with a compare-and-swap loop, so a process dying mid-update can
+ * only lose that one update. Stored keys are bit-inverted so the zero-filled
+ * pages of a new segment read as empty.
+ *
+ * The header carries a magic number, a format version and a checksum of the
+ * layout fields, and is only published (ready flag, release store) once fully
+ * written. Attaching validates all of them and refuses a segment whose creator
+ * died during initialization. The table never grows or evicts; inserting into
+ * a full table throws.
+ */
+class SharedQTable {
+public:
+    // Creates the segment, or attaches to it if it already exists (its
+    // capacity then wins over the requested one)
+    SharedQTable(const std::string& name, size_t capacity, bool read_only = false);
+    ~SharedQTable();
+
+    static bool remove(const std::string& name);
+    static bool isSupported();
+
+    // Lookup and update
+    bool find(StateKey key, QTable::Row& row) const;
+    void store(StateKey key, const QTable::Row& row);
+    void update(StateKey key, int action, double target, double learning_rate);
+    void add(StateKey key, int action, double delta);
+    void prefetch(StateKey key) const;
+
+    // Table information
+    size_t size() const;
+    size_t capacity() const;
+    size_t bytesUsed() const;
+    bool isReadOnly() const;
+    bool createdSegment() const;
+    const std::string& getName() const;
+    
+    // Lookup counters of this process (not shared)
+    size_t getLookups() const;
+    size_t getHits() const;
+
+    // Visits every stored (key, row) pair in slot order
+    template <typename Func>
+    void forEach(Func&& func) const {
+        QTable::Row row;
+        for (size_t slot = 0; slot < capacity_; ++slot) {
+            uint64_t stored = slots_[slot].key.load(std::memory_order_acquire);
+            if (stored != EMPTY_SLOT) {
+                loadRow(slot, row);
+                func(~stored, row);
+            }
+        }
+    }
+
+private:
+    static constexpr uint64_t EMPTY_SLOT = 0;
+
+    struct Slot {
+        std::atomic<uint64_t> key;
+        std::atomic<uint64_t> q[QTable::NUM_ACTIONS]; // Bit patterns of doubles
+    };
+    struct Header;
+
+    std::string name_;
+    bool read_only_;
+    bool created_;
+    int fd_;
+    void* mapping_;
+    size_t mapping_size_;
+    Header* header_;
+    Slot* slots_;
+    size_t capacity_;
+    size_t mask_;
+    int shift_;
+    mutable size_t lookups_;
+    mutable size_t hits_;
+
+    // Helper methods
+    void create(size_t capacity);
+    void attach();
+    void map(size_t bytes);
+    void setCapacity(size_t capacity);
+    size_t homeSlot(StateKey key) const;
+    size_t findSlot(StateKey key) const;
+    size_t claimSlot(StateKey key);
+    void loadRow(size_t slot, QTable::Row& row) const;
+
+    static uint64_t toBits(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static double fromBits(uint64_t bits) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Copy prevention
+    SharedQTable(const SharedQTable&) = delete;
+    SharedQTable& operator=(const SharedQTable&) = delete;
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "rl_interface.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+// Compact integer key identifying a tabular state
+using StateKey = uint64_t;
+
+// Number of bits needed to store values in [0, count)
+constexpr int bitWidth(int count) {
+    return count <= 1 ? 0 : 1 + bitWidth((count + 1) / 2);
+}
+
+/**
+ * @brief Encodes state vectors into compact integer keys for tabular agents
+ *
+ * The 17-feature vector produced by Game::getStateVector is packed exactly into
+ * a few bits per field (head, apple, direction, obstacles, length); the wall
+ * distances are derived from the head and therefore not stored. Vectors of any
+ * other shape fall back to a 63-bit hash of the values rounded to two decimals,
+ * the same precision the original string keys used, with the top bit set so
+ * the two key spaces never overlap.
+ */
+class StateEncoder {
+public:
+    // Field widths of the packed layout, derived from the grid configuration
+    static constexpr int COORD_BITS_X = bitWidth(GameConfig::GRID_SIZE_X);
+    static constexpr int COORD_BITS_Y = bitWidth(GameConfig::GRID_SIZE_Y);
+    static constexpr int DIRECTION_BITS = 2;
+    static constexpr int OBSTACLE_BITS = 4;
+    static constexpr int LENGTH_BITS = bitWidth(GameConfig::GRID_SIZE_X * GameConfig::GRID_SIZE_Y + 1);
+    static constexpr size_t FEATURE_COUNT = 17;
+    static constexpr StateKey HASHED_KEY_FLAG = StateKey(1) << 63;
+
+    // Grid fields stored in a packed key (coordinates are offset to start at 0)
+    struct PackedFields {
+        int head_x;
+        int head_y;
+        int apple_x;
+        int apple_y;
+        int direction;
+        int obstacles; // Bit i set when Direction(i) is blocked by the body
+        int length;
+    };
+
+    // Encoding
+    static StateKey encode(const double* state, size_t size);
+    static StateKey encode(const std::vector<double>& state);
+    static void encodeBatch(const StateBatch& states, StateKey* keys);
+
+    // Legacy "0.10,-0.20,..." string keys from older model files
+    static std::vector<double> parseStateString(const std::string& state_str);
+
+    static bool isPacked(StateKey key);
+    static StateKey pack(const PackedFields& fields);
+    static PackedFields unpack(StateKey key);
+
+private:
+    static StateKey hashState(const double* state, size_t size);
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "state_encoder.h"
+#include <cstdint>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Canonical representative of a state under the board's symmetries
+ */
+struct CanonicalState {
+    StateKey key;
+    uint8_t transform; // Maps the original state onto the canonical one
+};
+
+/**
+ * @brief Dihedral (D4) symmetry group of the wrapping Snake board
+ *
+ * The toroidal board looks the same after any rotation or reflection, so the
+ * 8 transformed copies of a state share one optimal policy up to relabelling
+ * the actions. canonicalize() picks the smallest transformed key and reports
+ * which transform produced it; actions are mapped into and out of that frame
+ * with the permutation tables. All transforms are precomputed lookup tables
+ * over packed keys, so no work allocates. Non-square boards only use the four
+ * transforms that map the grid onto itself; hashed keys are left unchanged.
+ */
+class StateSymmetry {
+public:
+    static constexpr int NUM_TRANSFORMS = 8;
+    static constexpr uint8_t IDENTITY = 0;
+
+    static CanonicalState canonicalize(StateKey key);
+    static StateKey transform(StateKey key, int transform);
+
+    // Action relabelling between the original and transformed frames
+    static int toCanonicalAction(int action, int transform);
+    static int fromCanonicalAction(int action, int transform);
+
+    static bool isValidTransform(int transform);
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Fixed set of worker threads that run one job at a time
+ *
+ * Threads are started once and reused, so repeated parallel loops do not pay
+ * for thread creation. parallelFor() hands out indices one at a time from an
+ * atomic counter, which balances uneven work items (episodes of very
+ * different lengths) without any locking. Every call blocks until all work is
+ * done; the first exception thrown by a worker is rethrown to the caller.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t num_threads = 0); // 0 uses every hardware thread
+    ~ThreadPool();
+
+    size_t size() const;
+
+    // Runs task(worker) once on every worker thread
+    void runOnAll(const std::function<void(size_t worker)>& task);
+
+    // Calls body(index, worker) for every index in [0, count)
+    void parallelFor(size_t count, const std::function<void(size_t index, size_t worker)>& body);
+
+private:
+    std::vector<std::thread> threads_;
+
+    // Current job, published under the mutex with a new generation number
+    std::mutex mutex_;
+    std::condition_variable job_ready_;
+    std::condition_variable job_done_;
+    const std::function<void(size_t)>* task_;
+    size_t generation_;
+    size_t running_;
+    bool stopping_;
+    std::exception_ptr error_;
+
+    void workerLoop(size_t worker);
+
+    // Copy prevention
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+};
+
+} // namespace SnakeGame::RL
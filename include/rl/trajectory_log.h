@@ -0,0 +1,133 @@
+#pragma once
+
+#include "rl_interface.h"
+#include "binary_codec.h"
+#include "../game_controller.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Everything needed to replay one episode exactly
+ *
+ * The apple is the game's only random component, so the environment seed and
+ * the action sequence reproduce every step.
+ */
+struct EpisodeRecording {
+    unsigned int seed = 0;              // Set on the game before reset()
+    size_t max_steps = 500;
+    std::vector<uint8_t> actions;       // One per step
+    std::vector<float> initial_state;   // State after reset(), to check the replay against
+    std::vector<float> rewards;         // One per step, if recorded
+    double score = 0.0;                 // Final score
+};
+
+/**
+ * @brief Append-only binary log of episodes, filled by SnakeEnvironment
+ *
+ * Attach with SnakeEnvironment::setRecorder(). The file starts with a magic
+ * number; each finished episode is then appended as one length-prefixed
+ * record: varint seed, max steps and step count, a flags byte, the score,
+ * the initial state as float32, the actions packed four per byte (2 bits each)
+ * and, when enabled, one float32 reward per step. Without rewards an episode
+ * costs a quarter byte per step plus about 80 bytes.
+ *
+ * Steps only write into buffers reserved at the start of the episode, so
+ * recording does not allocate per step. Records go through a stdio buffer;
+ * flush() or destruction makes them visible to readers. An episode still
+ * open when its environment is destroyed is not logged. One writer serves
+ * one environment.
+ */
+class TrajectoryWriter : public EpisodeRecorder {
+public:
+    explicit TrajectoryWriter(const std::string& filepath, bool record_rewards = false);
+    ~TrajectoryWriter() override;
+
+    // EpisodeRecorder interface implementation
+    void beginEpisode(unsigned int seed, size_t max_steps, const std::vector<double>& initial_state) override;
+    void recordStep(int action, double reward) override;
+    void endEpisode(double score) override;
+
+    void flush();
+    size_t getEpisodes() const;
+    size_t getSteps() const;
+    size_t getBytes() const;            // Including the file header if this writer created it
+
+private:
+    std::FILE* file_;
+    bool record_rewards_;
+
+    // Current episode
+    unsigned int seed_;
+    size_t max_steps_;
+    size_t steps_;
+    std::vector<float> initial_state_;
+    std::vector<uint8_t> packed_actions_;
+    std::vector<float> rewards_;
+    ByteWriter record_;
+
+    size_t episodes_;
+    size_t total_steps_;
+    size_t bytes_;
+
+    // Copy prevention
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+};
+
+/**
+ * @brief Random access to the episodes of a trajectory log
+ *
+ * The file is read once and indexed by record offsets; read() decodes one
+ * episode. A record cut off by a crash at the end of the file is ignored.
+ */
+class TrajectoryReader {
+public:
+    explicit TrajectoryReader(const std::string& filepath);
+
+    size_t size() const;
+    EpisodeRecording read(size_t episode) const;
+    size_t getSteps() const;            // Over all episodes
+
+private:
+    std::vector<uint8_t> data_;
+    std::vector<size_t> offsets_;       // Start of each record's payload
+    std::vector<size_t> lengths_;
+    size_t total_steps_;
+};
+
+/**
+ * @brief Rebuilds the game state at any step of a recorded episode
+ *
+ * Replays the recorded actions on a headless Game, skipping state encoding
+ * and rewards bookkeeping, so fast-forwarding runs at engine speed. seek()
+ * moves forward from the current step or restarts from the seed to go back.
+ * verify() replays the whole episode and checks the initial state, every
+ * recorded reward and the final score, reporting the first mismatch.
+ */
+class TrajectoryReplayer {
+public:
+    explicit TrajectoryReplayer(EpisodeRecording recording);
+
+    void restart();
+    bool advance();                     // One step; false at the end of the recording
+    void seek(size_t step);             // State after step actions
+
+    size_t getStep() const;
+    size_t getLength() const;
+    double getLastReward() const;
+    const Game& getGame() const;
+    const EpisodeRecording& getRecording() const;
+
+    bool verify(std::string* mismatch = nullptr);
+
+private:
+    EpisodeRecording recording_;
+    Game game_;
+    size_t step_;
+};
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "rl_interface.h"
+#include "replay_buffer.h"
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+/**
+ * @brief Zero-copy view of one chunk of a mapped transition dataset
+ */
+struct DatasetChunk {
+    size_t rows = 0;
+    const float* states = nullptr;       // rows x state_size, row-major
+    const float* next_states = nullptr;  // rows x state_size, row-major
+    const float* rewards = nullptr;
+    const uint8_t* actions = nullptr;
+    const uint8_t* dones = nullptr;
+};
+
+/**
+ * @brief Streams (state, action, reward, next_state, done) transitions to disk
+ *
+ * The file is columnar and chunked: every chunk_rows transitions are written
+ * as one chunk holding a float32 column for states, next states and rewards
+ * and a uint8 column for actions and dones, each column 64-byte aligned and
+ * each chunk page aligned. finish() appends the chunk index (offset and row
+ * count per chunk) and the header, so only whole, indexed files become
+ * visible: the data goes to "<path>.tmp" and is renamed over path at the end.
+ *
+ * Rows are converted straight into the current chunk's column buffers, which
+ * are allocated once, so adding a transition never allocates.
+ */
+class TransitionDatasetWriter {
+public:
+    TransitionDatasetWriter(const std::string& filepath, size_t state_size, size_t chunk_rows = 16384);
+    ~TransitionDatasetWriter(); // Finishes the file if finish() was not called
+
+    void add(const std::vector<double>& state, int action, double reward,
+             const std::vector<double>& next_state, bool done);
+    void add(const float* state, int action, float reward, const float* next_state, bool done);
+
+    // Plays episodes of env with agent, starting with a reset, until transitions are written
+    size_t collect(Environment& env, Agent& agent, size_t transitions);
+
+    void finish();
+
+    size_t getRows() const;
+    size_t getChunks() const;
+    size_t getBytes() const;            // Written so far, including padding
+
+private:
+    std::string path_;
+    std::string temp_path_;
+    std::FILE* file_;
+    size_t state_size_;
+    size_t chunk_rows_;
+    size_t rows_;
+    size_t bytes_;
+
+    // Current chunk, in column order
+    size_t chunk_fill_;
+    std::vector<float> states_;
+    std::vector<float> next_states_;
+    std::vector<float> rewards_;
+    std::vector<uint8_t> actions_;
+    std::vector<uint8_t> dones_;
+
+    // Chunk index
+    std::vector<uint64_t> chunk_offsets_;
+    std::vector<uint64_t> chunk_sizes_;
+
+    void nextRow(int action, float reward, bool done);
+    void writeChunk();
+    void write(const void* data, size_t size);
+    void pad(size_t alignment);
+    bool finalize();
+
+    // Copy prevention
+    TransitionDatasetWriter(const TransitionDatasetWriter&) = delete;
+    TransitionDatasetWriter& operator=(const TransitionDatasetWriter&) = delete;
+};
+
+/**
+ * @brief Memory-mapped, read-only access to a transition dataset
+ *
+ * The file is mapped rather than read, so opening it costs only the index
+ * check and pages are loaded on first touch. chunk() exposes columns in place;
+ * read() copies a contiguous range of rows one column run at a time, and
+ * sample() draws a uniform minibatch into the same TransitionBatch layout
+ * ReplayBuffer uses. A batch's rows are copied in file order, so a cold file
+ * is touched in ascending page order. Requires POSIX mmap.
+ */
+class TransitionDatasetReader {
+public:
+    explicit TransitionDatasetReader(const std::string& filepath);
+    ~TransitionDatasetReader();
+
+    size_t size() const;
+    size_t getStateSize() const;
+    size_t getChunkCount() const;
+    const DatasetChunk& chunk(size_t index) const;
+    size_t bytesMapped() const;
+
+    void read(size_t first, size_t count, TransitionBatch& batch) const;
+    void sample(size_t batch_size, TransitionBatch& batch);
+    void setSeed(unsigned int seed);
+
+private:
+    std::string path_;
+    int fd_;
+    void* mapping_;
+    size_t mapping_size_;
+    size_t state_size_;
+    size_t chunk_rows_;
+    size_t rows_;
+    std::vector<DatasetChunk> chunks_;
+    std::mt19937_64 gen_;
+
+    void copyRow(size_t index, size_t row, TransitionBatch& batch) const;
+    void release();
+
+    // Copy prevention
+    TransitionDatasetReader(const TransitionDatasetReader&) = delete;
+    TransitionDatasetReader& operator=(const TransitionDatasetReader&) = delete;
+};
+
+} // namespace SnakeGame::RL
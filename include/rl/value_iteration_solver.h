@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../common_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SnakeGame::RL {
+
+class QLearningAgent; // Forward declaration
+
+/**
+ * @brief Settings for the exact value iteration solver
+ */
+struct SolverConfig {
+    int board_size = GameConfig::GRID_SIZE_X; // Side of the square wrapping board
+    int max_length = 5;                       // Snakes stop growing at this length
+    double discount_factor = 0.95;
+    double apple_reward = static_cast<double>(RewardType::APPLE_EATEN);
+    double collision_penalty = static_cast<double>(RewardType::COLLISION);
+    double time_penalty = static_cast<double>(RewardType::TIME_PENALTY);
+    double tolerance = 1e-4;      // Stop once no value changes by more than this
+    size_t max_sweeps = 2000;
+    size_t num_threads = 0;       // 0 = hardware concurrency
+    size_t report_interval = 25;  // Sweeps between progress lines (0 = silent)
+};
+
+/**
+ * @brief Outcome of a solve() call
+ */
+struct SolverStats {
+    size_t num_bodies = 0;
+    size_t num_states = 0;
+    size_t sweeps = 0;
+    double residual = 0.0;
+    double seconds = 0.0;
+    size_t bytes_used = 0;
+    bool converged = false;
+};
+
+/**
+ * @brief Optimal Q-values for Snake on small boards by synchronous value iteration
+ *
+ * Models the Game dynamics on an N x N wrapping board: reversing is ignored,
+ * the tail is popped before the collision check, eating grows the tail straight
+ * along the last segment and respawns the apple uniformly on a free cell.
+ * Growth stops at max_length (eating still scores), which keeps the state
+ * space finite; episodes are not truncated and rewards are discounted.
+ *
+ * A state is (body, apple cell). Bodies are encoded as a head cell plus one
+ * 2-bit direction per segment, only bodies reachable from the start position
+ * are kept, and the transition structure is stored per (body, action) rather
+ * than per state, so the table size is dominated by one float per state.
+ * Sweeps are Jacobi updates split across threads by body range.
+ */
+class ValueIterationSolver {
+public:
+    explicit ValueIterationSolver(const SolverConfig& config = SolverConfig());
+
+    // Builds the reachable state space (done lazily by solve())
+    void enumerate();
+    SolverStats solve();
+
+    // Results
+    double getStartValue() const;
+    void getQValues(size_t body, int apple_cell, double q_values[4]) const;
+    int getBestAction(size_t body, int apple_cell) const;
+
+    // Writes Q-values projected onto the 17-feature state keys into a tabular
+    // agent; only valid when the board matches GameConfig
+    size_t exportPolicy(QLearningAgent& agent) const;
+    bool canExportPolicy() const;
+
+    // State space information
+    size_t getNumBodies() const;
+    size_t getNumStates() const;
+    size_t bytesUsed() const;
+    const SolverConfig& getConfig() const;
+
+private:
+    static constexpr uint32_t COLLISION = ~uint32_t(0);
+
+    SolverConfig config_;
+    int cells_;
+    size_t occupancy_words_;
+    std::vector<uint64_t> length_offsets_; // First code of each body length
+
+    // Per body
+    std::vector<uint32_t> codes_;
+    std::vector<uint16_t> heads_;
+    std::vector<uint64_t> occupancy_; // Bitset of body cells
+    std::vector<uint16_t> free_cells_;
+
+    // Per (body, action): successor body after moving, and after moving + eating
+    std::vector<uint32_t> next_body_;
+    std::vector<uint32_t> grown_body_;
+
+    // Values indexed by body * cells + apple cell
+    std::vector<float> values_;
+    std::vector<float> next_values_;
+    std::vector<float> mean_free_values_; // Expected value after an apple respawn
+
+    // Helper methods
+    uint64_t encodeBody(int length, int head, uint64_t directions) const;
+    void decodeBody(uint64_t code, int& length, int& head, uint64_t& directions) const;
+    void bodyCells(int length, int head, uint64_t directions, int* cells) const;
+    int stepCell(int cell, int direction) const;
+    bool isOccupied(size_t body, int cell) const;
+    double qValue(size_t body, int apple_cell, int action) const;
+    void computeMeanFreeValues(size_t begin, size_t end);
+    double sweep(size_t begin, size_t end);
+    size_t threadCount() const;
+};
+
+} // namespace SnakeGame::RL
@@ -39,6 +39,10 @@ void Apple::reset() {
     position_ = {GameConfig::GRID_SIZE_X / 2 - 1, GameConfig::GRID_SIZE_Y / 2 - 1};
 }
 
+void Apple::setSeed(unsigned int seed) {
+    gen_.seed(seed);
+}
+
 std::optional<Position> Apple::findRandomValidPosition(const PositionSet& forbidden_positions) const { // Need to double check this
     // Create a vector of all possible positions
     std::vector<Position> all_positions;
@@ -17,7 +17,10 @@ Game::Game() // Member initialization list since we can't assign to references.
     , game_speed_(GameConfig::DEFAULT_GAME_SPEED)
     , current_direction_(Direction::RIGHT)
     , last_reward_(0.0)
-    , reward_callback_(nullptr) {
+    , reward_callback_(nullptr)
+    , input_queue_()
+    , input_head_(0)
+    , input_count_(0) {
 }
 
 Game::~Game() = default;
@@ -36,6 +39,11 @@ void Game::reset() {
     score_ = 0;
     current_direction_ = Direction::RIGHT;
     last_reward_ = 0.0;
+    clearInputQueue();
+}
+
+void Game::setSeed(unsigned int seed) {
+    apple_->setSeed(seed);
 }
 
 void Game::step() {
@@ -44,10 +52,6 @@ void Game::step() {
     }
     
     updateGameLogic();
-    
-    if (graphics_) {
-        render();
-    }
 }
 
 bool Game::isGameOver() const {
@@ -84,18 +88,53 @@ int Game::getGameSpeed() const {
     return game_speed_;
 }
 
+std::chrono::microseconds Game::getStepInterval() const {
+    return std::chrono::microseconds(GameConfig::BASE_STEP_INTERVAL_MS * 1000 / game_speed_);
+}
+
 void Game::setDirection(Direction dir) {
+    // Validate against the last queued turn, so "up then left" within one step
+    // is two turns rather than a rejected reversal of the current direction
+    Direction last = current_direction_;
+    if (input_count_ > 0) {
+        last = input_queue_[(input_head_ + input_count_ - 1) % INPUT_QUEUE_CAPACITY].direction;
+    }
+    if (dir == Direction::NONE || dir == last || isReversal(last, dir) || input_count_ == INPUT_QUEUE_CAPACITY) {
+        return;
+    }
+    
+    input_queue_[(input_head_ + input_count_) % INPUT_QUEUE_CAPACITY] = {dir, std::chrono::steady_clock::now()};
+    input_count_++;
+}
+
+void Game::applyDirection(Direction dir) {
     // Prevent reversing direction
-    if ((current_direction_ == Direction::UP && dir == Direction::DOWN) ||
-        (current_direction_ == Direction::DOWN && dir == Direction::UP) ||
-        (current_direction_ == Direction::LEFT && dir == Direction::RIGHT) ||
-        (current_direction_ == Direction::RIGHT && dir == Direction::LEFT)) {
+    if (isReversal(current_direction_, dir)) {
         return;
     }
     
     current_direction_ = dir;
 }
 
+bool Game::isReversal(Direction from, Direction to) {
+    return (from == Direction::UP && to == Direction::DOWN) ||
+           (from == Direction::DOWN && to == Direction::UP) ||
+           (from == Direction::LEFT && to == Direction::RIGHT) ||
+           (from == Direction::RIGHT && to == Direction::LEFT);
+}
+
+void Game::clearInputQueue() {
+    input_head_ = 0;
+    input_count_ = 0;
+    applied_input_time_.reset();
+}
+
+std::optional<std::chrono::steady_clock::time_point> Game::takeAppliedInputTime() {
+    auto time = applied_input_time_;
+    applied_input_time_.reset();
+    return time;
+}
+
 Direction Game::getCurrentDirection() const {
     return current_direction_;
 }
@@ -156,7 +195,9 @@ bool Game::performAction(Direction action) {
         return false;
     }
     
-    setDirection(action);
+    // Agents act on the current step directly, bypassing the key queue
+    clearInputQueue();
+    applyDirection(action);
     updateGameLogic();
     
     return current_state_ == GameStateType::PLAYING;
@@ -171,7 +212,7 @@ void Game::setGraphics(std::unique_ptr<Graphics> graphics) {
 }
 
 void Game::render() {
-    if (!graphics_) {
+    if (!graphics_ || !graphics_->isFrameDue()) {
         return;
     }
     
@@ -242,6 +283,15 @@ double Game::calculateReward() const {
 }
 
 void Game::updateGameLogic() {
+    // Take at most one queued turn per step
+    if (input_count_ > 0) {
+        const QueuedInput& input = input_queue_[input_head_];
+        applyDirection(input.direction);
+        applied_input_time_ = input.time;
+        input_head_ = (input_head_ + 1) % INPUT_QUEUE_CAPACITY;
+        input_count_--;
+    }
+    
     // Move the snake
     bool move_successful = snake_->move(current_direction_);
     
@@ -1,6 +1,7 @@
 #include "graphics.h"
 #include "snake.h"
 #include "apple.h"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -19,8 +20,19 @@ OpenGLGraphics* OpenGLGraphics::instance_ = nullptr;
 OpenGLGraphics::OpenGLGraphics() 
     : window_id_(0)
     , initialized_(false)
-    , pending_direction_(std::nullopt) {
+    , pending_direction_(std::nullopt)
+    , cell_x_(GameConfig::GRID_SIZE_X)
+    , cell_y_(GameConfig::GRID_SIZE_Y) {
     instance_ = this;
+    
+    // Map grid columns/rows [-size/2, size/2 - 1] evenly onto [-0.9, 0.9]
+    for (int i = 0; i < GameConfig::GRID_SIZE_X; ++i) {
+        cell_x_[i] = static_cast<float>(static_cast<double>(i) / (GameConfig::GRID_SIZE_X - 1) * 1.8 - 0.9);
+    }
+    for (int i = 0; i < GameConfig::GRID_SIZE_Y; ++i) {
+        cell_y_[i] = static_cast<float>(static_cast<double>(i) / (GameConfig::GRID_SIZE_Y - 1) * 1.8 - 0.9);
+    }
+    vertices_.reserve(4 * (GameConfig::GRID_SIZE_X * GameConfig::GRID_SIZE_Y + 1));
 }
 
 OpenGLGraphics::~OpenGLGraphics() {
@@ -37,10 +49,12 @@ void OpenGLGraphics::initialize() {
 }
 
 void OpenGLGraphics::clear() {
+    vertices_.clear();
     glClear(GL_COLOR_BUFFER_BIT);
 }
 
 void OpenGLGraphics::present() {
+    flushCells();
     glutSwapBuffers();
 }
 
@@ -57,12 +71,12 @@ void OpenGLGraphics::drawSnake(const Snake& snake) {
     
     for (size_t i = 0; i < positions.size(); ++i) {
         EntityType type = (i == 0) ? EntityType::SNAKE_HEAD : EntityType::SNAKE_BODY;
-        drawRectangle(positions[i], type);
+        queueCell(positions[i], type);
     }
 }
 
 void OpenGLGraphics::drawApple(const Apple& apple) {
-    drawRectangle(apple.getPosition(), EntityType::APPLE);
+    queueCell(apple.getPosition(), EntityType::APPLE);
 }
 
 void OpenGLGraphics::drawScore(unsigned int score, unsigned int high_score) {
@@ -112,41 +126,56 @@ bool OpenGLGraphics::isKeyPressed(char key) const {
     return false;
 }
 
-void OpenGLGraphics::drawRectangle(const Position& pos, EntityType type) {
+void OpenGLGraphics::queueCell(const Position& pos, EntityType type) {
     if (pos.size() < 2) return;
     
-    // Convert game coordinates to screen coordinates
-    // Game coordinates: [-5, 4] for a 10x10 grid
-    // Screen coordinates: [-1, 1]
-    // Map [-5, 4] to [-0.9, 0.9] evenly
-    double x = ((static_cast<double>(pos[0]) - (-GameConfig::GRID_SIZE_X / 2)) / (GameConfig::GRID_SIZE_X - 1)) * 1.8 - 0.9;
-    double y = ((static_cast<double>(pos[1]) - (-GameConfig::GRID_SIZE_Y / 2)) / (GameConfig::GRID_SIZE_Y - 1)) * 1.8 - 0.9;
+    // Game coordinates [-size/2, size/2 - 1] index the precomputed centers
+    int column = pos[0] + GameConfig::GRID_SIZE_X / 2;
+    int row = pos[1] + GameConfig::GRID_SIZE_Y / 2;
+    if (column < 0 || column >= GameConfig::GRID_SIZE_X || row < 0 || row >= GameConfig::GRID_SIZE_Y) {
+        return;
+    }
+    float x = cell_x_[column];
+    float y = cell_y_[row];
     
     // Set color based on entity type
+    unsigned char r = 0, g = 0, b = 0;
     switch (type) {
         case EntityType::SNAKE_HEAD:
-            glColor3f(0.0f, 1.0f, 0.0f); // Bright green for snake head
+            g = 255; // Bright green for snake head
             break;
         case EntityType::SNAKE_BODY:
-            glColor3f(0.0f, 0.7f, 0.0f); // Darker green for snake body
+            g = 178; // Darker green for snake body
             break;
         case EntityType::APPLE:
-            glColor3f(1.0f, 0.0f, 0.0f); // Red for apple
+            r = 255; // Red for apple
             break;
     }
     
-    // Draw rectangle
-    double size = 0.08; // Size of each cell
+    // Append the cell's corners
+    const float size = 0.08f; // Half the size of each cell
+    vertices_.push_back({x - size, y - size, r, g, b, 255});
+    vertices_.push_back({x + size, y - size, r, g, b, 255});
+    vertices_.push_back({x + size, y + size, r, g, b, 255});
+    vertices_.push_back({x - size, y + size, r, g, b, 255});
+}
+
+void OpenGLGraphics::flushCells() {
+    if (vertices_.empty()) return;
     
-    glBegin(GL_QUADS);
-    glVertex2d(x - size, y - size);
-    glVertex2d(x + size, y - size);
-    glVertex2d(x + size, y + size);
-    glVertex2d(x - size, y + size);
-    glEnd();
+    // One draw call for every cell queued since the last flush
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices_[0].x);
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), &vertices_[0].r);
+    glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(vertices_.size()));
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    vertices_.clear();
 }
 
 void OpenGLGraphics::drawText(double x, double y, const std::string& text, void* font) {
+    flushCells(); // Text goes on top of the cells queued so far
     glColor3f(1.0f, 1.0f, 1.0f); // White text
     glRasterPos2d(x, y);
     
@@ -225,10 +254,244 @@ void OpenGLGraphics::specialKeyCallback(int key, int x, int y) {
     }
 }
 
+// ConsoleGraphics implementation
+namespace {
+
+// Board layout: score line, then the grid inside a border, two columns per cell
+constexpr int CONSOLE_TOP_ROWS = 2;
+constexpr int CONSOLE_ROWS = GameConfig::GRID_SIZE_Y + 3;
+constexpr int CONSOLE_COLUMNS = 2 * GameConfig::GRID_SIZE_X + 2;
+
+} // namespace
+
+ConsoleGraphics::ConsoleGraphics()
+    : ConsoleGraphics(ConsoleConfig()) {
+}
+
+ConsoleGraphics::ConsoleGraphics(const ConsoleConfig& config)
+    : config_(config)
+    , initialized_(false)
+    , should_close_(false)
+    , frame_interval_(std::chrono::steady_clock::duration::zero())
+    , next_frame_time_() {
+    if (config_.max_fps > 0.0) {
+        frame_interval_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / config_.max_fps));
+    }
+    initializeScreenBuffer();
+    output_.reserve(16 * CONSOLE_ROWS * CONSOLE_COLUMNS);
+}
+
+ConsoleGraphics::~ConsoleGraphics() {
+    shutdown();
+}
+
+void ConsoleGraphics::initialize() {
+    if (initialized_) return;
+    
+    // Clear the screen, hide the cursor and keep later output below the board
+    std::fprintf(config_.output, "\x1b[2J\x1b[?25l\x1b[%dr\x1b[%d;1H", CONSOLE_ROWS + 2, CONSOLE_ROWS + 2);
+    std::fflush(config_.output);
+    for (auto& row : previous_buffer_) {
+        std::fill(row.begin(), row.end(), '\0'); // Nothing on screen yet
+    }
+    initialized_ = true;
+}
+
+bool ConsoleGraphics::isFrameDue() const {
+    return frame_interval_ == std::chrono::steady_clock::duration::zero() ||
+           std::chrono::steady_clock::now() >= next_frame_time_;
+}
+
+void ConsoleGraphics::clear() {
+    screen_buffer_ = blank_buffer_;
+}
+
+void ConsoleGraphics::present() {
+    if (!initialized_) {
+        initialize();
+    }
+    writeChanges();
+    next_frame_time_ = std::chrono::steady_clock::now() + frame_interval_;
+}
+
+void ConsoleGraphics::shutdown() {
+    if (!initialized_) return;
+    
+    // Restore the full scroll region (which homes the cursor) and the cursor itself
+    std::fprintf(config_.output, "\x1b[0m\x1b" "7\x1b[r\x1b" "8\x1b[?25h");
+    std::fflush(config_.output);
+    initialized_ = false;
+}
+
+void ConsoleGraphics::drawSnake(const Snake& snake) {
+    const auto& positions = snake.getAllPositions();
+    
+    for (size_t i = 0; i < positions.size(); ++i) {
+        setCell(positions[i], (i == 0) ? EntityType::SNAKE_HEAD : EntityType::SNAKE_BODY);
+    }
+}
+
+void ConsoleGraphics::drawApple(const Apple& apple) {
+    setCell(apple.getPosition(), EntityType::APPLE);
+}
+
+void ConsoleGraphics::drawScore(unsigned int score, unsigned int high_score) {
+    std::stringstream ss;
+    ss << "Score: " << score << "  High: " << high_score;
+    writeText(0, ss.str());
+}
+
+void ConsoleGraphics::drawGameOver() {
+    writeText(CONSOLE_ROWS / 2, " GAME OVER ");
+    writeText(CONSOLE_ROWS / 2 + 1, " R to restart ");
+}
+
+void ConsoleGraphics::drawPaused() {
+    writeText(CONSOLE_ROWS / 2, " PAUSED ");
+    writeText(CONSOLE_ROWS / 2 + 1, " P to continue ");
+}
+
+void ConsoleGraphics::drawHelp() {
+    writeText(CONSOLE_TOP_ROWS + 1, "SNAKE CONTROLS");
+    writeText(CONSOLE_TOP_ROWS + 3, "WASD/Arrows: Move");
+    writeText(CONSOLE_TOP_ROWS + 4, "P: Pause");
+    writeText(CONSOLE_TOP_ROWS + 5, "R: Restart");
+    writeText(CONSOLE_TOP_ROWS + 6, "H: Help");
+    writeText(CONSOLE_TOP_ROWS + 7, "ESC: Quit");
+}
+
+void ConsoleGraphics::setWindowTitle(const std::string& title) {
+    std::fprintf(config_.output, "\x1b]0;%s\x07", title.c_str());
+}
+
+bool ConsoleGraphics::shouldClose() const {
+    return should_close_;
+}
+
+std::optional<Direction> ConsoleGraphics::getInputDirection() {
+    return std::nullopt; // Output only: the terminal stays in its normal line mode
+}
+
+bool ConsoleGraphics::isKeyPressed(char /*key*/) const {
+    return false;
+}
+
+ConsoleStats ConsoleGraphics::getStats() const {
+    return stats_;
+}
+
+void ConsoleGraphics::initializeScreenBuffer() {
+    blank_buffer_.assign(CONSOLE_ROWS, std::vector<char>(CONSOLE_COLUMNS, ' '));
+    for (int column = 0; column < CONSOLE_COLUMNS; ++column) {
+        blank_buffer_[CONSOLE_TOP_ROWS - 1][column] = '-';
+        blank_buffer_[CONSOLE_ROWS - 1][column] = '-';
+    }
+    for (int row = CONSOLE_TOP_ROWS - 1; row < CONSOLE_ROWS; ++row) {
+        char edge = (row == CONSOLE_TOP_ROWS - 1 || row == CONSOLE_ROWS - 1) ? '+' : '|';
+        blank_buffer_[row][0] = edge;
+        blank_buffer_[row][CONSOLE_COLUMNS - 1] = edge;
+    }
+    screen_buffer_ = blank_buffer_;
+    previous_buffer_.assign(CONSOLE_ROWS, std::vector<char>(CONSOLE_COLUMNS, '\0'));
+}
+
+void ConsoleGraphics::writeChanges() {
+    output_.clear();
+    output_ += "\x1b" "7"; // Save the cursor of the scrolling output below
+    
+    int cursor_row = -1, cursor_column = -1;
+    const char* color = getCharColor(' '); // Every frame ends with attributes reset
+    char sequence[32];
+    for (int row = 0; row < CONSOLE_ROWS; ++row) {
+        const std::vector<char>& line = screen_buffer_[row];
+        std::vector<char>& previous = previous_buffer_[row];
+        for (int column = 0; column < CONSOLE_COLUMNS; ++column) {
+            char c = line[column];
+            if (config_.diff && c == previous[column]) {
+                continue;
+            }
+            if (row != cursor_row || column != cursor_column) {
+                int length = std::snprintf(sequence, sizeof(sequence), "\x1b[%d;%dH", row + 1, column + 1);
+                output_.append(sequence, length);
+            }
+            if (config_.color) {
+                const char* cell_color = getCharColor(c);
+                if (cell_color != color) {
+                    output_ += cell_color;
+                    color = cell_color;
+                }
+            }
+            output_ += c;
+            previous[column] = c;
+            cursor_row = row;
+            cursor_column = column + 1;
+            stats_.cells_written++;
+        }
+    }
+    
+    if (config_.color && color != getCharColor(' ')) {
+        output_ += "\x1b[0m";
+    }
+    output_ += "\x1b" "8";
+    std::fwrite(output_.data(), 1, output_.size(), config_.output);
+    std::fflush(config_.output);
+    stats_.bytes_written += output_.size();
+    stats_.frames_written++;
+}
+
+void ConsoleGraphics::writeText(int row, const std::string& text) {
+    if (row < 0 || row >= CONSOLE_ROWS) return;
+    
+    // Centered, clipped to the board width
+    size_t length = std::min(text.size(), static_cast<size_t>(CONSOLE_COLUMNS));
+    size_t start = row == 0 ? 0 : (CONSOLE_COLUMNS - length) / 2;
+    std::copy(text.begin(), text.begin() + length, screen_buffer_[row].begin() + start);
+}
+
+void ConsoleGraphics::setCell(const Position& pos, EntityType type) {
+    if (pos.size() < 2) return;
+    
+    // Game coordinates [-size/2, size/2 - 1], with y growing upwards
+    int column = pos[0] + GameConfig::GRID_SIZE_X / 2;
+    int row = GameConfig::GRID_SIZE_Y / 2 - 1 - pos[1];
+    if (column < 0 || column >= GameConfig::GRID_SIZE_X || row < 0 || row >= GameConfig::GRID_SIZE_Y) {
+        return;
+    }
+    screen_buffer_[CONSOLE_TOP_ROWS + row][1 + 2 * column] = getEntityChar(type);
+}
+
+char ConsoleGraphics::getEntityChar(EntityType type) const {
+    switch (type) {
+        case EntityType::SNAKE_HEAD:
+            return '@';
+        case EntityType::SNAKE_BODY:
+            return '#';
+        case EntityType::APPLE:
+            return '*';
+    }
+    return '?';
+}
+
+const char* ConsoleGraphics::getCharColor(char c) const {
+    switch (c) {
+        case '@':
+            return "\x1b[1;32m"; // Bright green for snake head
+        case '#':
+            return "\x1b[32m";   // Green for snake body
+        case '*':
+            return "\x1b[31m";   // Red for apple
+        default:
+            return "\x1b[0m";
+    }
+}
+
 // Factory function implementation
 std::unique_ptr<Graphics> createGraphics(const std::string& type) {
     if (type == "headless") {
         return std::make_unique<HeadlessGraphics>();
+    } else if (type == "console") {
+        return std::make_unique<ConsoleGraphics>();
     } else if (type == "opengl") {
         return std::make_unique<OpenGLGraphics>();
     }
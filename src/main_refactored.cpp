@@ -1,10 +1,11 @@
 #include "game_controller.h"
 #include "graphics.h"
 #include "rl/rl_interface.h"
+#include <algorithm>
 #include <iostream>
+#include <iomanip>
 #include <memory>
 #include <chrono>
-#include <thread>
 
 #ifdef __APPLE__
 #include<GLUT/glut.h>
@@ -13,10 +14,31 @@
 #endif
 
 using namespace SnakeGame;
+using Clock = std::chrono::steady_clock;
 
 // Global game instance for GLUT callbacks
 std::unique_ptr<Game> g_game = nullptr;
 
+// Fixed-timestep loop state: the simulation advances in whole steps of
+// getStepInterval(), scheduled with glutTimerFunc so GLUT blocks between them
+constexpr int MAX_CATCH_UP_STEPS = 5; // After a longer stall the missed time is dropped
+Clock::time_point g_next_step;
+
+// Input-to-move latency: key press that turned the snake -> step that moved that way
+double g_latency_total_ms = 0.0;
+double g_latency_max_ms = 0.0;
+size_t g_latency_samples = 0;
+
+void printInputLatency() {
+    if (g_latency_samples == 0) {
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(1)
+              << "Input-to-move latency: mean " << g_latency_total_ms / g_latency_samples
+              << " ms, max " << g_latency_max_ms << " ms over " << g_latency_samples << " turns"
+              << " (step interval " << g_game->getStepInterval().count() / 1000.0 << " ms)" << std::endl;
+}
+
 // GLUT callback functions
 void display() {
     if (g_game) {
@@ -24,19 +46,43 @@ void display() {
     }
 }
 
-void update() {
-    if (g_game && g_game->getState() == GameStateType::PLAYING) {
-        g_game->step();
-    }
+void scheduleTick();
+
+void tick(int) {
+    if (!g_game) return;
     
-    // Control game speed
-    std::this_thread::sleep_for(std::chrono::milliseconds(150));
-    glutPostRedisplay();
+    const Clock::time_point now = Clock::now();
+    const auto interval = g_game->getStepInterval();
+    for (int steps = 0; now >= g_next_step && steps < MAX_CATCH_UP_STEPS; ++steps) {
+        if (g_game->getState() == GameStateType::PLAYING) {
+            g_game->step();
+            glutPostRedisplay();
+            if (auto input_time = g_game->takeAppliedInputTime()) {
+                double latency_ms = std::chrono::duration<double, std::milli>(Clock::now() - *input_time).count();
+                g_latency_total_ms += latency_ms;
+                g_latency_max_ms = std::max(g_latency_max_ms, latency_ms);
+                g_latency_samples++;
+            }
+        }
+        g_next_step += interval;
+    }
+    if (now >= g_next_step) {
+        g_next_step = now + interval;
+    }
+    scheduleTick();
+}
+
+void scheduleTick() {
+    auto wait = std::chrono::ceil<std::chrono::milliseconds>(g_next_step - Clock::now());
+    glutTimerFunc(static_cast<unsigned int>(std::max<long long>(0, wait.count())), tick, 0);
 }
 
 void keyboard(unsigned char key, int x, int y) {
     if (!g_game) return;
     
+    // Pause, help and reset change what is on screen; turning only shows on the next step
+    GameStateType state_before = g_game->getState();
+    
     switch (key) {
         case 'w':
         case 'W':
@@ -57,6 +103,14 @@ void keyboard(unsigned char key, int x, int y) {
         case 'r':
         case 'R':
             g_game->reset();
+            glutPostRedisplay();
+            break;
+        case '+':
+        case '=':
+            g_game->setGameSpeed(g_game->getGameSpeed() + 1);
+            break;
+        case '-':
+            g_game->setGameSpeed(g_game->getGameSpeed() - 1);
             break;
         case 'p':
         case 'P':
@@ -75,9 +129,14 @@ void keyboard(unsigned char key, int x, int y) {
             }
             break;
         case 27: // ESC key
+            printInputLatency();
             exit(0);
             break;
     }
+    
+    if (g_game->getState() != state_before) {
+        glutPostRedisplay();
+    }
 }
 
 void specialKeyboard(int key, int x, int y) {
@@ -101,7 +160,7 @@ void specialKeyboard(int key, int x, int y) {
 
 void runHumanGame(int argc, char* argv[]) {
     std::cout << "Starting Snake Game (Human Player Mode)" << std::endl;
-    std::cout << "Controls: WASD or Arrow Keys, P to pause, R to reset, ESC to quit" << std::endl;
+    std::cout << "Controls: WASD or Arrow Keys, P to pause, R to reset, +/- to change speed, ESC to quit" << std::endl;
     
     // Initialize GLUT
     glutInit(&argc, argv);
@@ -125,10 +184,13 @@ void runHumanGame(int argc, char* argv[]) {
     
     // Set GLUT callbacks
     glutDisplayFunc(display);
-    glutIdleFunc(update);
     glutKeyboardFunc(keyboard);
     glutSpecialFunc(specialKeyboard);
     
+    // No idle callback: between steps GLUT waits for events instead of spinning
+    g_next_step = Clock::now() + g_game->getStepInterval();
+    scheduleTick();
+    
     // Start main loop
     glutMainLoop();
 }
@@ -0,0 +1,203 @@
+#include "rl/checkpoint_writer.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+namespace SnakeGame::RL {
+
+namespace {
+
+void syncFile(const std::string& path) {
+#ifndef _WIN32
+    // ofstream cannot fsync, so reopen the closed file for that
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not reopen checkpoint " + path);
+    }
+    int result = ::fsync(fd);
+    ::close(fd);
+    if (result != 0) {
+        throw std::runtime_error("Could not sync checkpoint " + path);
+    }
+#else
+    (void)path;
+#endif
+}
+
+void lowerThreadPriority() {
+#ifdef __linux__
+    // Linux applies nice values per thread; best effort, failures are harmless
+    constexpr int WRITER_NICE = 10;
+    ::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), WRITER_NICE);
+#endif
+}
+
+} // namespace
+
+CheckpointWriter::CheckpointWriter(const CheckpointConfig& config)
+    : config_(config)
+    , back_episode_(0)
+    , pending_(false)
+    , writing_(false)
+    , stopping_(false) {
+    if (config_.keep_last == 0) {
+        throw std::invalid_argument("At least one checkpoint must be kept");
+    }
+    if (config_.format == CheckpointFormat::DELTA) {
+        delta_writer_ = std::make_unique<DeltaCheckpointWriter>(config_.prefix + ".qck");
+    }
+    thread_ = std::thread(&CheckpointWriter::run, this);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_one();
+    thread_.join();
+}
+
+bool CheckpointWriter::submit(const QLearningAgent& agent, size_t episode) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_) {
+            stats_.skipped++;
+            return false;
+        }
+    }
+
+    // back_ belongs to this thread until pending_ is set
+    auto start = std::chrono::steady_clock::now();
+    agent.takeSnapshot(back_);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        back_episode_ = episode;
+        pending_ = true;
+        stats_.snapshot_seconds += seconds;
+    }
+    work_ready_.notify_one();
+    return true;
+}
+
+void CheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    work_done_.wait(lock, [this] { return !pending_ && !writing_; });
+}
+
+CheckpointStats CheckpointWriter::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::string CheckpointWriter::pathFor(size_t episode) const {
+    if (delta_writer_) {
+        return delta_writer_->getPath(); // Base of the chain every checkpoint extends
+    }
+    std::ostringstream path;
+    path << config_.prefix << "_" << std::setw(8) << std::setfill('0') << episode << ".txt";
+    return path.str();
+}
+
+void CheckpointWriter::run() {
+    // Formatting competes with training for CPU when cores are scarce
+    lowerThreadPriority();
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_ready_.wait(lock, [this] { return pending_ || stopping_; });
+        if (!pending_) {
+            return; // Stopping with nothing left to write
+        }
+
+        std::swap(front_, back_);
+        std::string path = pathFor(back_episode_);
+        pending_ = false;
+        writing_ = true;
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        std::string error;
+        size_t bytes = 0;
+        try {
+            if (delta_writer_) {
+                bytes = delta_writer_->write(front_).bytes;
+            } else {
+                bytes = writeFile(front_, path);
+            }
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Retention bookkeeping happens off the lock as well
+        std::string expired;
+        if (error.empty() && !delta_writer_) {
+            retained_.push_back(path);
+            if (retained_.size() > config_.keep_last) {
+                expired = retained_.front();
+                retained_.pop_front();
+            }
+        } else if (!error.empty()) {
+            std::cerr << "Checkpoint failed: " << error << std::endl;
+        }
+        if (!expired.empty()) {
+            std::remove(expired.c_str());
+        }
+
+        lock.lock();
+        writing_ = false;
+        stats_.write_seconds += seconds;
+        if (error.empty()) {
+            stats_.written++;
+            stats_.bytes_written += bytes;
+            stats_.last_path = path;
+        } else {
+            stats_.failed++;
+        }
+        work_done_.notify_all();
+    }
+}
+
+size_t CheckpointWriter::writeFile(const ModelSnapshot& snapshot, const std::string& path) {
+    const std::string temp_path = path + ".tmp";
+    size_t bytes = 0;
+    {
+        std::ofstream file(temp_path);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open checkpoint for writing: " + temp_path);
+        }
+        snapshot.write(file);
+        bytes = static_cast<size_t>(file.tellp());
+        file.close();
+        if (!file) {
+            std::remove(temp_path.c_str());
+            throw std::runtime_error("Could not write checkpoint: " + temp_path);
+        }
+    }
+    syncFile(temp_path);
+
+    // rename() replaces the destination atomically on POSIX
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        throw std::runtime_error("Could not move checkpoint into place: " + path);
+    }
+    return bytes;
+}
+
+} // namespace SnakeGame::RL
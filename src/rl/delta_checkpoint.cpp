@@ -0,0 +1,479 @@
+#include "rl/delta_checkpoint.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <filesystem>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+namespace SnakeGame::RL {
+
+namespace {
+
+constexpr uint64_t CHECKPOINT_MAGIC = 0x31544C44514B4E53ULL; // "SNKQDLT1"
+constexpr uint64_t FORMAT_VERSION = 1;
+constexpr uint8_t KIND_BASE = 0;
+constexpr uint8_t KIND_DELTA = 1;
+
+/**
+ * Fields at the start of every chain file
+ */
+struct FileHeader {
+    uint8_t kind;
+    uint64_t chain_id;
+    uint64_t sequence;
+    double quantization_step;
+    ModelSnapshot hyperparameters; // Keys and rows left empty
+};
+
+uint64_t checksum(const uint8_t* data, size_t size) {
+    // FNV-1a
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t newChainId() {
+    std::random_device rd;
+    uint64_t id = (static_cast<uint64_t>(rd()) << 32) ^ rd() ^
+                  static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    return id == 0 ? 1 : id;
+}
+
+void putHeader(ByteWriter& out, uint8_t kind, uint64_t chain_id, uint64_t sequence,
+               double quantization_step, const ModelSnapshot& snapshot) {
+    out.putUint64(CHECKPOINT_MAGIC);
+    out.putVarint(FORMAT_VERSION);
+    out.putByte(kind);
+    out.putUint64(chain_id);
+    out.putVarint(sequence);
+    out.putDouble(quantization_step);
+    out.putDouble(snapshot.learning_rate);
+    out.putDouble(snapshot.discount_factor);
+    out.putDouble(snapshot.epsilon);
+    out.putDouble(snapshot.epsilon_decay);
+    out.putDouble(snapshot.min_epsilon);
+    out.putByte(snapshot.symmetric ? 1 : 0);
+}
+
+FileHeader getHeader(ByteReader& in, const std::string& path) {
+    if (in.getUint64() != CHECKPOINT_MAGIC) {
+        throw std::runtime_error("Not a delta checkpoint: " + path);
+    }
+    uint64_t version = in.getVarint();
+    if (version != FORMAT_VERSION) {
+        throw std::runtime_error("Checkpoint " + path + " uses format version " + std::to_string(version) +
+                                 ", expected " + std::to_string(FORMAT_VERSION));
+    }
+
+    FileHeader header;
+    header.kind = in.getByte();
+    header.chain_id = in.getUint64();
+    header.sequence = in.getVarint();
+    header.quantization_step = in.getDouble();
+    header.hyperparameters.learning_rate = in.getDouble();
+    header.hyperparameters.discount_factor = in.getDouble();
+    header.hyperparameters.epsilon = in.getDouble();
+    header.hyperparameters.epsilon_decay = in.getDouble();
+    header.hyperparameters.min_epsilon = in.getDouble();
+    header.hyperparameters.symmetric = in.getByte() != 0;
+    if (!(header.quantization_step > 0.0)) {
+        throw std::runtime_error("Checkpoint " + path + " has a corrupt header");
+    }
+    return header;
+}
+
+bool readFile(const std::string& path, std::vector<uint8_t>& bytes) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    bytes.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+        throw std::runtime_error("Could not read checkpoint: " + path);
+    }
+    return true;
+}
+
+// Verifies the trailing checksum and returns a reader over the rest
+ByteReader openVerified(const std::vector<uint8_t>& bytes, const std::string& path) {
+    if (bytes.size() < 2 * sizeof(uint64_t)) {
+        throw std::runtime_error("Truncated checkpoint: " + path);
+    }
+    size_t body = bytes.size() - sizeof(uint64_t);
+    uint64_t stored;
+    std::memcpy(&stored, bytes.data() + body, sizeof(stored));
+    if (stored != checksum(bytes.data(), body)) {
+        throw std::runtime_error("Checksum mismatch in checkpoint: " + path);
+    }
+    return ByteReader(bytes.data(), body);
+}
+
+void writeAtomically(const std::string& path, const ByteWriter& bytes) {
+    const std::string temp_path = path + ".tmp";
+#ifndef _WIN32
+    int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open checkpoint for writing: " + temp_path);
+    }
+    size_t written = 0;
+    while (written < bytes.size()) {
+        ssize_t result = ::write(fd, bytes.data() + written, bytes.size() - written);
+        if (result <= 0) {
+            ::close(fd);
+            ::unlink(temp_path.c_str());
+            throw std::runtime_error("Could not write checkpoint: " + temp_path);
+        }
+        written += static_cast<size_t>(result);
+    }
+    if (::fsync(fd) != 0 || ::close(fd) != 0) {
+        ::unlink(temp_path.c_str());
+        throw std::runtime_error("Could not sync checkpoint: " + temp_path);
+    }
+    // rename() replaces the destination atomically on POSIX
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        throw std::runtime_error("Could not move checkpoint into place: " + path);
+    }
+#else
+    const std::filesystem::path temp_file(temp_path), final_file(path);
+    HANDLE file = ::CreateFileW(temp_file.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Could not open checkpoint for writing: " + temp_path);
+    }
+    size_t written = 0;
+    while (written < bytes.size()) {
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(bytes.size() - written, 1u << 30));
+        DWORD result = 0;
+        if (!::WriteFile(file, bytes.data() + written, chunk, &result, nullptr) || result == 0) {
+            ::CloseHandle(file);
+            ::DeleteFileW(temp_file.c_str());
+            throw std::runtime_error("Could not write checkpoint: " + temp_path);
+        }
+        written += result;
+    }
+    if (!::FlushFileBuffers(file) || !::CloseHandle(file)) {
+        ::DeleteFileW(temp_file.c_str());
+        throw std::runtime_error("Could not sync checkpoint: " + temp_path);
+    }
+
+    // Replaces the destination in one step, unlike remove() followed by rename()
+    if (!::MoveFileExW(temp_file.c_str(), final_file.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        ::DeleteFileW(temp_file.c_str());
+        throw std::runtime_error("Could not move checkpoint into place: " + path);
+    }
+#endif
+}
+
+/**
+ * Applies the changed and removed rows of one file to a sorted table
+ */
+template <typename Row>
+void applyChanges(ByteReader& in, std::vector<StateKey>& keys, std::vector<Row>& rows,
+                  std::vector<StateKey>& scratch_keys, std::vector<Row>& scratch_rows) {
+    // Changed rows: merge with the current table, adding the value deltas
+    uint64_t changed = in.getUint64();
+    scratch_keys.clear();
+    scratch_rows.clear();
+    scratch_keys.reserve(keys.size() + changed);
+    scratch_rows.reserve(keys.size() + changed);
+
+    size_t current = 0;
+    StateKey key = 0;
+    for (uint64_t i = 0; i < changed; ++i) {
+        key += in.getVarint();
+        while (current < keys.size() && keys[current] < key) {
+            scratch_keys.push_back(keys[current]);
+            scratch_rows.push_back(rows[current]);
+            current++;
+        }
+        Row row{};
+        if (current < keys.size() && keys[current] == key) {
+            row = rows[current];
+            current++;
+        }
+        for (auto& value : row) {
+            value = static_cast<typename Row::value_type>(value + in.getZigzag());
+        }
+        scratch_keys.push_back(key);
+        scratch_rows.push_back(row);
+    }
+    scratch_keys.insert(scratch_keys.end(), keys.begin() + current, keys.end());
+    scratch_rows.insert(scratch_rows.end(), rows.begin() + current, rows.end());
+    keys.swap(scratch_keys);
+    rows.swap(scratch_rows);
+
+    // Removed rows: filter them out in place
+    uint64_t removed = in.getUint64();
+    if (removed == 0) {
+        return;
+    }
+    size_t kept = 0;
+    size_t scan = 0;
+    key = 0;
+    for (uint64_t i = 0; i < removed; ++i) {
+        key += in.getVarint();
+        while (scan < keys.size() && keys[scan] < key) {
+            keys[kept] = keys[scan];
+            rows[kept] = rows[scan];
+            kept++;
+            scan++;
+        }
+        if (scan < keys.size() && keys[scan] == key) {
+            scan++;
+        }
+    }
+    while (scan < keys.size()) {
+        keys[kept] = keys[scan];
+        rows[kept] = rows[scan];
+        kept++;
+        scan++;
+    }
+    keys.resize(kept);
+    rows.resize(kept);
+}
+
+} // namespace
+
+DeltaCheckpointWriter::DeltaCheckpointWriter(const std::string& path, double quantization_step,
+                                             size_t max_chain_length)
+    : path_(path)
+    , quantization_step_(quantization_step)
+    , max_chain_length_(max_chain_length)
+    , chain_id_(0)
+    , sequence_(0)
+    , has_base_(false) {
+    if (!(quantization_step > 0.0)) {
+        throw std::invalid_argument("Quantization step must be positive");
+    }
+}
+
+DeltaCheckpointStats DeltaCheckpointWriter::write(const ModelSnapshot& snapshot) {
+    quantize(snapshot);
+
+    // Start a new chain first time round and whenever the chain is full
+    DeltaCheckpointStats stats;
+    stats.base = !has_base_ || sequence_ >= max_chain_length_;
+    uint64_t chain_id = stats.base ? newChainId() : chain_id_;
+    stats.sequence = stats.base ? 0 : sequence_ + 1;
+
+    static const std::vector<StateKey> no_keys;
+    static const std::vector<QuantizedRow> no_rows;
+    buffer_.clear();
+    putHeader(buffer_, stats.base ? KIND_BASE : KIND_DELTA, chain_id, stats.sequence,
+              quantization_step_, snapshot);
+    stats.changed_rows = stats.base ? encodeChanges(no_keys, no_rows, stats.removed_rows)
+                                    : encodeChanges(keys_, rows_, stats.removed_rows);
+    buffer_.putUint64(checksum(buffer_.data(), buffer_.size()));
+    stats.bytes = buffer_.size();
+
+    writeAtomically(stats.base ? path_ : deltaPath(path_, stats.sequence), buffer_);
+    if (stats.base) {
+        // Deltas of the previous chain no longer apply (the loader would also
+        // reject them by chain id)
+        removeStaleDeltas(1);
+    }
+
+    // Only now does the written state become the reference for the next delta
+    has_base_ = true;
+    chain_id_ = chain_id;
+    sequence_ = stats.sequence;
+    keys_.swap(next_keys_);
+    rows_.swap(next_rows_);
+    return stats;
+}
+
+const std::string& DeltaCheckpointWriter::getPath() const {
+    return path_;
+}
+
+size_t DeltaCheckpointWriter::getChainLength() const {
+    return has_base_ ? sequence_ + 1 : 0;
+}
+
+bool DeltaCheckpointWriter::isDeltaCheckpoint(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    uint64_t magic = 0;
+    return file.read(reinterpret_cast<char*>(&magic), sizeof(magic)) && magic == CHECKPOINT_MAGIC;
+}
+
+DeltaChainInfo DeltaCheckpointWriter::load(const std::string& path, ModelSnapshot& snapshot) {
+    std::vector<uint8_t> bytes;
+    if (!readFile(path, bytes)) {
+        throw std::runtime_error("Could not open checkpoint: " + path);
+    }
+
+    ByteReader base_reader = openVerified(bytes, path);
+    FileHeader base = getHeader(base_reader, path);
+    if (base.kind != KIND_BASE || base.sequence != 0) {
+        throw std::runtime_error("Checkpoint " + path + " is a delta, not a base");
+    }
+
+    DeltaChainInfo info;
+    info.files = 1;
+    info.bytes = bytes.size();
+    info.quantization_step = base.quantization_step;
+
+    std::vector<StateKey> keys, scratch_keys;
+    std::vector<QuantizedRow> rows, scratch_rows;
+    applyChanges(base_reader, keys, rows, scratch_keys, scratch_rows);
+    ModelSnapshot latest = base.hyperparameters;
+
+    // Replay deltas until the chain ends or a file belongs to an older chain
+    for (uint64_t sequence = 1;; ++sequence) {
+        std::string delta_path = deltaPath(path, sequence);
+        if (!readFile(delta_path, bytes)) {
+            break;
+        }
+        ByteReader reader = openVerified(bytes, delta_path);
+        FileHeader header = getHeader(reader, delta_path);
+        if (header.chain_id != base.chain_id) {
+            break;
+        }
+        if (header.kind != KIND_DELTA || header.sequence != sequence ||
+            header.quantization_step != base.quantization_step) {
+            throw std::runtime_error("Checkpoint " + delta_path + " does not continue its chain");
+        }
+        applyChanges(reader, keys, rows, scratch_keys, scratch_rows);
+        latest = header.hyperparameters;
+        info.files++;
+        info.bytes += bytes.size();
+    }
+
+    snapshot.learning_rate = latest.learning_rate;
+    snapshot.discount_factor = latest.discount_factor;
+    snapshot.epsilon = latest.epsilon;
+    snapshot.epsilon_decay = latest.epsilon_decay;
+    snapshot.min_epsilon = latest.min_epsilon;
+    snapshot.symmetric = latest.symmetric;
+    snapshot.keys = std::move(keys);
+    snapshot.rows.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        for (int action = 0; action < QTable::NUM_ACTIONS; ++action) {
+            snapshot.rows[i].q[action] = rows[i][action] * info.quantization_step;
+        }
+    }
+    return info;
+}
+
+DeltaChainInfo DeltaCheckpointWriter::compact(const std::string& path) {
+    ModelSnapshot snapshot;
+    DeltaChainInfo info = load(path, snapshot);
+
+    // A fresh writer always starts with a base, which replaces the chain
+    DeltaCheckpointWriter writer(path, info.quantization_step);
+    writer.write(snapshot);
+    return info;
+}
+
+std::string DeltaCheckpointWriter::deltaPath(const std::string& path, size_t sequence) {
+    return path + "." + std::to_string(sequence);
+}
+
+void DeltaCheckpointWriter::quantize(const ModelSnapshot& snapshot) {
+    const size_t count = snapshot.keys.size();
+    if (count > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Q-table too large for a delta checkpoint");
+    }
+
+    // Tables iterate in slot order, the format wants keys sorted
+    order_.resize(count);
+    std::iota(order_.begin(), order_.end(), 0u);
+    std::sort(order_.begin(), order_.end(),
+              [&snapshot](uint32_t a, uint32_t b) { return snapshot.keys[a] < snapshot.keys[b]; });
+
+    constexpr double LIMIT = std::numeric_limits<int32_t>::max();
+    next_keys_.resize(count);
+    next_rows_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        next_keys_[i] = snapshot.keys[order_[i]];
+        const QTable::Row& row = snapshot.rows[order_[i]];
+        for (int action = 0; action < QTable::NUM_ACTIONS; ++action) {
+            double steps = std::clamp(row.q[action] / quantization_step_, -LIMIT, LIMIT);
+            next_rows_[i][action] = static_cast<int32_t>(std::lround(steps));
+        }
+    }
+}
+
+size_t DeltaCheckpointWriter::encodeChanges(const std::vector<StateKey>& previous_keys,
+                                            const std::vector<QuantizedRow>& previous_rows, size_t& removed) {
+    // Counts are fixed-width so they can be patched in after the records
+    auto patchCount = [this](size_t offset, uint64_t count) {
+        std::memcpy(buffer_.buffer().data() + offset, &count, sizeof(count));
+    };
+
+    size_t count_offset = buffer_.size();
+    buffer_.putUint64(0);
+    size_t changed = 0;
+    size_t previous = 0;
+    StateKey last_key = 0;
+    for (size_t i = 0; i < next_keys_.size(); ++i) {
+        const StateKey key = next_keys_[i];
+        while (previous < previous_keys.size() && previous_keys[previous] < key) {
+            previous++;
+        }
+        const bool existed = previous < previous_keys.size() && previous_keys[previous] == key;
+        if (existed && previous_rows[previous] == next_rows_[i]) {
+            continue;
+        }
+
+        buffer_.putVarint(key - last_key);
+        last_key = key;
+        for (int action = 0; action < QTable::NUM_ACTIONS; ++action) {
+            int64_t before = existed ? previous_rows[previous][action] : 0;
+            buffer_.putZigzag(static_cast<int64_t>(next_rows_[i][action]) - before);
+        }
+        changed++;
+    }
+    patchCount(count_offset, changed);
+
+    // Rows present last time but gone now (evicted)
+    count_offset = buffer_.size();
+    buffer_.putUint64(0);
+    removed = 0;
+    size_t next = 0;
+    last_key = 0;
+    for (StateKey key : previous_keys) {
+        while (next < next_keys_.size() && next_keys_[next] < key) {
+            next++;
+        }
+        if (next < next_keys_.size() && next_keys_[next] == key) {
+            continue;
+        }
+        buffer_.putVarint(key - last_key);
+        last_key = key;
+        removed++;
+    }
+    patchCount(count_offset, removed);
+    return changed;
+}
+
+void DeltaCheckpointWriter::removeStaleDeltas(size_t first_sequence) const {
+    for (size_t sequence = first_sequence; std::remove(deltaPath(path_, sequence).c_str()) == 0; ++sequence) {
+    }
+}
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,576 @@
+#include "rl/distributed_trainer.h"
+#include "rl/binary_codec.h"
+#include "rl/dqn_agent.h"
+#include "rl/q_learning_agent.h"
+#include "rl/rl_interface.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace SnakeGame::RL {
+
+namespace {
+
+// Same learners as the single-process rl_example commands
+constexpr double Q_LEARNING_RATE = 0.1;
+constexpr double Q_DISCOUNT = 0.95;
+constexpr double Q_EPSILON = 0.3;
+constexpr size_t STATE_SIZE = 17;
+constexpr size_t ACTION_SIZE = 4;
+
+// Largest quantized weight delta; deltas are scaled so the biggest one maps here
+constexpr double QUANTIZATION_LEVELS = 32767.0;
+
+enum MessageType : uint8_t {
+    MSG_PARAMETERS = 1, // Server -> worker: initial network weights
+    MSG_DELTA = 2,      // Worker -> server: episode statistics + changes since last sync
+    MSG_UPDATE = 3,     // Server -> worker: merged state
+    MSG_DONE = 4        // Worker -> server: training finished
+};
+
+/**
+ * One changed Q-table row; only the actions in mask are transmitted
+ */
+struct RowUpdate {
+    StateKey key;
+    uint8_t mask;
+    double q[QTable::NUM_ACTIONS];
+};
+
+#ifndef _WIN32
+
+void encodeRows(ByteWriter& writer, std::vector<RowUpdate>& rows) {
+    // Sorted keys turn into small gaps, which varints store in a byte or two
+    std::sort(rows.begin(), rows.end(),
+              [](const RowUpdate& a, const RowUpdate& b) { return a.key < b.key; });
+
+    writer.putVarint(rows.size());
+    StateKey previous = 0;
+    for (const RowUpdate& row : rows) {
+        writer.putVarint(row.key - previous);
+        writer.putByte(row.mask);
+        for (int action = 0; action < QTable::NUM_ACTIONS; ++action) {
+            if (row.mask & (1 << action)) {
+                writer.putFloat(static_cast<float>(row.q[action]));
+            }
+        }
+        previous = row.key;
+    }
+}
+
+void decodeRows(ByteReader& reader, std::vector<RowUpdate>& rows) {
+    size_t count = reader.getVarint();
+    rows.resize(count);
+    StateKey previous = 0;
+    for (RowUpdate& row : rows) {
+        row.key = previous + reader.getVarint();
+        row.mask = reader.getByte();
+        for (int action = 0; action < QTable::NUM_ACTIONS; ++action) {
+            row.q[action] = (row.mask & (1 << action)) ? reader.getFloat() : 0.0;
+        }
+        previous = row.key;
+    }
+}
+
+void encodeQuantized(ByteWriter& writer, const std::vector<float>& values) {
+    float max_abs = 0.0f;
+    for (float value : values) {
+        max_abs = std::max(max_abs, std::abs(value));
+    }
+    float scale = static_cast<float>(max_abs / QUANTIZATION_LEVELS);
+
+    writer.putVarint(values.size());
+    writer.putFloat(scale);
+    for (float value : values) {
+        writer.putZigzag(scale > 0.0f ? std::lround(value / scale) : 0);
+    }
+}
+
+void decodeQuantized(ByteReader& reader, std::vector<float>& values) {
+    size_t count = reader.getVarint();
+    if (count != values.size()) {
+        throw std::runtime_error("Weight delta does not match the network size");
+    }
+    float scale = reader.getFloat();
+    for (float& value : values) {
+        value = static_cast<float>(reader.getZigzag()) * scale;
+    }
+}
+
+/**
+ * @brief Forwards to another environment while totalling finished episodes
+ */
+class EpisodeStatsEnvironment : public Environment {
+public:
+    explicit EpisodeStatsEnvironment(Environment& inner)
+        : inner_(inner), episode_reward_(0.0), episodes_(0), reward_sum_(0.0) {}
+
+    std::vector<double> reset() override {
+        episode_reward_ = 0.0;
+        return inner_.reset();
+    }
+
+    std::pair<std::vector<double>, double> step(int action) override {
+        auto result = inner_.step(action);
+        episode_reward_ += result.second;
+        if (inner_.isDone()) {
+            episodes_++;
+            reward_sum_ += episode_reward_;
+            episode_reward_ = 0.0;
+        }
+        return result;
+    }
+
+    bool isDone() const override { return inner_.isDone(); }
+    void render() override { inner_.render(); }
+    size_t getActionSpaceSize() const override { return inner_.getActionSpaceSize(); }
+    size_t getStateSpaceSize() const override { return inner_.getStateSpaceSize(); }
+    std::vector<int> getActionSpace() const override { return inner_.getActionSpace(); }
+
+    // Writes and resets the totals since the previous call
+    void writeStats(ByteWriter& writer) {
+        writer.putVarint(episodes_);
+        writer.putDouble(reward_sum_);
+        episodes_ = 0;
+        reward_sum_ = 0.0;
+    }
+
+private:
+    Environment& inner_;
+    double episode_reward_;
+    size_t episodes_;
+    double reward_sum_;
+};
+
+void writeAll(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Socket write failed: ") + std::strerror(errno));
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+// Returns false if the peer closed the socket before any byte arrived
+bool readAll(int fd, uint8_t* data, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t received = ::read(fd, data + total, size - total);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Socket read failed: ") + std::strerror(errno));
+        }
+        if (received == 0) {
+            if (total == 0) {
+                return false;
+            }
+            throw std::runtime_error("Connection closed in the middle of a message");
+        }
+        total += static_cast<size_t>(received);
+    }
+    return true;
+}
+
+// Frame: 4-byte payload size, 1-byte message type, payload
+size_t sendMessage(int fd, uint8_t type, const ByteWriter& payload) {
+    uint8_t header[5];
+    uint32_t size = static_cast<uint32_t>(payload.size());
+    std::memcpy(header, &size, sizeof(size));
+    header[4] = type;
+    writeAll(fd, header, sizeof(header));
+    writeAll(fd, payload.data(), payload.size());
+    return sizeof(header) + payload.size();
+}
+
+bool receiveMessage(int fd, uint8_t& type, std::vector<uint8_t>& payload) {
+    uint8_t header[5];
+    if (!readAll(fd, header, sizeof(header))) {
+        return false;
+    }
+    uint32_t size;
+    std::memcpy(&size, header, sizeof(size));
+    type = header[4];
+    payload.resize(size);
+    if (size > 0 && !readAll(fd, payload.data(), size)) {
+        throw std::runtime_error("Connection closed in the middle of a message");
+    }
+    return true;
+}
+
+void expectMessage(int fd, uint8_t expected, std::vector<uint8_t>& payload) {
+    uint8_t type = 0;
+    if (!receiveMessage(fd, type, payload) || type != expected) {
+        throw std::runtime_error("Unexpected message from parameter server");
+    }
+}
+
+void runQLearningWorker(int fd, const DistributedConfig& config) {
+    SnakeEnvironment env(true);
+    env.setMaxSteps(config.max_steps);
+    EpisodeStatsEnvironment tracked(env);
+
+    QLearningAgent agent(Q_LEARNING_RATE, Q_DISCOUNT, Q_EPSILON);
+    QTable& table = agent.getQTable();
+    QTable baseline; // Table contents as of the last synchronization
+
+    ByteWriter writer;
+    std::vector<uint8_t> payload;
+    std::vector<RowUpdate> rows;
+
+    for (size_t done = 0; done < config.episodes_per_worker; ) {
+        size_t chunk = std::min(config.sync_interval, config.episodes_per_worker - done);
+        agent.train(tracked, chunk);
+        done += chunk;
+
+        // Collect the rows that moved since the last synchronization
+        rows.clear();
+        table.forEach([&](StateKey key, const QTable::Row& row) {
+            const QTable::Row* base = baseline.find(key);
+            RowUpdate update{key, 0, {0.0, 0.0, 0.0, 0.0}};
+            for (int action = 0; action < QTable::NUM_ACTIONS; ++action) {
+                update.q[action] = row.q[action] - (base ? base->q[action] : 0.0);
+                if (update.q[action] != 0.0) {
+                    update.mask |= 1 << action;
+                }
+            }
+            if (update.mask != 0) {
+                rows.push_back(update);
+            }
+        });
+        for (const RowUpdate& update : rows) {
+            baseline.findOrInsert(update.key) = *table.find(update.key);
+        }
+
+        writer.clear();
+        tracked.writeStats(writer);
+        encodeRows(writer, rows);
+        sendMessage(fd, MSG_DELTA, writer);
+
+        // Adopt the merged values of every row other workers changed
+        expectMessage(fd, MSG_UPDATE, payload);
+        ByteReader reader(payload.data(), payload.size());
+        decodeRows(reader, rows);
+        for (const RowUpdate& update : rows) {
+            QTable::Row& local = table.findOrInsert(update.key);
+            QTable::Row& base = baseline.findOrInsert(update.key);
+            for (int action = 0; action < QTable::NUM_ACTIONS; ++action) {
+                if (update.mask & (1 << action)) {
+                    local.q[action] = base.q[action] = update.q[action];
+                }
+            }
+        }
+    }
+}
+
+void runDQNWorker(int fd, size_t worker_id, const DistributedConfig& config) {
+    SnakeEnvironment env(true);
+    env.setMaxSteps(config.max_steps);
+    EpisodeStatsEnvironment tracked(env);
+
+    DQNConfig dqn_config;
+    dqn_config.seed = static_cast<unsigned int>(worker_id + 1);
+    DQNAgent agent(STATE_SIZE, ACTION_SIZE, dqn_config);
+    std::vector<float>& parameters = agent.getNetwork().getParameters();
+
+    // Every worker starts from the server's weights
+    std::vector<uint8_t> payload;
+    expectMessage(fd, MSG_PARAMETERS, payload);
+    ByteReader initial(payload.data(), payload.size());
+    initial.getFloats(parameters.data(), parameters.size());
+    agent.syncTargetNetwork();
+    std::vector<float> baseline = parameters;
+    std::vector<float> delta(parameters.size());
+
+    ByteWriter writer;
+    for (size_t done = 0; done < config.episodes_per_worker; ) {
+        size_t chunk = std::min(config.sync_interval, config.episodes_per_worker - done);
+        agent.train(tracked, chunk);
+        done += chunk;
+
+        for (size_t i = 0; i < parameters.size(); ++i) {
+            delta[i] = parameters[i] - baseline[i];
+        }
+
+        writer.clear();
+        tracked.writeStats(writer);
+        encodeQuantized(writer, delta);
+        sendMessage(fd, MSG_DELTA, writer);
+
+        expectMessage(fd, MSG_UPDATE, payload);
+        ByteReader reader(payload.data(), payload.size());
+        reader.getFloats(parameters.data(), parameters.size());
+        baseline = parameters;
+    }
+}
+
+#endif // _WIN32
+
+} // namespace
+
+DistributedTrainer::DistributedTrainer(const DistributedConfig& config)
+    : config_(config) {
+    if (config_.num_workers == 0 || config_.sync_interval == 0) {
+        throw std::invalid_argument("Distributed training needs at least one worker and a non-zero sync interval");
+    }
+}
+
+bool DistributedTrainer::isSupported() {
+#ifdef _WIN32
+    return false;
+#else
+    return true;
+#endif
+}
+
+#ifdef _WIN32
+
+DistributedStats DistributedTrainer::run() {
+    throw std::runtime_error("Distributed training requires fork() and Unix-domain sockets");
+}
+
+void DistributedTrainer::runServer(const std::vector<int>&, DistributedStats&) {}
+
+#else
+
+DistributedStats DistributedTrainer::run() {
+    DistributedStats stats;
+    auto start = std::chrono::steady_clock::now();
+
+    global_table_.clear();
+    if (config_.algorithm == DistributedAlgorithm::DQN) {
+        DQNAgent initial(STATE_SIZE, ACTION_SIZE);
+        global_parameters_ = initial.getNetwork().getParameters();
+    }
+
+    std::cout << "Starting " << config_.num_workers << " worker processes ("
+              << (config_.algorithm == DistributedAlgorithm::DQN ? "DQN" : "Q-Learning") << ", "
+              << config_.episodes_per_worker << " episodes each, sync every "
+              << config_.sync_interval << " episodes)" << std::endl;
+    std::cout.flush(); // Children must not inherit buffered output
+
+    std::vector<int> sockets;
+    std::vector<pid_t> workers;
+    for (size_t w = 0; w < config_.num_workers; ++w) {
+        int pair[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+            throw std::runtime_error(std::string("socketpair failed: ") + std::strerror(errno));
+        }
+
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            throw std::runtime_error(std::string("fork failed: ") + std::strerror(errno));
+        }
+
+        if (pid == 0) {
+            // Worker: keep only its own end of its own socket
+            ::close(pair[0]);
+            for (int fd : sockets) {
+                ::close(fd);
+            }
+            std::cout.rdbuf(nullptr);
+
+            int status = 0;
+            try {
+                if (config_.algorithm == DistributedAlgorithm::DQN) {
+                    runDQNWorker(pair[1], w, config_);
+                } else {
+                    runQLearningWorker(pair[1], config_);
+                }
+                ByteWriter empty;
+                sendMessage(pair[1], MSG_DONE, empty);
+            } catch (const std::exception& e) {
+                std::cerr << "Worker " << w << " failed: " << e.what() << std::endl;
+                status = 1;
+            }
+            ::close(pair[1]);
+            ::_exit(status);
+        }
+
+        ::close(pair[1]);
+        sockets.push_back(pair[0]);
+        workers.push_back(pid);
+    }
+
+    runServer(sockets, stats);
+
+    bool all_succeeded = true;
+    for (pid_t pid : workers) {
+        int status = 0;
+        while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        all_succeeded = all_succeeded && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Distributed training finished in " << std::fixed << std::setprecision(2) << stats.seconds
+              << " s | Episodes: " << stats.episodes << " (" << std::setprecision(0)
+              << stats.episodes / stats.seconds << "/s) | Syncs: " << stats.syncs
+              << " | Received: " << std::setprecision(1) << stats.bytes_received / 1024.0 << " KB"
+              << " | Sent: " << stats.bytes_sent / 1024.0 << " KB" << std::endl;
+
+    if (!all_succeeded) {
+        throw std::runtime_error("One or more worker processes failed");
+    }
+    if (!config_.model_path.empty()) {
+        saveModel();
+    }
+    return stats;
+}
+
+void DistributedTrainer::runServer(const std::vector<int>& sockets, DistributedStats& stats) {
+    const size_t num_workers = sockets.size();
+    const bool dqn = config_.algorithm == DistributedAlgorithm::DQN;
+
+    ByteWriter writer;
+    std::vector<uint8_t> payload;
+    std::vector<RowUpdate> rows;
+    std::vector<float> delta(global_parameters_.size());
+
+    // Actions changed by other workers that each worker has not seen yet
+    std::vector<std::unordered_map<StateKey, uint8_t>> pending(num_workers);
+
+    if (dqn) {
+        writer.putFloats(global_parameters_.data(), global_parameters_.size());
+        for (int fd : sockets) {
+            stats.bytes_sent += sendMessage(fd, MSG_PARAMETERS, writer);
+        }
+    }
+
+    std::vector<pollfd> polls(num_workers);
+    for (size_t w = 0; w < num_workers; ++w) {
+        polls[w].fd = sockets[w];
+        polls[w].events = POLLIN;
+    }
+
+    size_t active = num_workers;
+    size_t window_episodes = 0;
+    double window_reward = 0.0;
+    const size_t total_episodes = config_.episodes_per_worker * num_workers;
+
+    while (active > 0) {
+        if (::poll(polls.data(), polls.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("poll failed: ") + std::strerror(errno));
+        }
+
+        for (size_t w = 0; w < num_workers; ++w) {
+            if (polls[w].fd < 0 || (polls[w].revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+                continue;
+            }
+
+            uint8_t type = 0;
+            if (!receiveMessage(polls[w].fd, type, payload) || type == MSG_DONE) {
+                // Finished (or died; the exit status is checked after the loop)
+                ::close(polls[w].fd);
+                polls[w].fd = -1;
+                active--;
+                continue;
+            }
+            if (type != MSG_DELTA) {
+                throw std::runtime_error("Unexpected message from worker " + std::to_string(w));
+            }
+            stats.bytes_received += payload.size() + 5;
+
+            ByteReader reader(payload.data(), payload.size());
+            size_t episodes = reader.getVarint();
+            double reward_sum = reader.getDouble();
+            stats.episodes += episodes;
+            window_episodes += episodes;
+            window_reward += reward_sum;
+
+            writer.clear();
+            if (dqn) {
+                // Average the workers' weight changes into the global network
+                decodeQuantized(reader, delta);
+                float weight = 1.0f / static_cast<float>(num_workers);
+                for (size_t i = 0; i < delta.size(); ++i) {
+                    global_parameters_[i] += weight * delta[i];
+                }
+                writer.putFloats(global_parameters_.data(), global_parameters_.size());
+            } else {
+                // Apply the row deltas and queue the rows for everyone else
+                decodeRows(reader, rows);
+                for (const RowUpdate& update : rows) {
+                    QTable::Row& global = global_table_.findOrInsert(update.key);
+                    for (int action = 0; action < QTable::NUM_ACTIONS; ++action) {
+                        global.q[action] += update.q[action];
+                    }
+                    for (size_t other = 0; other < num_workers; ++other) {
+                        if (other != w) {
+                            pending[other][update.key] |= update.mask;
+                        }
+                    }
+                }
+
+                rows.clear();
+                for (const auto& [key, mask] : pending[w]) {
+                    RowUpdate update{key, mask, {0.0, 0.0, 0.0, 0.0}};
+                    const QTable::Row* global = global_table_.find(key);
+                    std::copy(global->q, global->q + QTable::NUM_ACTIONS, update.q);
+                    rows.push_back(update);
+                }
+                pending[w].clear();
+                encodeRows(writer, rows);
+            }
+            stats.bytes_sent += sendMessage(polls[w].fd, MSG_UPDATE, writer);
+            stats.syncs++;
+
+            if (stats.syncs % num_workers == 0 && window_episodes > 0) {
+                std::cout << "Sync " << stats.syncs
+                          << " | Episodes: " << stats.episodes << "/" << total_episodes
+                          << " | Avg Reward: " << std::fixed << std::setprecision(2) << window_reward / window_episodes;
+                if (dqn) {
+                    std::cout << " | Parameters: " << global_parameters_.size();
+                } else {
+                    std::cout << " | Q-table size: " << global_table_.size();
+                }
+                std::cout << " | Traffic: " << std::setprecision(1) << stats.bytes_received / 1024.0 << " KB in, "
+                          << stats.bytes_sent / 1024.0 << " KB out" << std::endl;
+                window_episodes = 0;
+                window_reward = 0.0;
+            }
+        }
+    }
+}
+
+#endif // _WIN32
+
+void DistributedTrainer::saveModel() const {
+    if (config_.algorithm == DistributedAlgorithm::DQN) {
+        DQNAgent agent(STATE_SIZE, ACTION_SIZE);
+        agent.getNetwork().getParameters() = global_parameters_;
+        agent.syncTargetNetwork();
+        agent.save(config_.model_path);
+    } else {
+        QLearningAgent agent(Q_LEARNING_RATE, Q_DISCOUNT, Q_EPSILON);
+        QTable& table = agent.getQTable();
+        global_table_.forEach([&table](StateKey key, const QTable::Row& row) {
+            table.findOrInsert(key) = row;
+        });
+        agent.save(config_.model_path);
+    }
+}
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,351 @@
+#include "rl/dqn_agent.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+namespace SnakeGame::RL {
+
+namespace {
+
+std::vector<size_t> buildLayerSizes(size_t state_size, size_t action_size,
+                                    const std::vector<size_t>& hidden_layers) {
+    std::vector<size_t> sizes;
+    sizes.push_back(state_size);
+    sizes.insert(sizes.end(), hidden_layers.begin(), hidden_layers.end());
+    sizes.push_back(action_size);
+    return sizes;
+}
+
+} // namespace
+
+DQNAgent::DQNAgent(size_t state_size, size_t action_size, const DQNConfig& config)
+    : state_size_(state_size)
+    , action_size_(action_size)
+    , config_(config)
+    , epsilon_(config.epsilon)
+    , online_network_(buildLayerSizes(state_size, action_size, config.hidden_layers), config.seed)
+    , target_network_(buildLayerSizes(state_size, action_size, config.hidden_layers), config.seed)
+    , replay_buffer_(config.replay_capacity, state_size,
+                     config.prioritized_replay ? SamplingMode::PRIORITIZED : SamplingMode::UNIFORM)
+    , state_scratch_(state_size)
+    , next_state_scratch_(state_size)
+    , output_grad_(config.batch_size * action_size)
+    , targets_(config.batch_size)
+    , td_errors_(config.batch_size)
+    , gen_(config.seed)
+    , uniform_dist_(0.0, 1.0)
+    , action_dist_(0, static_cast<int>(action_size) - 1)
+    , env_steps_(0)
+    , gradient_steps_(0)
+    , last_loss_(0.0) {
+    replay_buffer_.setSeed(config.seed);
+    batch_.resize(config.batch_size, state_size);
+}
+
+int DQNAgent::selectAction(const std::vector<double>& state) {
+    if (state.size() != state_size_) {
+        throw std::invalid_argument("State size does not match the DQN input size");
+    }
+    if (uniform_dist_(gen_) < epsilon_) {
+        return action_dist_(gen_);
+    }
+
+    std::copy(state.begin(), state.end(), state_scratch_.begin());
+    const float* q_values = online_network_.forward(state_scratch_.data(), 1);
+    return greedyAction(q_values);
+}
+
+void DQNAgent::selectActions(const StateBatch& states, std::vector<int>& actions) {
+    if (states.state_size != state_size_) {
+        throw std::invalid_argument("State size does not match the DQN input size");
+    }
+    const size_t batch_size = states.size();
+    actions.resize(batch_size);
+    batch_scratch_.resize(states.data.size());
+    std::copy(states.data.begin(), states.data.end(), batch_scratch_.begin());
+    selectActions(batch_scratch_.data(), batch_size, actions.data());
+}
+
+void DQNAgent::update(const std::vector<double>& state, int action,
+                      double reward, const std::vector<double>& next_state, bool done) {
+    if (state.size() != state_size_ || next_state.size() != state_size_) {
+        throw std::invalid_argument("State size does not match the DQN input size");
+    }
+    std::copy(state.begin(), state.end(), state_scratch_.begin());
+    std::copy(next_state.begin(), next_state.end(), next_state_scratch_.begin());
+    replay_buffer_.add(state_scratch_.data(), action, static_cast<float>(reward),
+                       next_state_scratch_.data(), done);
+    env_steps_++;
+
+    if (replay_buffer_.size() >= std::max(config_.min_replay_size, config_.batch_size) &&
+        env_steps_ % config_.train_interval == 0) {
+        trainStep();
+    }
+}
+
+void DQNAgent::train(Environment& env, size_t episodes) {
+    std::vector<Environment*> envs = {&env};
+    trainVectorized(envs, episodes);
+}
+
+void DQNAgent::evaluate(Environment& env, size_t episodes) {
+    std::cout << "Evaluating DQN agent for " << episodes << " episodes..." << std::endl;
+
+    double old_epsilon = epsilon_;
+    epsilon_ = 0.0; // No exploration during evaluation
+
+    double total_reward = 0.0, total_length = 0.0;
+    for (size_t episode = 0; episode < episodes; ++episode) {
+        auto state = env.reset();
+        double episode_reward = 0.0;
+        size_t steps = 0;
+
+        while (!env.isDone()) {
+            int action = selectAction(state);
+            auto [next_state, reward] = env.step(action);
+
+            state = next_state;
+            episode_reward += reward;
+            steps++;
+        }
+
+        total_reward += episode_reward;
+        total_length += static_cast<double>(steps);
+
+        std::cout << "Eval Episode " << episode + 1
+                 << " | Reward: " << episode_reward
+                 << " | Length: " << steps << std::endl;
+    }
+
+    std::cout << "Evaluation completed!" << std::endl;
+    std::cout << "Average Reward: " << total_reward / episodes << std::endl;
+    std::cout << "Average Length: " << total_length / episodes << std::endl;
+
+    epsilon_ = old_epsilon; // Restore epsilon
+}
+
+void DQNAgent::save(const std::string& filepath) {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file for saving: " + filepath);
+    }
+
+    // Save hyperparameters
+    file << config_.learning_rate << " " << config_.discount_factor << " " << epsilon_ << " "
+         << config_.epsilon_decay << " " << config_.min_epsilon << std::endl;
+
+    // Save network weights
+    online_network_.save(file);
+
+    std::cout << "DQN agent saved to: " << filepath << std::endl;
+}
+
+void DQNAgent::load(const std::string& filepath) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file for loading: " + filepath);
+    }
+
+    // Load hyperparameters
+    file >> config_.learning_rate >> config_.discount_factor >> epsilon_
+         >> config_.epsilon_decay >> config_.min_epsilon;
+
+    // Load network weights
+    online_network_.load(file);
+    syncTargetNetwork();
+
+    std::cout << "DQN agent loaded from: " << filepath << std::endl;
+    std::cout << "Network parameters: " << online_network_.getParameterCount() << std::endl;
+}
+
+void DQNAgent::setLearningRate(double lr) {
+    config_.learning_rate = lr;
+}
+
+void DQNAgent::setEpsilon(double epsilon) {
+    epsilon_ = epsilon;
+}
+
+void DQNAgent::setDiscountFactor(double gamma) {
+    config_.discount_factor = gamma;
+}
+
+std::unique_ptr<Agent> DQNAgent::clone() const {
+    auto copy = std::make_unique<DQNAgent>(state_size_, action_size_, config_);
+    copy->copyFrom(*this);
+    return copy;
+}
+
+void DQNAgent::copyFrom(const Agent& other) {
+    const auto* source = dynamic_cast<const DQNAgent*>(&other);
+    if (!source) {
+        throw std::invalid_argument("Cannot copy a different agent type into a DQNAgent");
+    }
+    copyFrom(*source);
+}
+
+void DQNAgent::copyFrom(const DQNAgent& other) {
+    online_network_.copyParametersFrom(other.online_network_);
+    target_network_.copyParametersFrom(other.target_network_);
+    config_.learning_rate = other.config_.learning_rate;
+    config_.discount_factor = other.config_.discount_factor;
+    config_.epsilon_decay = other.config_.epsilon_decay;
+    config_.min_epsilon = other.config_.min_epsilon;
+    epsilon_ = other.epsilon_;
+}
+
+void DQNAgent::setSeed(unsigned int seed) {
+    gen_.seed(seed);
+    uniform_dist_.reset();
+    action_dist_.reset();
+    replay_buffer_.setSeed(seed);
+}
+
+void DQNAgent::selectActions(const float* states, size_t batch_size, int* actions) {
+    const float* q_values = online_network_.forward(states, batch_size);
+
+    for (size_t i = 0; i < batch_size; ++i) {
+        if (uniform_dist_(gen_) < epsilon_) {
+            actions[i] = action_dist_(gen_);
+        } else {
+            actions[i] = greedyAction(q_values + i * action_size_);
+        }
+    }
+}
+
+void DQNAgent::trainVectorized(std::vector<Environment*>& envs, size_t episodes) {
+    std::cout << "Training DQN agent for " << episodes << " episodes across "
+              << envs.size() << " environment(s) [" << MLP::simdBackend() << "]..." << std::endl;
+
+    const size_t num_envs = envs.size();
+    std::vector<std::vector<double>> states(num_envs);
+    std::vector<float> state_batch(num_envs * state_size_);
+    std::vector<int> actions(num_envs);
+    std::vector<double> episode_rewards(num_envs, 0.0);
+    std::vector<size_t> episode_lengths(num_envs, 0);
+
+    for (size_t e = 0; e < num_envs; ++e) {
+        states[e] = envs[e]->reset();
+    }
+
+    size_t finished = 0;
+    double window_reward = 0.0;
+    double window_length = 0.0;
+    size_t window_count = 0;
+
+    while (finished < episodes) {
+        // One batched forward pass picks actions for every environment
+        for (size_t e = 0; e < num_envs; ++e) {
+            std::copy(states[e].begin(), states[e].end(), state_batch.begin() + e * state_size_);
+        }
+        selectActions(state_batch.data(), num_envs, actions.data());
+
+        for (size_t e = 0; e < num_envs && finished < episodes; ++e) {
+            auto [next_state, reward] = envs[e]->step(actions[e]);
+            bool done = envs[e]->isDone();
+
+            update(states[e], actions[e], reward, next_state, done);
+
+            states[e] = std::move(next_state);
+            episode_rewards[e] += reward;
+            episode_lengths[e]++;
+
+            if (!done) {
+                continue;
+            }
+
+            window_reward += episode_rewards[e];
+            window_length += static_cast<double>(episode_lengths[e]);
+            window_count++;
+            finished++;
+            decayEpsilon();
+
+            // Print progress
+            if (finished % 100 == 0) {
+                std::cout << "Episode " << finished
+                         << " | Avg Reward: " << std::fixed << std::setprecision(2) << window_reward / window_count
+                         << " | Avg Length: " << std::fixed << std::setprecision(1) << window_length / window_count
+                         << " | Epsilon: " << std::fixed << std::setprecision(3) << epsilon_
+                         << " | Loss: " << std::fixed << std::setprecision(4) << last_loss_
+                         << " | Replay: " << replay_buffer_.size() << std::endl;
+                window_reward = window_length = 0.0;
+                window_count = 0;
+            }
+
+            states[e] = envs[e]->reset();
+            episode_rewards[e] = 0.0;
+            episode_lengths[e] = 0;
+        }
+    }
+
+    std::cout << "Training completed! Environment steps: " << env_steps_
+              << ", gradient steps: " << gradient_steps_ << std::endl;
+}
+
+double DQNAgent::trainStep() {
+    const size_t batch_size = config_.batch_size;
+    replay_buffer_.sample(batch_size, batch_, 0.4);
+
+    // Bootstrapped targets from the frozen target network
+    const float* next_q = target_network_.forward(batch_.next_states.data(), batch_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+        const float* row = next_q + i * action_size_;
+        float max_next = *std::max_element(row, row + action_size_);
+        float bootstrap = batch_.dones[i] ? 0.0f : static_cast<float>(config_.discount_factor) * max_next;
+        targets_[i] = batch_.rewards[i] + bootstrap;
+    }
+
+    // Huber loss on the taken action only
+    const float* q_values = online_network_.forward(batch_.states.data(), batch_size);
+    std::fill(output_grad_.begin(), output_grad_.end(), 0.0f);
+    double loss = 0.0;
+    float scale = 1.0f / static_cast<float>(batch_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+        size_t idx = i * action_size_ + static_cast<size_t>(batch_.actions[i]);
+        float td = q_values[idx] - targets_[i];
+        float abs_td = std::abs(td);
+        loss += batch_.weights[i] * (abs_td <= 1.0f ? 0.5f * td * td : abs_td - 0.5f);
+        output_grad_[idx] = batch_.weights[i] * std::clamp(td, -1.0f, 1.0f) * scale;
+        td_errors_[i] = td;
+    }
+
+    online_network_.zeroGradients();
+    online_network_.backward(output_grad_.data(), batch_size);
+    online_network_.clipGradientNorm(10.0f);
+    online_network_.adamStep(static_cast<float>(config_.learning_rate));
+
+    replay_buffer_.updatePriorities(batch_, td_errors_.data());
+
+    gradient_steps_++;
+    if (gradient_steps_ % config_.target_update_interval == 0) {
+        syncTargetNetwork();
+    }
+
+    last_loss_ = loss / batch_size;
+    return last_loss_;
+}
+
+void DQNAgent::syncTargetNetwork() {
+    target_network_.copyParametersFrom(online_network_);
+}
+
+MLP& DQNAgent::getNetwork() {
+    return online_network_;
+}
+
+const MLP& DQNAgent::getNetwork() const {
+    return online_network_;
+}
+
+int DQNAgent::greedyAction(const float* q_values) const {
+    return static_cast<int>(std::max_element(q_values, q_values + action_size_) - q_values);
+}
+
+void DQNAgent::decayEpsilon() {
+    epsilon_ = std::max(config_.min_epsilon, epsilon_ * config_.epsilon_decay);
+}
+
+} // namespace SnakeGame::RL
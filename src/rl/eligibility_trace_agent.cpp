@@ -0,0 +1,188 @@
+#include "rl/eligibility_trace_agent.h"
+#include <stdexcept>
+
+namespace SnakeGame::RL {
+
+namespace {
+
+constexpr size_t DEFAULT_MAX_TRACES = 64;
+constexpr double DEFAULT_TRACE_THRESHOLD = 0.01;
+
+} // namespace
+
+EligibilityTraceAgent::EligibilityTraceAgent(double learning_rate, double discount_factor, double epsilon,
+                                             double lambda, TraceMode mode)
+    : QLearningAgent(learning_rate, discount_factor, epsilon)
+    , lambda_(lambda)
+    , mode_(mode)
+    , max_traces_(DEFAULT_MAX_TRACES)
+    , trace_threshold_(DEFAULT_TRACE_THRESHOLD)
+    , has_cached_action_(false)
+    , cached_key_(0)
+    , cached_action_(0) {
+    setLambda(lambda);
+    trace_keys_.reserve(max_traces_ + 1);
+    trace_actions_.reserve(max_traces_ + 1);
+    traces_.reserve(max_traces_ + 1);
+}
+
+std::unique_ptr<Agent> EligibilityTraceAgent::clone() const {
+    auto copy = std::make_unique<EligibilityTraceAgent>(learning_rate_, discount_factor_, epsilon_, lambda_, mode_);
+    copy->copyFrom(*this);
+    return copy;
+}
+
+void EligibilityTraceAgent::copyFrom(const Agent& other) {
+    const auto* source = dynamic_cast<const EligibilityTraceAgent*>(&other);
+    if (!source) {
+        throw std::invalid_argument("Cannot copy a different agent type into an EligibilityTraceAgent");
+    }
+    QLearningAgent::copyFrom(*source);
+    lambda_ = source->lambda_;
+    mode_ = source->mode_;
+    setTraceLimit(source->max_traces_);
+    trace_threshold_ = source->trace_threshold_;
+    clearTraces();
+}
+
+int EligibilityTraceAgent::selectAction(const std::vector<double>& state) {
+    // SARSA already committed to this step's action when it computed its target
+    if (mode_ == TraceMode::SARSA && has_cached_action_) {
+        has_cached_action_ = false;
+        CanonicalState canonical = encodeState(state);
+        if (canonical.key == cached_key_) {
+            return StateSymmetry::fromCanonicalAction(cached_action_, canonical.transform);
+        }
+    }
+
+    size_t explored = exploration_steps_;
+    int action = QLearningAgent::selectAction(state);
+
+    // Watkins: the traced path stops being greedy once a non-greedy action is taken
+    if (mode_ == TraceMode::WATKINS_Q && exploration_steps_ != explored && !traces_.empty()) {
+        CanonicalState canonical = encodeState(state);
+        if (!isGreedyAction(canonical.key, StateSymmetry::toCanonicalAction(action, canonical.transform))) {
+            clearTraces();
+        }
+    }
+    return action;
+}
+
+void EligibilityTraceAgent::update(const std::vector<double>& state, int action,
+                                   double reward, const std::vector<double>& next_state, bool done) {
+    CanonicalState canonical = encodeState(state);
+    int canonical_action = StateSymmetry::toCanonicalAction(action, canonical.transform);
+
+    double next_value = 0.0;
+    if (!done) {
+        CanonicalState next = encodeState(next_state);
+        if (mode_ == TraceMode::SARSA) {
+            int next_action = QLearningAgent::selectAction(next_state);
+            cached_key_ = next.key;
+            cached_action_ = StateSymmetry::toCanonicalAction(next_action, next.transform);
+            has_cached_action_ = true;
+            next_value = lookupQValue(cached_key_, cached_action_);
+        } else {
+            next_value = getMaxQValue(next.key);
+        }
+    }
+
+    double td_error = reward + discount_factor_ * next_value - lookupQValue(canonical.key, canonical_action);
+    markVisited(canonical.key, canonical_action);
+    applyTraces(td_error);
+
+    if (done) {
+        clearTraces();
+        has_cached_action_ = false;
+    }
+}
+
+void EligibilityTraceAgent::setLambda(double lambda) {
+    if (lambda < 0.0 || lambda > 1.0) {
+        throw std::invalid_argument("Trace decay lambda must be in [0, 1]");
+    }
+    lambda_ = lambda;
+}
+
+void EligibilityTraceAgent::setTraceLimit(size_t max_traces) {
+    if (max_traces == 0) {
+        throw std::invalid_argument("Trace limit must be positive");
+    }
+    max_traces_ = max_traces;
+    trace_keys_.reserve(max_traces_ + 1);
+    trace_actions_.reserve(max_traces_ + 1);
+    traces_.reserve(max_traces_ + 1);
+}
+
+void EligibilityTraceAgent::setTraceThreshold(double threshold) {
+    trace_threshold_ = threshold;
+}
+
+size_t EligibilityTraceAgent::getActiveTraces() const {
+    return traces_.size();
+}
+
+TraceMode EligibilityTraceAgent::getTraceMode() const {
+    return mode_;
+}
+
+double EligibilityTraceAgent::lookupQValue(StateKey state, int action) const {
+    QTable::Row scratch;
+    const QTable::Row* row = findRow(state, scratch);
+    return row ? row->q[action] : 0.0;
+}
+
+bool EligibilityTraceAgent::isGreedyAction(StateKey state, int action) const {
+    QTable::Row scratch;
+    const QTable::Row* row = findRow(state, scratch);
+    return !row || row->q[action] >= QTable::max(*row);
+}
+
+void EligibilityTraceAgent::markVisited(StateKey state, int action) {
+    // Replacing traces: a revisited state forgets its older traces, and the
+    // fresh entry goes to the back so the list stays ordered by age
+    for (size_t i = 0; i < trace_keys_.size(); ++i) {
+        if (trace_keys_[i] == state) {
+            traces_[i] = 0.0;
+        }
+    }
+    trace_keys_.push_back(state);
+    trace_actions_.push_back(static_cast<uint8_t>(action));
+    traces_.push_back(1.0);
+}
+
+void EligibilityTraceAgent::applyTraces(double td_error) {
+    const double step = learning_rate_ * td_error;
+    const double decay = discount_factor_ * lambda_;
+    const size_t count = traces_.size();
+
+    // Apply, decay and compact in one pass; entries past the limit are the oldest
+    size_t kept = 0;
+    for (size_t i = (count > max_traces_) ? count - max_traces_ : 0; i < count; ++i) {
+        double trace = traces_[i];
+        if (trace == 0.0) {
+            continue;
+        }
+        addToQValue(trace_keys_[i], trace_actions_[i], step * trace);
+
+        trace *= decay;
+        if (trace >= trace_threshold_) {
+            trace_keys_[kept] = trace_keys_[i];
+            trace_actions_[kept] = trace_actions_[i];
+            traces_[kept] = trace;
+            kept++;
+        }
+    }
+
+    trace_keys_.resize(kept);
+    trace_actions_.resize(kept);
+    traces_.resize(kept);
+}
+
+void EligibilityTraceAgent::clearTraces() {
+    trace_keys_.clear();
+    trace_actions_.clear();
+    traces_.clear();
+}
+
+} // namespace SnakeGame::RL
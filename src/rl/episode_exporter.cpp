@@ -0,0 +1,145 @@
+#include "rl/episode_exporter.h"
+#include "rl/gif_encoder.h"
+#include "rl/pixel_renderer.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+namespace SnakeGame::RL {
+
+namespace {
+
+std::string numbered(const std::string& base, size_t number, int digits) {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), "_%0*zu", digits, number);
+    return base + suffix;
+}
+
+size_t writePpm(const std::string& path, const uint8_t* rgb, size_t width, size_t height) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file for saving: " + path);
+    }
+    std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    file << header;
+    file.write(reinterpret_cast<const char*>(rgb), static_cast<std::streamsize>(width * height * 3));
+    if (!file) {
+        throw std::runtime_error("Failed to write " + path);
+    }
+    return header.size() + width * height * 3;
+}
+
+} // namespace
+
+EpisodeExporter::EpisodeExporter(const ExportConfig& config)
+    : config_(config)
+    , pool_(config.num_threads) {
+    if (config_.cell_pixels == 0 || config_.frame_skip == 0) {
+        throw std::invalid_argument("Export needs positive cell size and frame skip");
+    }
+}
+
+std::vector<EpisodeRecording> EpisodeExporter::record(const AgentFactory& make_agent, size_t episodes,
+                                                      uint64_t seed, size_t max_steps) {
+    // One greedy agent and environment per worker, as in EvaluationEngine
+    std::vector<std::unique_ptr<Agent>> agents(pool_.size());
+    std::vector<std::unique_ptr<SnakeEnvironment>> environments(pool_.size());
+    pool_.runOnAll([&](size_t worker) {
+        agents[worker] = make_agent();
+        agents[worker]->setEpsilon(0.0);
+        environments[worker] = std::make_unique<SnakeEnvironment>(true);
+        environments[worker]->setMaxSteps(max_steps);
+    });
+
+    std::vector<EpisodeRecording> recordings(episodes);
+    pool_.parallelFor(episodes, [&](size_t episode, size_t worker) {
+        Agent& agent = *agents[worker];
+        SnakeEnvironment& env = *environments[worker];
+        uint64_t episode_seed = EvaluationEngine::episodeSeed(seed, episode);
+
+        EpisodeRecording& recording = recordings[episode];
+        recording.max_steps = max_steps;
+        env.setSeed(static_cast<unsigned int>(episode_seed));
+        agent.setSeed(static_cast<unsigned int>(episode_seed >> 32));
+        auto state = env.reset();
+        recording.seed = env.getEpisodeSeed(); // The game seed, as a TrajectoryWriter would log it
+        recording.initial_state.assign(state.begin(), state.end());
+        while (!env.isDone()) {
+            int action = agent.selectAction(state);
+            recording.actions.push_back(static_cast<uint8_t>(action));
+            state = env.step(action).first;
+        }
+        std::vector<double> info = env.getInfo();
+        recording.score = info.empty() ? 0.0 : info[0];
+    });
+    return recordings;
+}
+
+std::vector<ExportResult> EpisodeExporter::exportEpisodes(const std::vector<EpisodeRecording>& recordings) {
+    // Longest episode first, so a long one never starts last
+    std::vector<size_t> order(recordings.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        size_t length_a = recordings[a].actions.size(), length_b = recordings[b].actions.size();
+        return length_a != length_b ? length_a > length_b : a < b;
+    });
+
+    std::vector<ExportResult> results(recordings.size());
+    pool_.parallelFor(order.size(), [&](size_t index, size_t) {
+        results[order[index]] = exportEpisode(recordings[order[index]], order[index]);
+    });
+    return results;
+}
+
+ExportResult EpisodeExporter::exportEpisode(const EpisodeRecording& recording, size_t index) const {
+    TrajectoryReplayer replayer(recording);
+
+    const bool gif = config_.format == ExportFormat::GIF;
+    PixelConfig pixels;
+    pixels.width = GameConfig::GRID_SIZE_X * config_.cell_pixels;
+    pixels.height = GameConfig::GRID_SIZE_Y * config_.cell_pixels;
+    pixels.format = gif ? PixelFormat::PALETTE : PixelFormat::RGB;
+    PixelRenderer renderer(pixels);
+    std::optional<GifEncoder> encoder;
+    if (gif) {
+        encoder.emplace(pixels.width, pixels.height, PixelRenderer::palette());
+    }
+
+    const std::string base = config_.directory + "/" + numbered(config_.prefix, index, 4);
+    ExportResult result;
+    result.path = gif ? base + ".gif" : numbered(base, 0, 5) + ".ppm";
+    result.steps = recording.actions.size();
+    result.score = recording.score;
+
+    auto keepFrame = [&](bool last) {
+        const uint8_t* frame = renderer.render(replayer.getGame());
+        if (encoder) {
+            encoder->addFrame(frame, config_.frame_delay_cs + (last ? config_.final_delay_cs : 0));
+        } else {
+            result.bytes += writePpm(numbered(base, result.frames, 5) + ".ppm", frame, pixels.width, pixels.height);
+        }
+        result.frames++;
+    };
+
+    keepFrame(recording.actions.empty());
+    for (size_t step = 0; step < recording.actions.size(); ++step) {
+        replayer.advance();
+        bool last = step + 1 == recording.actions.size();
+        if (last || (step + 1) % config_.frame_skip == 0) {
+            keepFrame(last);
+        }
+    }
+
+    if (encoder) {
+        encoder->save(result.path);
+        result.bytes = encoder->size();
+    }
+    return result;
+}
+
+} // namespace SnakeGame::RL
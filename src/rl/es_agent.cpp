@@ -0,0 +1,340 @@
+#include "rl/es_agent.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace SnakeGame::RL {
+
+namespace {
+
+constexpr double ADAM_BETA1 = 0.9;
+constexpr double ADAM_BETA2 = 0.999;
+constexpr double ADAM_EPSILON = 1e-8;
+constexpr size_t BLOCKS_PER_WORKER = 4;
+
+std::vector<size_t> buildLayerSizes(size_t state_size, size_t action_size,
+                                    const std::vector<size_t>& hidden_layers) {
+    std::vector<size_t> sizes;
+    sizes.push_back(state_size);
+    sizes.insert(sizes.end(), hidden_layers.begin(), hidden_layers.end());
+    sizes.push_back(action_size);
+    return sizes;
+}
+
+} // namespace
+
+// NoiseTable implementation
+NoiseTable::NoiseTable(size_t size, uint64_t seed) : noise_(size) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    for (float& value : noise_) {
+        value = dist(rng);
+    }
+}
+
+const float* NoiseTable::at(size_t offset) const {
+    return noise_.data() + offset;
+}
+
+size_t NoiseTable::size() const {
+    return noise_.size();
+}
+
+size_t NoiseTable::sampleOffset(uint64_t key, size_t dim) const {
+    return static_cast<size_t>(key % (noise_.size() - dim + 1));
+}
+
+// ESAgent implementation
+ESAgent::ESAgent(size_t state_size, size_t action_size, const ESConfig& config)
+    : ESAgent(state_size, action_size, config, nullptr) {
+}
+
+ESAgent::ESAgent(size_t state_size, size_t action_size, const ESConfig& config,
+                 std::shared_ptr<const NoiseTable> noise)
+    : state_size_(state_size)
+    , action_size_(action_size)
+    , config_(config)
+    , policy_(buildLayerSizes(state_size, action_size, config.hidden_layers), static_cast<unsigned int>(config.seed))
+    , adam_m_(policy_.getParameterCount(), 0.0f)
+    , adam_v_(policy_.getParameterCount(), 0.0f)
+    , generation_(0)
+    , noise_(std::move(noise))
+    , gradient_(policy_.getParameterCount(), 0.0f)
+    , state_scratch_(state_size) {
+    if (config_.noise_table_size <= policy_.getParameterCount()) {
+        throw std::invalid_argument("ES noise table must be larger than the policy");
+    }
+    if (!noise_) {
+        noise_ = std::make_shared<NoiseTable>(config_.noise_table_size, config_.seed);
+    }
+
+    const size_t max_steps = config_.max_steps;
+    make_environment_ = [max_steps]() {
+        auto env = std::make_unique<SnakeEnvironment>(true);
+        env->setMaxSteps(max_steps);
+        env->setRewardStructure(10.0, -100.0, -1.0);
+        return env;
+    };
+}
+
+int ESAgent::selectAction(const std::vector<double>& state) {
+    if (state.size() != state_size_) {
+        throw std::invalid_argument("State size does not match the ES policy input size");
+    }
+    std::copy(state.begin(), state.end(), state_scratch_.begin());
+    return greedyAction(policy_.forward(state_scratch_.data(), 1), action_size_);
+}
+
+void ESAgent::train(Environment& /*env*/, size_t episodes) {
+    std::cout << "Training ES agent (" << policy_.getParameterCount() << " parameters, population "
+              << config_.population << ") for " << episodes << " episodes..." << std::endl;
+
+    size_t played = 0;
+    while (played < episodes) {
+        ESGenerationStats stats = runGeneration();
+        played += stats.episodes;
+        std::cout << "Generation " << stats.generation
+                  << " | Mean Reward: " << std::fixed << std::setprecision(2) << stats.mean_reward
+                  << " | Max Reward: " << stats.max_reward
+                  << " | Mean Score: " << stats.mean_score
+                  << " | Episodes/s: " << std::setprecision(0) << stats.episodes_per_second << std::endl;
+    }
+    std::cout << "Training completed!" << std::endl;
+}
+
+void ESAgent::evaluate(Environment& env, size_t episodes) {
+    std::cout << "Evaluating ES agent for " << episodes << " episodes..." << std::endl;
+
+    double total_reward = 0.0, total_length = 0.0;
+    for (size_t episode = 0; episode < episodes; ++episode) {
+        auto state = env.reset();
+        double episode_reward = 0.0;
+        size_t steps = 0;
+
+        while (!env.isDone()) {
+            auto [next_state, reward] = env.step(selectAction(state));
+            state = std::move(next_state);
+            episode_reward += reward;
+            steps++;
+        }
+
+        total_reward += episode_reward;
+        total_length += static_cast<double>(steps);
+    }
+
+    std::cout << "Evaluation completed!" << std::endl;
+    std::cout << "Average Reward: " << total_reward / episodes << std::endl;
+    std::cout << "Average Length: " << total_length / episodes << std::endl;
+}
+
+void ESAgent::save(const std::string& filepath) {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file for saving: " + filepath);
+    }
+
+    // Save hyperparameters
+    file << config_.learning_rate << " " << config_.sigma << " " << config_.weight_decay << " "
+         << generation_ << std::endl;
+
+    // Save policy weights
+    policy_.save(file);
+
+    std::cout << "ES agent saved to: " << filepath << std::endl;
+}
+
+void ESAgent::load(const std::string& filepath) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file for loading: " + filepath);
+    }
+
+    // Load hyperparameters
+    file >> config_.learning_rate >> config_.sigma >> config_.weight_decay >> generation_;
+
+    // Load policy weights (the optimizer restarts from zero moments)
+    policy_.load(file);
+    std::fill(adam_m_.begin(), adam_m_.end(), 0.0f);
+    std::fill(adam_v_.begin(), adam_v_.end(), 0.0f);
+
+    std::cout << "ES agent loaded from: " << filepath << std::endl;
+    std::cout << "Policy parameters: " << policy_.getParameterCount() << std::endl;
+}
+
+void ESAgent::setLearningRate(double lr) {
+    config_.learning_rate = lr;
+}
+
+void ESAgent::setSeed(unsigned int seed) {
+    config_.seed = seed;
+}
+
+std::unique_ptr<Agent> ESAgent::clone() const {
+    std::unique_ptr<ESAgent> copy(new ESAgent(state_size_, action_size_, config_, noise_));
+    copy->policy_.copyParametersFrom(policy_);
+    copy->adam_m_ = adam_m_;
+    copy->adam_v_ = adam_v_;
+    copy->generation_ = generation_;
+    copy->make_environment_ = make_environment_;
+    return copy;
+}
+
+void ESAgent::setEnvironmentFactory(EnvironmentFactory factory) {
+    make_environment_ = std::move(factory);
+    worker_environments_.clear();
+}
+
+ESGenerationStats ESAgent::runGeneration() {
+    auto start = std::chrono::steady_clock::now();
+    prepareWorkers();
+
+    const size_t pairs = std::max<size_t>(1, config_.population / 2);
+    const size_t dim = policy_.getParameterCount();
+    const float sigma = static_cast<float>(config_.sigma);
+    const float* theta = policy_.getParameters().data();
+    offsets_.resize(pairs);
+    returns_.resize(2 * pairs);
+    scores_.resize(2 * pairs);
+    steps_.resize(2 * pairs);
+
+    // Workers play both signs of one perturbation; only returns come back
+    const uint64_t generation_key = EvaluationEngine::episodeSeed(config_.seed, generation_);
+    pool_->parallelFor(pairs, [&](size_t pair, size_t worker) {
+        uint64_t key = EvaluationEngine::episodeSeed(generation_key, pair);
+        size_t offset = noise_->sampleOffset(key, dim);
+        offsets_[pair] = offset;
+        const float* eps = noise_->at(offset);
+        MLP& policy = worker_policies_[worker];
+        float* params = policy.getParameters().data();
+        for (size_t side = 0; side < 2; ++side) {
+            const float scale = side == 0 ? sigma : -sigma;
+            for (size_t j = 0; j < dim; ++j) {
+                params[j] = theta[j] + scale * eps[j];
+            }
+            size_t slot = 2 * pair + side;
+            returns_[slot] = playEpisode(policy, *worker_environments_[worker], worker_states_[worker],
+                                         static_cast<unsigned int>(key >> 32), scores_[slot], steps_[slot]);
+        }
+    });
+
+    // Centered ranks in [-0.5, 0.5]; tied returns share their average rank
+    std::vector<size_t> order(returns_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return returns_[a] != returns_[b] ? returns_[a] < returns_[b] : a < b;
+    });
+    std::vector<float> ranks(returns_.size());
+    const double denominator = std::max<double>(1.0, static_cast<double>(returns_.size() - 1));
+    for (size_t first = 0; first < order.size();) {
+        size_t last = first;
+        while (last + 1 < order.size() && returns_[order[last + 1]] == returns_[order[first]]) {
+            last++;
+        }
+        float rank = static_cast<float>((first + last) / 2.0 / denominator - 0.5);
+        for (size_t i = first; i <= last; ++i) {
+            ranks[order[i]] = rank;
+        }
+        first = last + 1;
+    }
+    weights_.resize(pairs);
+    for (size_t pair = 0; pair < pairs; ++pair) {
+        weights_[pair] = ranks[2 * pair] - ranks[2 * pair + 1];
+    }
+
+    // Gradient and Adam step, in parallel over blocks of parameters
+    generation_++;
+    const double lr = config_.learning_rate * std::sqrt(1.0 - std::pow(ADAM_BETA2, generation_)) /
+                      (1.0 - std::pow(ADAM_BETA1, generation_));
+    const size_t blocks = std::min(dim, pool_->size() * BLOCKS_PER_WORKER);
+    float* parameters = policy_.getParameters().data();
+    pool_->parallelFor(blocks, [&](size_t block, size_t) {
+        size_t begin = dim * block / blocks;
+        size_t end = dim * (block + 1) / blocks;
+        std::fill(gradient_.begin() + begin, gradient_.begin() + end, 0.0f);
+        for (size_t pair = 0; pair < pairs; ++pair) {
+            const float weight = weights_[pair];
+            const float* eps = noise_->at(offsets_[pair]);
+            for (size_t j = begin; j < end; ++j) {
+                gradient_[j] += weight * eps[j];
+            }
+        }
+        for (size_t j = begin; j < end; ++j) {
+            double g = gradient_[j] / (pairs * config_.sigma) - config_.weight_decay * parameters[j];
+            adam_m_[j] = static_cast<float>(ADAM_BETA1 * adam_m_[j] + (1.0 - ADAM_BETA1) * g);
+            adam_v_[j] = static_cast<float>(ADAM_BETA2 * adam_v_[j] + (1.0 - ADAM_BETA2) * g * g);
+            parameters[j] += static_cast<float>(lr * adam_m_[j] / (std::sqrt(adam_v_[j]) + ADAM_EPSILON));
+        }
+    });
+
+    ESGenerationStats stats;
+    stats.generation = generation_;
+    stats.episodes = returns_.size();
+    stats.max_reward = *std::max_element(returns_.begin(), returns_.end());
+    for (size_t slot = 0; slot < returns_.size(); ++slot) {
+        stats.mean_reward += returns_[slot] / returns_.size();
+        stats.mean_score += scores_[slot] / returns_.size();
+        stats.steps += steps_[slot];
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.episodes_per_second = stats.episodes / stats.seconds;
+    return stats;
+}
+
+MLP& ESAgent::getPolicy() {
+    return policy_;
+}
+
+const MLP& ESAgent::getPolicy() const {
+    return policy_;
+}
+
+void ESAgent::prepareWorkers() {
+    if (!pool_) {
+        pool_ = std::make_unique<ThreadPool>(config_.num_threads);
+    }
+    const size_t workers = pool_->size();
+    if (worker_policies_.size() != workers) {
+        worker_policies_.assign(workers, policy_);
+        worker_states_.assign(workers, std::vector<float>(state_size_));
+    }
+    if (worker_environments_.size() != workers) {
+        worker_environments_.resize(workers);
+        pool_->runOnAll([&](size_t worker) {
+            worker_environments_[worker] = make_environment_();
+        });
+    }
+}
+
+double ESAgent::playEpisode(MLP& policy, Environment& env, std::vector<float>& state_scratch,
+                            unsigned int seed, double& score, size_t& steps) {
+    env.setSeed(seed);
+    auto state = env.reset();
+    double total_reward = 0.0;
+    steps = 0;
+    while (!env.isDone()) {
+        if (state.size() != state_size_) {
+            throw std::invalid_argument("State size does not match the ES policy input size");
+        }
+        std::copy(state.begin(), state.end(), state_scratch.begin());
+        int action = greedyAction(policy.forward(state_scratch.data(), 1), action_size_);
+        auto [next_state, reward] = env.step(action);
+        state = std::move(next_state);
+        total_reward += reward;
+        steps++;
+    }
+    std::vector<double> info = env.getInfo();
+    score = info.empty() ? 0.0 : info[0];
+    return total_reward;
+}
+
+int ESAgent::greedyAction(const float* scores, size_t count) {
+    return static_cast<int>(std::max_element(scores, scores + count) - scores);
+}
+
+} // namespace SnakeGame::RL
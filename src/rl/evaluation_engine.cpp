@@ -0,0 +1,181 @@
+#include "rl/evaluation_engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace SnakeGame::RL {
+
+namespace {
+
+// Linear interpolation between closest ranks of sorted values
+double percentile(const std::vector<double>& sorted, double fraction) {
+    double rank = fraction * (sorted.size() - 1);
+    size_t lower = static_cast<size_t>(rank);
+    size_t upper = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (rank - lower) * (sorted[upper] - sorted[lower]);
+}
+
+void writeMetric(std::ostringstream& out, const char* name, const MetricSummary& metric, bool last) {
+    out << "    \"" << name << "\": {"
+        << "\"mean\": " << metric.mean << ", \"stddev\": " << metric.stddev
+        << ", \"min\": " << metric.min << ", \"max\": " << metric.max
+        << ", \"p5\": " << metric.p5 << ", \"p25\": " << metric.p25 << ", \"median\": " << metric.median
+        << ", \"p75\": " << metric.p75 << ", \"p95\": " << metric.p95
+        << ", \"ci95\": [" << metric.ci_low << ", " << metric.ci_high << "]}" << (last ? "\n" : ",\n");
+}
+
+std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+std::string EvaluationReport::toJson() const {
+    std::ostringstream out;
+    out << std::setprecision(10);
+    out << "{\n"
+        << "  \"agent\": \"" << escapeJson(agent_name) << "\",\n"
+        << "  \"episodes\": " << episodes << ",\n"
+        << "  \"threads\": " << threads << ",\n"
+        << "  \"seed\": " << seed << ",\n"
+        << "  \"seconds\": " << seconds << ",\n"
+        << "  \"metrics\": {\n";
+    writeMetric(out, "score", score, false);
+    writeMetric(out, "length", length, false);
+    writeMetric(out, "reward", reward, true);
+    out << "  }\n}\n";
+    return out.str();
+}
+
+void EvaluationReport::writeJson(const std::string& filepath) const {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file for saving: " + filepath);
+    }
+    file << toJson();
+}
+
+EvaluationEngine::EvaluationEngine(const EvaluationConfig& config)
+    : config_(config)
+    , pool_(config.num_threads) {
+}
+
+EvaluationReport EvaluationEngine::evaluate(const AgentFactory& make_agent, const std::string& agent_name) {
+    const size_t max_steps = config_.max_steps;
+    return evaluate(make_agent, [max_steps]() {
+        auto env = std::make_unique<SnakeEnvironment>(true);
+        env->setMaxSteps(max_steps);
+        return env;
+    }, agent_name);
+}
+
+EvaluationReport EvaluationEngine::evaluate(const AgentFactory& make_agent, const EnvironmentFactory& make_environment,
+                                            const std::string& agent_name) {
+    auto start = std::chrono::steady_clock::now();
+
+    // One agent and environment per worker, created on that worker
+    std::vector<std::unique_ptr<Agent>> agents(pool_.size());
+    std::vector<std::unique_ptr<Environment>> environments(pool_.size());
+    pool_.runOnAll([&](size_t worker) {
+        agents[worker] = make_agent();
+        agents[worker]->setEpsilon(config_.epsilon);
+        environments[worker] = make_environment();
+    });
+
+    episodes_.assign(config_.episodes, EpisodeResult());
+    pool_.parallelFor(config_.episodes, [&](size_t episode, size_t worker) {
+        Agent& agent = *agents[worker];
+        Environment& env = *environments[worker];
+
+        uint64_t seed = episodeSeed(config_.seed, episode);
+        env.setSeed(static_cast<unsigned int>(seed));
+        agent.setSeed(static_cast<unsigned int>(seed >> 32));
+
+        EpisodeResult result;
+        auto state = env.reset();
+        while (!env.isDone()) {
+            auto [next_state, reward] = env.step(agent.selectAction(state));
+            state = std::move(next_state);
+            result.reward += reward;
+            result.length++;
+        }
+        std::vector<double> info = env.getInfo();
+        result.score = info.empty() ? 0.0 : info[0];
+        episodes_[episode] = result;
+    });
+
+    EvaluationReport report;
+    report.agent_name = agent_name;
+    report.episodes = config_.episodes;
+    report.threads = pool_.size();
+    report.seed = config_.seed;
+
+    std::vector<double> scores, lengths, rewards;
+    scores.reserve(episodes_.size());
+    lengths.reserve(episodes_.size());
+    rewards.reserve(episodes_.size());
+    for (const EpisodeResult& result : episodes_) {
+        scores.push_back(result.score);
+        lengths.push_back(static_cast<double>(result.length));
+        rewards.push_back(result.reward);
+    }
+    report.score = summarize(std::move(scores));
+    report.length = summarize(std::move(lengths));
+    report.reward = summarize(std::move(rewards));
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+const std::vector<EpisodeResult>& EvaluationEngine::getEpisodes() const {
+    return episodes_;
+}
+
+uint64_t EvaluationEngine::episodeSeed(uint64_t seed, size_t episode) {
+    return mixSeed(seed, episode);
+}
+
+MetricSummary EvaluationEngine::summarize(std::vector<double> values) {
+    MetricSummary summary;
+    if (values.empty()) {
+        return summary;
+    }
+
+    // Sums in episode order, before sorting, so the result never depends on scheduling
+    const double n = static_cast<double>(values.size());
+    double sum = 0.0;
+    for (double value : values) {
+        sum += value;
+    }
+    summary.mean = sum / n;
+    double squares = 0.0;
+    for (double value : values) {
+        squares += (value - summary.mean) * (value - summary.mean);
+    }
+    summary.stddev = values.size() > 1 ? std::sqrt(squares / (n - 1.0)) : 0.0;
+    double margin = 1.959964 * summary.stddev / std::sqrt(n);
+    summary.ci_low = summary.mean - margin;
+    summary.ci_high = summary.mean + margin;
+
+    std::sort(values.begin(), values.end());
+    summary.min = values.front();
+    summary.max = values.back();
+    summary.p5 = percentile(values, 0.05);
+    summary.p25 = percentile(values, 0.25);
+    summary.median = percentile(values, 0.50);
+    summary.p75 = percentile(values, 0.75);
+    summary.p95 = percentile(values, 0.95);
+    return summary;
+}
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,238 @@
+#include "rl/gif_encoder.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace SnakeGame::RL {
+
+namespace {
+
+constexpr uint32_t MAX_CODES = 4096;
+constexpr int MAX_CODE_SIZE = 12;
+
+} // namespace
+
+GifEncoder::GifEncoder(size_t width, size_t height, const std::vector<uint8_t>& palette, bool loop)
+    : width_(width)
+    , height_(height)
+    , min_code_size_(2)
+    , finished_(false)
+    , frames_(0)
+    , last_delay_offset_(0)
+    , previous_(width * height, 0)
+    , bit_buffer_(0)
+    , bit_count_(0) {
+    const size_t colors = palette.size() / 3;
+    if (width == 0 || height == 0 || width > 0xFFFF || height > 0xFFFF) {
+        throw std::invalid_argument("GIF dimensions must be between 1 and 65535");
+    }
+    if (colors == 0 || colors > 256 || palette.size() % 3 != 0) {
+        throw std::invalid_argument("GIF palette needs 1 to 256 RGB colors");
+    }
+
+    // The color table and code alphabet are powers of two, at least 4 entries
+    int table_bits = 1;
+    while ((size_t(1) << table_bits) < colors) {
+        table_bits++;
+    }
+    min_code_size_ = std::max(2, table_bits);
+    children_.resize(MAX_CODES << min_code_size_);
+
+    // Header and logical screen descriptor with the global color table
+    const char* signature = "GIF89a";
+    bytes_.insert(bytes_.end(), signature, signature + 6);
+    writeShort(width_);
+    writeShort(height_);
+    bytes_.push_back(static_cast<uint8_t>(0x80 | ((table_bits - 1) << 4) | (table_bits - 1)));
+    bytes_.push_back(0); // Background color index
+    bytes_.push_back(0); // Square pixels
+    bytes_.insert(bytes_.end(), palette.begin(), palette.end());
+    bytes_.resize(bytes_.size() + 3 * ((size_t(1) << table_bits) - colors), 0);
+
+    if (loop) {
+        const char* extension = "\x21\xFF\x0BNETSCAPE2.0\x03\x01\x00\x00\x00";
+        bytes_.insert(bytes_.end(), extension, extension + 19);
+    }
+}
+
+void GifEncoder::addFrame(const uint8_t* indices, unsigned int delay_cs) {
+    if (finished_) {
+        throw std::logic_error("Cannot add frames to a finished GIF");
+    }
+    delay_cs = std::min(delay_cs, 0xFFFFu);
+
+    // Bounding box of the pixels that changed (everything for the first frame)
+    size_t left = width_, right = 0, top = height_, bottom = 0;
+    if (frames_ == 0) {
+        left = 0, right = width_ - 1, top = 0, bottom = height_ - 1;
+    } else {
+        for (size_t y = 0; y < height_; ++y) {
+            const uint8_t* row = indices + y * width_;
+            const uint8_t* previous_row = previous_.data() + y * width_;
+            if (std::memcmp(row, previous_row, width_) == 0) {
+                continue;
+            }
+            size_t first = 0, last = width_ - 1;
+            while (row[first] == previous_row[first]) {
+                first++;
+            }
+            while (row[last] == previous_row[last]) {
+                last--;
+            }
+            left = std::min(left, first);
+            right = std::max(right, last);
+            top = std::min(top, y);
+            bottom = y;
+        }
+    }
+
+    // Nothing changed: show the previous frame for longer instead
+    if (top > bottom) {
+        size_t delay = bytes_[last_delay_offset_] | (bytes_[last_delay_offset_ + 1] << 8);
+        delay = std::min<size_t>(0xFFFF, delay + delay_cs);
+        bytes_[last_delay_offset_] = static_cast<uint8_t>(delay & 0xFF);
+        bytes_[last_delay_offset_ + 1] = static_cast<uint8_t>(delay >> 8);
+        return;
+    }
+
+    // Graphic control extension: keep the previous frame underneath (disposal 1)
+    bytes_.push_back(0x21);
+    bytes_.push_back(0xF9);
+    bytes_.push_back(4);
+    bytes_.push_back(1 << 2);
+    last_delay_offset_ = bytes_.size();
+    writeShort(delay_cs);
+    bytes_.push_back(0);
+    bytes_.push_back(0);
+
+    // Image descriptor for the changed rectangle, no local color table
+    bytes_.push_back(0x2C);
+    writeShort(left);
+    writeShort(top);
+    writeShort(right - left + 1);
+    writeShort(bottom - top + 1);
+    bytes_.push_back(0);
+    encodeImage(indices, left, top, right - left + 1, bottom - top + 1);
+
+    std::memcpy(previous_.data(), indices, previous_.size());
+    frames_++;
+}
+
+const std::vector<uint8_t>& GifEncoder::finish() {
+    if (!finished_) {
+        bytes_.push_back(0x3B);
+        finished_ = true;
+    }
+    return bytes_;
+}
+
+void GifEncoder::save(const std::string& filepath) {
+    finish();
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file for saving: " + filepath);
+    }
+    file.write(reinterpret_cast<const char*>(bytes_.data()), static_cast<std::streamsize>(bytes_.size()));
+    if (!file) {
+        throw std::runtime_error("Failed to write " + filepath);
+    }
+}
+
+size_t GifEncoder::getFrameCount() const {
+    return frames_;
+}
+
+size_t GifEncoder::size() const {
+    return bytes_.size();
+}
+
+void GifEncoder::writeShort(size_t value) {
+    bytes_.push_back(static_cast<uint8_t>(value & 0xFF));
+    bytes_.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
+}
+
+void GifEncoder::encodeImage(const uint8_t* indices, size_t left, size_t top, size_t width, size_t height) {
+    const uint32_t alphabet = 1u << min_code_size_;
+    const uint32_t clear_code = alphabet;
+    const uint32_t end_code = clear_code + 1;
+    const uint32_t index_mask = alphabet - 1;
+
+    packed_.clear();
+    bit_buffer_ = 0;
+    bit_count_ = 0;
+    std::fill(children_.begin(), children_.end(), 0);
+    int code_size = min_code_size_ + 1;
+    uint32_t max_code = end_code; // Last assigned code
+    writeCode(clear_code, code_size);
+
+    uint32_t prefix = indices[top * width_ + left] & index_mask;
+    bool first = true;
+    for (size_t y = top; y < top + height; ++y) {
+        const uint8_t* row = indices + y * width_;
+        for (size_t x = left; x < left + width; ++x) {
+            if (first) {
+                first = false;
+                continue;
+            }
+            uint32_t index = row[x] & index_mask;
+            uint16_t& child = children_[prefix * alphabet + index];
+            if (child != 0) {
+                prefix = child;
+                continue;
+            }
+
+            // Emit the longest known string and add it extended by index
+            writeCode(prefix, code_size);
+            child = static_cast<uint16_t>(++max_code);
+            if (max_code >= (1u << code_size) && code_size < MAX_CODE_SIZE) {
+                code_size++;
+            }
+            if (max_code == MAX_CODES - 1) {
+                writeCode(clear_code, code_size);
+                std::fill(children_.begin(), children_.end(), 0);
+                code_size = min_code_size_ + 1;
+                max_code = end_code;
+            }
+            prefix = index;
+        }
+    }
+    writeCode(prefix, code_size);
+
+    // The decoder adds an entry on reading that last code and may widen first
+    if (max_code + 1 >= (1u << code_size) && code_size < MAX_CODE_SIZE && max_code > end_code) {
+        code_size++;
+    }
+    writeCode(end_code, code_size);
+    flushBits();
+
+    // Minimum code size, then the data in sub-blocks of at most 255 bytes
+    bytes_.push_back(static_cast<uint8_t>(min_code_size_));
+    for (size_t offset = 0; offset < packed_.size(); offset += 255) {
+        size_t block = std::min<size_t>(255, packed_.size() - offset);
+        bytes_.push_back(static_cast<uint8_t>(block));
+        bytes_.insert(bytes_.end(), packed_.begin() + offset, packed_.begin() + offset + block);
+    }
+    bytes_.push_back(0);
+}
+
+void GifEncoder::writeCode(uint32_t code, int code_size) {
+    // Codes are packed least significant bit first
+    bit_buffer_ |= code << bit_count_;
+    bit_count_ += code_size;
+    while (bit_count_ >= 8) {
+        packed_.push_back(static_cast<uint8_t>(bit_buffer_ & 0xFF));
+        bit_buffer_ >>= 8;
+        bit_count_ -= 8;
+    }
+}
+
+void GifEncoder::flushBits() {
+    if (bit_count_ > 0) {
+        packed_.push_back(static_cast<uint8_t>(bit_buffer_ & 0xFF));
+        bit_buffer_ = 0;
+        bit_count_ = 0;
+    }
+}
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,262 @@
+#include "rl/hyperparameter_sweep.h"
+#include "rl/evaluation_engine.h"
+#include "rl/q_learning_agent.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace SnakeGame::RL {
+
+namespace {
+
+constexpr double MIN_EPSILON = 0.01;
+constexpr uint64_t EVAL_SEED_SALT = 0x5EEDE7A1ULL;
+
+// Per-configuration state kept between rungs
+struct Trial {
+    TrialResult result;
+    std::unique_ptr<QLearningAgent> agent;
+    std::unique_ptr<SnakeEnvironment> env;
+    double epsilon = 0.0;
+    double seconds_per_episode = 1.0; // Unknown until the first rung; equal for everyone
+    double busy_seconds = 0.0;
+};
+
+std::pair<double, double> bounds(const std::vector<double>& values, const char* name) {
+    if (values.empty()) {
+        throw std::invalid_argument(std::string("Sweep space has no values for ") + name);
+    }
+    auto [low, high] = std::minmax_element(values.begin(), values.end());
+    return {*low, *high};
+}
+
+double logUniform(std::mt19937_64& rng, double low, double high) {
+    std::uniform_real_distribution<double> dist(std::log(low), std::log(high));
+    return std::exp(dist(rng));
+}
+
+// Samples 1 - value log-uniformly, for parameters that only matter near 1
+double nearOne(std::mt19937_64& rng, double low, double high) {
+    if (high >= 1.0) {
+        throw std::invalid_argument("Discount factors and decays must be below 1 for random search");
+    }
+    return 1.0 - logUniform(rng, 1.0 - high, 1.0 - low);
+}
+
+void runRung(Trial& trial, const SweepConfig& config, size_t budget) {
+    auto start = std::chrono::steady_clock::now();
+    const HyperParameters& params = trial.result.params;
+    if (!trial.agent) {
+        uint64_t seed = EvaluationEngine::episodeSeed(config.seed, trial.result.id);
+        trial.agent = std::make_unique<QLearningAgent>(params.learning_rate, params.discount_factor, params.epsilon);
+        trial.agent->setSeed(static_cast<unsigned int>(seed >> 32));
+        trial.env = std::make_unique<SnakeEnvironment>(true);
+        trial.env->setMaxSteps(config.max_steps);
+        trial.env->setRewardStructure(10.0, -100.0, -1.0);
+        trial.env->setSeed(static_cast<unsigned int>(seed));
+        trial.epsilon = params.epsilon;
+    }
+    QLearningAgent& agent = *trial.agent;
+    SnakeEnvironment& env = *trial.env;
+
+    // Continue training where the previous rung stopped
+    const size_t episodes = budget - trial.result.episodes;
+    agent.setEpsilon(trial.epsilon);
+    for (size_t episode = 0; episode < episodes; ++episode) {
+        auto state = env.reset();
+        while (!env.isDone()) {
+            int action = agent.selectAction(state);
+            auto [next_state, reward] = env.step(action);
+            agent.update(state, action, reward, next_state, env.isDone());
+            state = std::move(next_state);
+        }
+        trial.epsilon = std::max(MIN_EPSILON, trial.epsilon * params.epsilon_decay);
+        agent.setEpsilon(trial.epsilon);
+    }
+    double train_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Greedy evaluation on the same seeded episodes for every trial
+    agent.setEpsilon(0.0);
+    double score = 0.0, reward = 0.0, length = 0.0;
+    for (size_t episode = 0; episode < config.eval_episodes; ++episode) {
+        env.setSeed(static_cast<unsigned int>(EvaluationEngine::episodeSeed(config.seed ^ EVAL_SEED_SALT, episode)));
+        auto state = env.reset();
+        while (!env.isDone()) {
+            auto [next_state, step_reward] = env.step(agent.selectAction(state));
+            state = std::move(next_state);
+            reward += step_reward;
+            length += 1.0;
+        }
+        std::vector<double> info = env.getInfo();
+        score += info.empty() ? 0.0 : info[0];
+    }
+    agent.setEpsilon(trial.epsilon);
+
+    const double n = static_cast<double>(std::max<size_t>(1, config.eval_episodes));
+    trial.result.episodes = budget;
+    trial.result.score = score / n;
+    trial.result.reward = reward / n;
+    trial.result.length = length / n;
+    trial.result.train_seconds += train_seconds;
+    trial.result.table_size = agent.getTableStats().size;
+    if (episodes > 0) {
+        trial.seconds_per_episode = train_seconds / episodes;
+    }
+    trial.busy_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+// SweepSpace implementation
+std::vector<HyperParameters> SweepSpace::grid() const {
+    std::vector<HyperParameters> configurations;
+    for (double learning_rate : learning_rates) {
+        for (double discount_factor : discount_factors) {
+            for (double epsilon : epsilons) {
+                for (double epsilon_decay : epsilon_decays) {
+                    configurations.push_back({learning_rate, discount_factor, epsilon, epsilon_decay});
+                }
+            }
+        }
+    }
+    return configurations;
+}
+
+std::vector<HyperParameters> SweepSpace::sample(size_t count, uint64_t seed) const {
+    auto [lr_low, lr_high] = bounds(learning_rates, "learning rate");
+    auto [gamma_low, gamma_high] = bounds(discount_factors, "discount factor");
+    auto [epsilon_low, epsilon_high] = bounds(epsilons, "epsilon");
+    auto [decay_low, decay_high] = bounds(epsilon_decays, "epsilon decay");
+    if (lr_low <= 0.0) {
+        throw std::invalid_argument("Learning rates must be positive for random search");
+    }
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> epsilon_dist(epsilon_low, epsilon_high);
+    std::vector<HyperParameters> configurations(count);
+    for (HyperParameters& params : configurations) {
+        params.learning_rate = logUniform(rng, lr_low, lr_high);
+        params.discount_factor = nearOne(rng, gamma_low, gamma_high);
+        params.epsilon = epsilon_dist(rng);
+        params.epsilon_decay = nearOne(rng, decay_low, decay_high);
+    }
+    return configurations;
+}
+
+// SweepReport implementation
+std::string SweepReport::toTable(size_t max_rows) const {
+    std::ostringstream out;
+    out << "Rank |     LR |  Gamma |  Eps |  Decay | Rung | Episodes |  Score |  Reward | Length |  Table | Train s\n";
+    size_t rows = max_rows == 0 ? trials.size() : std::min(max_rows, trials.size());
+    for (size_t i = 0; i < rows; ++i) {
+        const TrialResult& trial = trials[i];
+        out << std::setw(4) << i + 1 << " | " << std::fixed
+            << std::setprecision(4) << std::setw(6) << trial.params.learning_rate << " | "
+            << std::setw(6) << trial.params.discount_factor << " | "
+            << std::setprecision(2) << std::setw(4) << trial.params.epsilon << " | "
+            << std::setprecision(4) << std::setw(6) << trial.params.epsilon_decay << " | "
+            << std::setw(4) << trial.rung << " | " << std::setw(8) << trial.episodes << " | "
+            << std::setprecision(2) << std::setw(6) << trial.score << " | "
+            << std::setprecision(1) << std::setw(7) << trial.reward << " | " << std::setw(6) << trial.length << " | "
+            << std::setw(6) << trial.table_size << " | " << std::setprecision(2) << std::setw(7) << trial.train_seconds
+            << "\n";
+    }
+    return out.str();
+}
+
+void SweepReport::writeCsv(const std::string& filepath) const {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file for saving: " + filepath);
+    }
+    file << std::setprecision(10);
+    file << "rank,id,learning_rate,discount_factor,epsilon,epsilon_decay,rung,episodes,score,reward,length,"
+         << "table_size,train_seconds\n";
+    for (size_t i = 0; i < trials.size(); ++i) {
+        const TrialResult& trial = trials[i];
+        file << i + 1 << "," << trial.id << "," << trial.params.learning_rate << "," << trial.params.discount_factor
+             << "," << trial.params.epsilon << "," << trial.params.epsilon_decay << "," << trial.rung << ","
+             << trial.episodes << "," << trial.score << "," << trial.reward << "," << trial.length << ","
+             << trial.table_size << "," << trial.train_seconds << "\n";
+    }
+}
+
+// SweepRunner implementation
+SweepRunner::SweepRunner(const SweepConfig& config)
+    : config_(config)
+    , pool_(config.num_threads) {
+    if (config_.eta < 2) {
+        throw std::invalid_argument("Successive halving needs eta >= 2");
+    }
+    if (config_.min_episodes == 0 || config_.min_episodes > config_.max_episodes) {
+        throw std::invalid_argument("Sweep needs 0 < min_episodes <= max_episodes");
+    }
+}
+
+SweepReport SweepRunner::run(const std::vector<HyperParameters>& configurations) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Trial> trials(configurations.size());
+    std::vector<size_t> alive(configurations.size());
+    for (size_t i = 0; i < configurations.size(); ++i) {
+        trials[i].result.id = i;
+        trials[i].result.params = configurations[i];
+        alive[i] = i;
+    }
+
+    SweepReport report;
+    report.threads = pool_.size();
+    size_t budget = config_.min_episodes;
+    for (size_t rung = 0; !alive.empty(); ++rung) {
+        // Longest expected job first, so a slow trial never starts last
+        auto cost = [&](size_t id) {
+            return static_cast<double>(budget - trials[id].result.episodes) * trials[id].seconds_per_episode;
+        };
+        std::sort(alive.begin(), alive.end(), [&](size_t a, size_t b) {
+            double cost_a = cost(a), cost_b = cost(b);
+            return cost_a != cost_b ? cost_a > cost_b : a < b;
+        });
+        pool_.parallelFor(alive.size(), [&](size_t index, size_t) {
+            Trial& trial = trials[alive[index]];
+            trial.result.rung = rung;
+            runRung(trial, config_, budget);
+        });
+        report.rungs = rung + 1;
+        if (budget >= config_.max_episodes) {
+            break;
+        }
+
+        // Keep the best 1/eta; the rest free their tables now
+        std::sort(alive.begin(), alive.end(), [&](size_t a, size_t b) {
+            double score_a = trials[a].result.score, score_b = trials[b].result.score;
+            return score_a != score_b ? score_a > score_b : a < b;
+        });
+        size_t keep = std::max<size_t>(1, alive.size() / config_.eta);
+        for (size_t i = keep; i < alive.size(); ++i) {
+            trials[alive[i]].agent.reset();
+            trials[alive[i]].env.reset();
+        }
+        alive.resize(keep);
+        budget = std::min(config_.max_episodes, budget * config_.eta);
+    }
+
+    for (Trial& trial : trials) {
+        report.busy_seconds += trial.busy_seconds;
+        report.trials.push_back(trial.result);
+    }
+    std::sort(report.trials.begin(), report.trials.end(), [](const TrialResult& a, const TrialResult& b) {
+        if (a.rung != b.rung) {
+            return a.rung > b.rung;
+        }
+        return a.score != b.score ? a.score > b.score : a.id < b.id;
+    });
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+} // namespace SnakeGame::RL
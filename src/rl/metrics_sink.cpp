@@ -0,0 +1,293 @@
+#include "rl/metrics_sink.h"
+#include <charconv>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+namespace SnakeGame::RL {
+
+namespace {
+
+constexpr uint64_t METRICS_MAGIC = 0x313054454D4B4E53ULL; // "SNKMET01"
+constexpr size_t FILE_CHUNK_SIZE = 1 << 16;
+constexpr auto IDLE_SLEEP = std::chrono::milliseconds(2);
+
+template <typename Value>
+void appendText(ByteWriter& out, Value value, char separator) {
+    char text[32];
+    char* end = std::to_chars(text, text + sizeof(text), value).ptr;
+    *end++ = separator;
+    out.buffer().insert(out.buffer().end(), text, end);
+}
+
+} // namespace
+
+// RollingWindow implementation
+RollingWindow::RollingWindow(size_t capacity)
+    : values_(capacity == 0 ? 1 : capacity, 0.0)
+    , next_(0)
+    , count_(0)
+    , sum_(0.0) {
+}
+
+void RollingWindow::push(double value) {
+    sum_ += value - values_[next_];
+    values_[next_] = value;
+    next_++;
+    if (next_ == values_.size()) {
+        // Once per turn: replace the running sum by an exact one
+        next_ = 0;
+        sum_ = 0.0;
+        for (double v : values_) {
+            sum_ += v;
+        }
+    }
+    if (count_ < values_.size()) {
+        count_++;
+    }
+}
+
+double RollingWindow::mean() const {
+    return count_ == 0 ? 0.0 : sum_ / count_;
+}
+
+size_t RollingWindow::count() const {
+    return count_;
+}
+
+size_t RollingWindow::capacity() const {
+    return values_.size();
+}
+
+void RollingWindow::clear() {
+    std::fill(values_.begin(), values_.end(), 0.0);
+    next_ = 0;
+    count_ = 0;
+    sum_ = 0.0;
+}
+
+// RateLimiter implementation
+RateLimiter::RateLimiter(std::chrono::milliseconds interval)
+    : interval_(interval)
+    , next_(std::chrono::steady_clock::now() + interval) {
+}
+
+bool RateLimiter::allow() {
+    auto now = std::chrono::steady_clock::now();
+    if (now < next_) {
+        return false;
+    }
+    next_ = now + interval_;
+    return true;
+}
+
+// MetricsChannel implementation
+MetricsChannel::MetricsChannel(uint32_t source, size_t capacity)
+    : source_(source)
+    , queue_(capacity)
+    , accepted_(0)
+    , dropped_(0) {
+}
+
+bool MetricsChannel::record(const EpisodeMetrics& metrics) {
+    if (!queue_.tryPush(metrics)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    accepted_.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+uint32_t MetricsChannel::getSource() const {
+    return source_;
+}
+
+size_t MetricsChannel::getAccepted() const {
+    return accepted_.load(std::memory_order_acquire);
+}
+
+size_t MetricsChannel::getDropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+// MetricsSink implementation
+MetricsSink::MetricsSink(const MetricsConfig& config)
+    : config_(config)
+    , rewards_(config.window)
+    , lengths_(config.window)
+    , scores_(config.window)
+    , console_limiter_(config.console_interval)
+    , start_(std::chrono::steady_clock::now())
+    , written_(0)
+    , flushed_(0)
+    , write_failures_(0)
+    , stopping_(false) {
+    if (!config_.path.empty()) {
+        bool binary = config_.format == MetricsFormat::BINARY;
+        file_.open(config_.path, binary ? std::ios::binary | std::ios::trunc : std::ios::trunc);
+        if (!file_.is_open()) {
+            throw std::runtime_error("Could not open metrics file: " + config_.path);
+        }
+        if (binary) {
+            buffer_.putUint64(METRICS_MAGIC);
+        } else {
+            const char header[] = "source,episode,reward,length,score,epsilon,table_size\n";
+            buffer_.buffer().insert(buffer_.buffer().end(), header, header + sizeof(header) - 1);
+        }
+    }
+    thread_ = std::thread(&MetricsSink::run, this);
+}
+
+MetricsSink::~MetricsSink() {
+    stopping_.store(true, std::memory_order_release);
+    thread_.join();
+}
+
+std::shared_ptr<MetricsChannel> MetricsSink::openChannel() {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    auto channel = std::make_shared<MetricsChannel>(static_cast<uint32_t>(channels_.size()), config_.queue_capacity);
+    channels_.push_back(channel);
+    return channel;
+}
+
+void MetricsSink::flush() {
+    const size_t target = acceptedTotal();
+    while (flushed_.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+size_t MetricsSink::getWritten() const {
+    return written_.load(std::memory_order_relaxed);
+}
+
+size_t MetricsSink::getWriteFailures() const {
+    return write_failures_.load(std::memory_order_relaxed);
+}
+
+size_t MetricsSink::getDropped() const {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    size_t dropped = 0;
+    for (const auto& channel : channels_) {
+        dropped += channel->getDropped();
+    }
+    return dropped;
+}
+
+void MetricsSink::run() {
+    std::vector<std::shared_ptr<MetricsChannel>> channels;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(channels_mutex_);
+            channels = channels_;
+        }
+
+        // Anything recorded before the destructor ran is drained below
+        bool stopping = stopping_.load(std::memory_order_acquire);
+        size_t drained = drain(channels);
+        if (drained > 0 && config_.console_interval.count() > 0 && console_limiter_.allow()) {
+            printProgress(false);
+        }
+        if (drained == 0) {
+            flushFile();
+            if (stopping) {
+                break;
+            }
+            std::this_thread::sleep_for(IDLE_SLEEP);
+        }
+    }
+
+    if (config_.console_interval.count() > 0 && written_.load(std::memory_order_relaxed) > 0) {
+        printProgress(true);
+    }
+}
+
+size_t MetricsSink::drain(std::vector<std::shared_ptr<MetricsChannel>>& channels) {
+    size_t drained = 0;
+    EpisodeMetrics metrics;
+    for (auto& channel : channels) {
+        while (channel->queue_.tryPop(metrics)) {
+            write(channel->source_, metrics);
+            drained++;
+        }
+    }
+    return drained;
+}
+
+void MetricsSink::write(uint32_t source, const EpisodeMetrics& metrics) {
+    rewards_.push(metrics.reward);
+    lengths_.push(metrics.length);
+    scores_.push(metrics.score);
+    last_ = metrics;
+
+    if (file_.is_open()) {
+        if (config_.format == MetricsFormat::BINARY) {
+            buffer_.putVarint(source);
+            buffer_.putVarint(metrics.episode);
+            buffer_.putFloat(static_cast<float>(metrics.reward));
+            buffer_.putVarint(metrics.length);
+            buffer_.putVarint(metrics.score);
+            buffer_.putFloat(static_cast<float>(metrics.epsilon));
+            buffer_.putVarint(metrics.table_size);
+        } else {
+            appendText(buffer_, source, ',');
+            appendText(buffer_, metrics.episode, ',');
+            appendText(buffer_, metrics.reward, ',');
+            appendText(buffer_, metrics.length, ',');
+            appendText(buffer_, metrics.score, ',');
+            appendText(buffer_, metrics.epsilon, ',');
+            appendText(buffer_, metrics.table_size, '\n');
+        }
+        if (buffer_.size() >= FILE_CHUNK_SIZE) {
+            file_.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+            buffer_.clear();
+        }
+    }
+    written_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricsSink::flushFile() {
+    size_t written = written_.load(std::memory_order_relaxed);
+    if (flushed_.load(std::memory_order_relaxed) == written && buffer_.size() == 0) {
+        return;
+    }
+    if (file_.is_open()) {
+        file_.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+        file_.flush();
+        if (!file_) {
+            // Whatever reached the stream since the last good flush may be lost
+            write_failures_.fetch_add(written - flushed_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            file_.clear();
+        }
+    }
+    buffer_.clear();
+    flushed_.store(written, std::memory_order_release);
+}
+
+void MetricsSink::printProgress(bool final) {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    size_t written = written_.load(std::memory_order_relaxed);
+    std::cout << (final ? "Final   " : "Episode ") << last_.episode
+              << " | Avg Reward: " << std::fixed << std::setprecision(2) << rewards_.mean()
+              << " | Avg Length: " << std::setprecision(1) << lengths_.mean()
+              << " | Avg Score: " << std::setprecision(2) << scores_.mean()
+              << " | Epsilon: " << std::setprecision(3) << last_.epsilon
+              << " | Q-table size: " << last_.table_size
+              << " | Episodes/s: " << std::setprecision(0) << (seconds > 0.0 ? written / seconds : 0.0)
+              << " | Dropped: " << getDropped();
+    if (size_t failures = getWriteFailures()) {
+        std::cout << " | Write failures: " << failures;
+    }
+    std::cout << "\n" << std::flush;
+}
+
+size_t MetricsSink::acceptedTotal() {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    size_t accepted = 0;
+    for (const auto& channel : channels_) {
+        accepted += channel->getAccepted();
+    }
+    return accepted;
+}
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,349 @@
+#include "rl/mlp.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define SNAKE_MLP_AVX2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SNAKE_MLP_NEON 1
+#endif
+
+namespace SnakeGame::RL {
+
+namespace {
+
+// Block sizes keep a K x N panel of the right-hand matrix resident in L1/L2
+constexpr size_t BLOCK_M = 64;
+constexpr size_t BLOCK_K = 128;
+
+// y[0:n] += a * x[0:n]
+inline void axpy(size_t n, float a, const float* x, float* y) {
+    size_t i = 0;
+#if defined(SNAKE_MLP_AVX2)
+    __m256 va = _mm256_set1_ps(a);
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    }
+#elif defined(SNAKE_MLP_NEON)
+    float32x4_t va = vdupq_n_f32(a);
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(y + i, vmlaq_f32(vld1q_f32(y + i), va, vld1q_f32(x + i)));
+    }
+#endif
+    for (; i < n; ++i) {
+        y[i] += a * x[i];
+    }
+}
+
+// Returns sum(x[0:n] * y[0:n])
+inline float dot(size_t n, const float* x, const float* y) {
+    size_t i = 0;
+    float sum = 0.0f;
+#if defined(SNAKE_MLP_AVX2)
+    __m256 acc = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc);
+    }
+    __m128 lo = _mm256_castps256_ps128(acc);
+    __m128 hi = _mm256_extractf128_ps(acc, 1);
+    lo = _mm_add_ps(lo, hi);
+    lo = _mm_hadd_ps(lo, lo);
+    lo = _mm_hadd_ps(lo, lo);
+    sum = _mm_cvtss_f32(lo);
+#elif defined(SNAKE_MLP_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= n; i += 4) {
+        acc = vmlaq_f32(acc, vld1q_f32(x + i), vld1q_f32(y + i));
+    }
+    float32x2_t pair = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum = vget_lane_f32(vpadd_f32(pair, pair), 0);
+#endif
+    for (; i < n; ++i) {
+        sum += x[i] * y[i];
+    }
+    return sum;
+}
+
+// C[M x N] += A[M x K] * B[K x N]
+void gemmNN(size_t M, size_t N, size_t K, const float* A, const float* B, float* C) {
+    for (size_t k0 = 0; k0 < K; k0 += BLOCK_K) {
+        size_t k1 = std::min(K, k0 + BLOCK_K);
+        for (size_t i0 = 0; i0 < M; i0 += BLOCK_M) {
+            size_t i1 = std::min(M, i0 + BLOCK_M);
+            for (size_t i = i0; i < i1; ++i) {
+                const float* a_row = A + i * K;
+                float* c_row = C + i * N;
+                for (size_t k = k0; k < k1; ++k) {
+                    axpy(N, a_row[k], B + k * N, c_row);
+                }
+            }
+        }
+    }
+}
+
+// C[K x N] += A[M x K]^T * B[M x N]
+void gemmTN(size_t M, size_t N, size_t K, const float* A, const float* B, float* C) {
+    for (size_t k0 = 0; k0 < K; k0 += BLOCK_K) {
+        size_t k1 = std::min(K, k0 + BLOCK_K);
+        for (size_t i = 0; i < M; ++i) {
+            const float* a_row = A + i * K;
+            const float* b_row = B + i * N;
+            for (size_t k = k0; k < k1; ++k) {
+                axpy(N, a_row[k], b_row, C + k * N);
+            }
+        }
+    }
+}
+
+// C[M x K] = A[M x N] * B[K x N]^T
+void gemmNT(size_t M, size_t N, size_t K, const float* A, const float* B, float* C) {
+    for (size_t i0 = 0; i0 < M; i0 += BLOCK_M) {
+        size_t i1 = std::min(M, i0 + BLOCK_M);
+        for (size_t k0 = 0; k0 < K; k0 += BLOCK_K) {
+            size_t k1 = std::min(K, k0 + BLOCK_K);
+            for (size_t i = i0; i < i1; ++i) {
+                const float* a_row = A + i * N;
+                float* c_row = C + i * K;
+                for (size_t k = k0; k < k1; ++k) {
+                    c_row[k] = dot(N, a_row, B + k * N);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+MLP::MLP(const std::vector<size_t>& layer_sizes, unsigned int seed)
+    : layer_sizes_(layer_sizes)
+    , adam_step_(0)
+    , cached_batch_size_(0) {
+    if (layer_sizes_.size() < 2) {
+        throw std::invalid_argument("MLP needs at least an input and an output layer");
+    }
+
+    size_t offset = 0;
+    for (size_t l = 0; l + 1 < layer_sizes_.size(); ++l) {
+        Layer layer;
+        layer.inputs = layer_sizes_[l];
+        layer.outputs = layer_sizes_[l + 1];
+        layer.weight_offset = offset;
+        offset += layer.inputs * layer.outputs;
+        layer.bias_offset = offset;
+        offset += layer.outputs;
+        layers_.push_back(layer);
+    }
+
+    parameters_.assign(offset, 0.0f);
+    gradients_.assign(offset, 0.0f);
+    adam_m_.assign(offset, 0.0f);
+    adam_v_.assign(offset, 0.0f);
+    activations_.resize(layer_sizes_.size());
+
+    // He-uniform initialization for ReLU layers, biases start at zero
+    std::mt19937 gen(seed);
+    for (const auto& layer : layers_) {
+        float limit = std::sqrt(6.0f / static_cast<float>(layer.inputs));
+        std::uniform_real_distribution<float> dist(-limit, limit);
+        for (size_t i = 0; i < layer.inputs * layer.outputs; ++i) {
+            parameters_[layer.weight_offset + i] = dist(gen);
+        }
+    }
+}
+
+const float* MLP::forward(const float* input, size_t batch_size) {
+    reserveBatch(batch_size);
+    cached_batch_size_ = batch_size;
+    std::memcpy(activations_[0].data(), input, batch_size * getInputSize() * sizeof(float));
+
+    for (size_t l = 0; l < layers_.size(); ++l) {
+        const Layer& layer = layers_[l];
+        const float* weights = &parameters_[layer.weight_offset];
+        const float* bias = &parameters_[layer.bias_offset];
+        float* out = activations_[l + 1].data();
+
+        // Start from the bias, then accumulate X * W
+        for (size_t b = 0; b < batch_size; ++b) {
+            std::memcpy(out + b * layer.outputs, bias, layer.outputs * sizeof(float));
+        }
+        gemmNN(batch_size, layer.outputs, layer.inputs, activations_[l].data(), weights, out);
+
+        // ReLU on hidden layers only
+        if (l + 1 < layers_.size()) {
+            size_t count = batch_size * layer.outputs;
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = std::max(out[i], 0.0f);
+            }
+        }
+    }
+
+    return activations_.back().data();
+}
+
+void MLP::backward(const float* output_grad, size_t batch_size) {
+    if (batch_size != cached_batch_size_) {
+        throw std::logic_error("MLP::backward batch size does not match the last forward pass");
+    }
+
+    std::memcpy(delta_.data(), output_grad, batch_size * getOutputSize() * sizeof(float));
+
+    for (size_t l = layers_.size(); l-- > 0;) {
+        const Layer& layer = layers_[l];
+        const float* layer_input = activations_[l].data();
+
+        // dW += X^T * delta, db += sum over batch of delta
+        gemmTN(batch_size, layer.outputs, layer.inputs, layer_input, delta_.data(),
+               &gradients_[layer.weight_offset]);
+        float* bias_grad = &gradients_[layer.bias_offset];
+        for (size_t b = 0; b < batch_size; ++b) {
+            axpy(layer.outputs, 1.0f, delta_.data() + b * layer.outputs, bias_grad);
+        }
+
+        if (l == 0) {
+            break;
+        }
+
+        // delta_prev = (delta * W^T) masked by the ReLU derivative of the layer input
+        gemmNT(batch_size, layer.outputs, layer.inputs, delta_.data(),
+               &parameters_[layer.weight_offset], delta_prev_.data());
+        size_t count = batch_size * layer.inputs;
+        for (size_t i = 0; i < count; ++i) {
+            if (layer_input[i] <= 0.0f) {
+                delta_prev_[i] = 0.0f;
+            }
+        }
+        delta_.swap(delta_prev_);
+    }
+}
+
+void MLP::zeroGradients() {
+    std::fill(gradients_.begin(), gradients_.end(), 0.0f);
+}
+
+void MLP::adamStep(float learning_rate, float beta1, float beta2, float epsilon) {
+    adam_step_++;
+    float correction1 = 1.0f - std::pow(beta1, static_cast<float>(adam_step_));
+    float correction2 = 1.0f - std::pow(beta2, static_cast<float>(adam_step_));
+    float step_size = learning_rate * std::sqrt(correction2) / correction1;
+
+    for (size_t i = 0; i < parameters_.size(); ++i) {
+        float g = gradients_[i];
+        adam_m_[i] = beta1 * adam_m_[i] + (1.0f - beta1) * g;
+        adam_v_[i] = beta2 * adam_v_[i] + (1.0f - beta2) * g * g;
+        parameters_[i] -= step_size * adam_m_[i] / (std::sqrt(adam_v_[i]) + epsilon);
+    }
+}
+
+float MLP::clipGradientNorm(float max_norm) {
+    float norm = std::sqrt(dot(gradients_.size(), gradients_.data(), gradients_.data()));
+    if (norm > max_norm && norm > 0.0f) {
+        float scale = max_norm / norm;
+        for (float& g : gradients_) {
+            g *= scale;
+        }
+    }
+    return norm;
+}
+
+void MLP::copyParametersFrom(const MLP& other) {
+    if (other.layer_sizes_ != layer_sizes_) {
+        throw std::invalid_argument("Cannot copy parameters between MLPs of different shapes");
+    }
+    std::copy(other.parameters_.begin(), other.parameters_.end(), parameters_.begin());
+}
+
+std::vector<float>& MLP::getParameters() {
+    return parameters_;
+}
+
+const std::vector<float>& MLP::getParameters() const {
+    return parameters_;
+}
+
+size_t MLP::getParameterCount() const {
+    return parameters_.size();
+}
+
+size_t MLP::getInputSize() const {
+    return layer_sizes_.front();
+}
+
+size_t MLP::getOutputSize() const {
+    return layer_sizes_.back();
+}
+
+const std::vector<size_t>& MLP::getLayerSizes() const {
+    return layer_sizes_;
+}
+
+void MLP::save(std::ostream& out) const {
+    out << layer_sizes_.size();
+    for (size_t size : layer_sizes_) {
+        out << " " << size;
+    }
+    out << "\n";
+
+    out.precision(std::numeric_limits<float>::max_digits10);
+    for (size_t i = 0; i < parameters_.size(); ++i) {
+        out << parameters_[i] << ((i + 1) % 16 == 0 ? "\n" : " ");
+    }
+    out << "\n";
+}
+
+void MLP::load(std::istream& in) {
+    size_t num_layers;
+    in >> num_layers;
+    std::vector<size_t> sizes(num_layers);
+    for (size_t& size : sizes) {
+        in >> size;
+    }
+    if (!in || sizes != layer_sizes_) {
+        throw std::runtime_error("MLP layer sizes in file do not match the network");
+    }
+
+    for (float& p : parameters_) {
+        in >> p;
+    }
+    if (!in) {
+        throw std::runtime_error("Truncated MLP parameters");
+    }
+
+    std::fill(adam_m_.begin(), adam_m_.end(), 0.0f);
+    std::fill(adam_v_.begin(), adam_v_.end(), 0.0f);
+    adam_step_ = 0;
+}
+
+const char* MLP::simdBackend() {
+#if defined(SNAKE_MLP_AVX2)
+    return "AVX2";
+#elif defined(SNAKE_MLP_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+void MLP::reserveBatch(size_t batch_size) {
+    size_t max_width = 0;
+    for (size_t l = 0; l < layer_sizes_.size(); ++l) {
+        size_t needed = batch_size * layer_sizes_[l];
+        if (activations_[l].size() < needed) {
+            activations_[l].resize(needed);
+        }
+        max_width = std::max(max_width, layer_sizes_[l]);
+    }
+    if (delta_.size() < batch_size * max_width) {
+        delta_.resize(batch_size * max_width);
+        delta_prev_.resize(batch_size * max_width);
+    }
+}
+
+} // namespace SnakeGame::RL
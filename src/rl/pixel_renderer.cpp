@@ -0,0 +1,236 @@
+#include "rl/pixel_renderer.h"
+#include "game_controller.h"
+#include "snake.h"
+#include "apple.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SNAKE_PIXELS_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SNAKE_PIXELS_NEON 1
+#endif
+
+namespace SnakeGame::RL {
+
+namespace {
+
+// Cell contents, also the index into the color table
+constexpr uint8_t CELL_EMPTY = 0;
+constexpr uint8_t CELL_BODY = 1;
+constexpr uint8_t CELL_HEAD = 2;
+constexpr uint8_t CELL_APPLE = 3;
+constexpr size_t NUM_CELL_TYPES = 4;
+
+// Same colors as OpenGLGraphics; grayscale keeps the entities distinct
+constexpr uint8_t GRAY_COLORS[NUM_CELL_TYPES] = {0, 128, 255, 192};
+constexpr uint8_t RGB_COLORS[NUM_CELL_TYPES][3] = {{0, 0, 0}, {0, 178, 0}, {0, 255, 0}, {255, 0, 0}};
+
+// dst[0:n] = src[0:n]; rows of 8 bytes or more finish with one overlapping store
+inline void copyRow(uint8_t* dst, const uint8_t* src, size_t n) {
+#if defined(SNAKE_PIXELS_SSE2)
+    if (n >= 16) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        }
+        if (i < n) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + n - 16),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + n - 16)));
+        }
+        return;
+    }
+#elif defined(SNAKE_PIXELS_NEON)
+    if (n >= 16) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            vst1q_u8(dst + i, vld1q_u8(src + i));
+        }
+        if (i < n) {
+            vst1q_u8(dst + n - 16, vld1q_u8(src + n - 16));
+        }
+        return;
+    }
+#endif
+    if (n >= 8) {
+        // Fixed-size copies compile to single 8-byte moves
+        for (size_t i = 0; i + 8 < n; i += 8) {
+            std::memcpy(dst + i, src + i, 8);
+        }
+        std::memcpy(dst + n - 8, src + n - 8, 8);
+        return;
+    }
+    std::memcpy(dst, src, n);
+}
+
+} // namespace
+
+// PixelRenderer implementation
+PixelRenderer::PixelRenderer(const PixelConfig& config)
+    : config_(config)
+    , channels_(config.format == PixelFormat::RGB ? 3 : 1)
+    , column_edges_(GameConfig::GRID_SIZE_X + 1)
+    , row_edges_(GameConfig::GRID_SIZE_Y + 1)
+    , cells_(GameConfig::GRID_SIZE_X * GameConfig::GRID_SIZE_Y, CELL_EMPTY)
+    , next_cells_(cells_.size(), CELL_EMPTY)
+    , valid_(false)
+    , cells_painted_(0) {
+    if (config_.width < static_cast<size_t>(GameConfig::GRID_SIZE_X) ||
+        config_.height < static_cast<size_t>(GameConfig::GRID_SIZE_Y)) {
+        throw std::invalid_argument("Pixel observations need at least one pixel per board cell");
+    }
+    frame_.assign(config_.width * config_.height * channels_, 0);
+
+    for (size_t i = 0; i < column_edges_.size(); ++i) {
+        column_edges_[i] = i * config_.width / GameConfig::GRID_SIZE_X;
+    }
+    for (size_t i = 0; i < row_edges_.size(); ++i) {
+        row_edges_[i] = i * config_.height / GameConfig::GRID_SIZE_Y;
+    }
+
+    // Widest cell row in every color
+    size_t cell_width = 0;
+    for (size_t i = 0; i + 1 < column_edges_.size(); ++i) {
+        cell_width = std::max(cell_width, column_edges_[i + 1] - column_edges_[i]);
+    }
+    color_rows_.resize(NUM_CELL_TYPES);
+    for (size_t type = 0; type < NUM_CELL_TYPES; ++type) {
+        color_rows_[type].resize(cell_width * channels_);
+        for (size_t x = 0; x < cell_width; ++x) {
+            for (size_t c = 0; c < channels_; ++c) {
+                uint8_t value = static_cast<uint8_t>(type);
+                if (config_.format == PixelFormat::RGB) {
+                    value = RGB_COLORS[type][c];
+                } else if (config_.format == PixelFormat::GRAYSCALE) {
+                    value = GRAY_COLORS[type];
+                }
+                color_rows_[type][x * channels_ + c] = value;
+            }
+        }
+    }
+}
+
+const uint8_t* PixelRenderer::render(const Snake& snake, const Apple& apple) {
+    // Board contents, drawn in the same order as Game::render()
+    std::fill(next_cells_.begin(), next_cells_.end(), CELL_EMPTY);
+    auto mark = [&](const Position& pos, uint8_t contents) {
+        if (pos.size() < 2) return;
+        int column = pos[0] + GameConfig::GRID_SIZE_X / 2;
+        int row = GameConfig::GRID_SIZE_Y / 2 - 1 - pos[1];
+        if (column >= 0 && column < GameConfig::GRID_SIZE_X && row >= 0 && row < GameConfig::GRID_SIZE_Y) {
+            next_cells_[row * GameConfig::GRID_SIZE_X + column] = contents;
+        }
+    };
+    const auto& positions = snake.getAllPositions();
+    for (size_t i = 0; i < positions.size(); ++i) {
+        mark(positions[i], i == 0 ? CELL_HEAD : CELL_BODY);
+    }
+    mark(apple.getPosition(), CELL_APPLE);
+
+    // Repaint only what differs from the current frame
+    for (size_t index = 0; index < next_cells_.size(); ++index) {
+        if (!valid_ || next_cells_[index] != cells_[index]) {
+            paintCell(index % GameConfig::GRID_SIZE_X, index / GameConfig::GRID_SIZE_X, next_cells_[index]);
+        }
+    }
+    cells_.swap(next_cells_);
+    valid_ = true;
+    return frame_.data();
+}
+
+const uint8_t* PixelRenderer::render(const Game& game) {
+    return render(game.getSnake(), game.getApple());
+}
+
+void PixelRenderer::invalidate() {
+    valid_ = false;
+}
+
+const uint8_t* PixelRenderer::frame() const {
+    return frame_.data();
+}
+
+size_t PixelRenderer::width() const {
+    return config_.width;
+}
+
+size_t PixelRenderer::height() const {
+    return config_.height;
+}
+
+size_t PixelRenderer::channels() const {
+    return channels_;
+}
+
+size_t PixelRenderer::frameSize() const {
+    return frame_.size();
+}
+
+size_t PixelRenderer::getCellsPainted() const {
+    return cells_painted_;
+}
+
+std::vector<uint8_t> PixelRenderer::palette() {
+    std::vector<uint8_t> colors;
+    for (const auto& color : RGB_COLORS) {
+        colors.insert(colors.end(), color, color + 3);
+    }
+    return colors;
+}
+
+void PixelRenderer::paintCell(size_t column, size_t row, uint8_t contents) {
+    const size_t x = column_edges_[column] * channels_;
+    const size_t row_bytes = (column_edges_[column + 1] - column_edges_[column]) * channels_;
+    const size_t stride = config_.width * channels_;
+    const uint8_t* color_row = color_rows_[contents].data();
+    for (size_t y = row_edges_[row]; y < row_edges_[row + 1]; ++y) {
+        copyRow(frame_.data() + y * stride + x, color_row, row_bytes);
+    }
+    cells_painted_++;
+}
+
+// FrameStack implementation
+FrameStack::FrameStack(size_t frame_size, size_t depth)
+    : frame_size_(frame_size)
+    , depth_(depth)
+    , oldest_(0)
+    , buffer_(2 * frame_size * depth, 0) {
+    if (frame_size == 0 || depth == 0) {
+        throw std::invalid_argument("Frame stack needs a positive frame size and depth");
+    }
+}
+
+void FrameStack::reset(const uint8_t* frame) {
+    for (size_t slot = 0; slot < 2 * depth_; ++slot) {
+        std::memcpy(buffer_.data() + slot * frame_size_, frame, frame_size_);
+    }
+    oldest_ = 0;
+}
+
+void FrameStack::push(const uint8_t* frame) {
+    // The oldest frame's two slots take the new one, which then ends both windows
+    std::memcpy(buffer_.data() + oldest_ * frame_size_, frame, frame_size_);
+    std::memcpy(buffer_.data() + (oldest_ + depth_) * frame_size_, frame, frame_size_);
+    oldest_ = (oldest_ + 1) % depth_;
+}
+
+const uint8_t* FrameStack::observation() const {
+    return buffer_.data() + oldest_ * frame_size_;
+}
+
+size_t FrameStack::depth() const {
+    return depth_;
+}
+
+size_t FrameStack::frameSize() const {
+    return frame_size_;
+}
+
+size_t FrameStack::observationSize() const {
+    return frame_size_ * depth_;
+}
+
+} // namespace SnakeGame::RL
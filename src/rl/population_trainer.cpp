@@ -0,0 +1,182 @@
+#include "rl/population_trainer.h"
+#include "rl/evaluation_engine.h"
+#include "rl/metrics_sink.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+
+namespace SnakeGame::RL {
+
+namespace {
+
+// Per-member state kept across rounds
+struct Member {
+    MemberResult result;
+    std::unique_ptr<Agent> agent;
+    std::unique_ptr<SnakeEnvironment> env;
+    RollingWindow scores;
+    double epsilon = 0.0;
+    double round_seconds = 0.0;
+
+    explicit Member(size_t window) : scores(window) {}
+};
+
+double perturbNearOne(double value, double factor) {
+    return std::clamp(1.0 - (1.0 - value) * factor, 0.5, 0.9999);
+}
+
+void applyHyperParameters(Member& member) {
+    member.agent->setLearningRate(member.result.params.learning_rate);
+    member.agent->setDiscountFactor(member.result.params.discount_factor);
+    member.agent->setEpsilon(member.epsilon);
+}
+
+void trainRound(Member& member, const PopulationConfig& config, size_t episodes) {
+    auto start = std::chrono::steady_clock::now();
+    Agent& agent = *member.agent;
+    SnakeEnvironment& env = *member.env;
+    for (size_t episode = 0; episode < episodes; ++episode) {
+        auto state = env.reset();
+        while (!env.isDone()) {
+            int action = agent.selectAction(state);
+            auto [next_state, reward] = env.step(action);
+            agent.update(state, action, reward, next_state, env.isDone());
+            state = std::move(next_state);
+        }
+        std::vector<double> info = env.getInfo();
+        member.scores.push(info.empty() ? 0.0 : info[0]);
+        member.epsilon = std::max(config.min_epsilon, member.epsilon * member.result.params.epsilon_decay);
+        agent.setEpsilon(member.epsilon);
+    }
+    member.result.fitness = member.scores.mean();
+    member.round_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+PopulationTrainer::PopulationTrainer(const PopulationConfig& config)
+    : config_(config)
+    , pool_(config.num_threads) {
+    if (config_.ready_episodes == 0 || config_.max_episodes == 0) {
+        throw std::invalid_argument("Population training needs positive ready and max episodes");
+    }
+    if (config_.truncation <= 0.0 || config_.truncation > 0.5) {
+        throw std::invalid_argument("Truncation fraction must be in (0, 0.5]");
+    }
+}
+
+PopulationReport PopulationTrainer::run(const PopulationAgentFactory& make_agent,
+                                        const std::vector<HyperParameters>& initial) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Member> members;
+    members.reserve(initial.size());
+    for (size_t id = 0; id < initial.size(); ++id) {
+        members.emplace_back(config_.fitness_window);
+        members[id].result.id = id;
+        members[id].result.parent = id;
+        members[id].result.params = initial[id];
+        members[id].epsilon = initial[id].epsilon;
+    }
+
+    // Agents and environments are built on the workers, in parallel
+    pool_.parallelFor(members.size(), [&](size_t id, size_t) {
+        Member& member = members[id];
+        uint64_t seed = EvaluationEngine::episodeSeed(config_.seed, id);
+        member.agent = make_agent(member.result.params, static_cast<unsigned int>(seed >> 32));
+        member.env = std::make_unique<SnakeEnvironment>(true);
+        member.env->setMaxSteps(config_.max_steps);
+        member.env->setRewardStructure(10.0, -100.0, -1.0);
+        member.env->setSeed(static_cast<unsigned int>(seed));
+        applyHyperParameters(member);
+    });
+
+    PopulationReport report;
+    report.threads = pool_.size();
+    std::mt19937_64 rng(config_.seed);
+    std::vector<size_t> order(members.size());
+    for (size_t id = 0; id < members.size(); ++id) {
+        order[id] = id;
+    }
+
+    size_t episodes_done = 0;
+    while (episodes_done < config_.max_episodes && !members.empty()) {
+        // Slowest member first: its episodes are the longest (it plays best)
+        const size_t episodes = std::min(config_.ready_episodes, config_.max_episodes - episodes_done);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            double time_a = members[a].round_seconds, time_b = members[b].round_seconds;
+            return time_a != time_b ? time_a > time_b : a < b;
+        });
+        pool_.parallelFor(order.size(), [&](size_t index, size_t) {
+            trainRound(members[order[index]], config_, episodes);
+        });
+        episodes_done += episodes;
+
+        PopulationRound round;
+        round.episodes = episodes_done;
+        std::vector<size_t> ranked(order);
+        std::sort(ranked.begin(), ranked.end(), [&](size_t a, size_t b) {
+            double fitness_a = members[a].result.fitness, fitness_b = members[b].result.fitness;
+            return fitness_a != fitness_b ? fitness_a > fitness_b : a < b;
+        });
+        for (const Member& member : members) {
+            round.mean_fitness += member.result.fitness / members.size();
+            report.busy_seconds += member.round_seconds;
+        }
+        round.best_fitness = members[ranked.front()].result.fitness;
+        round.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        bool reached = config_.target_score > 0.0 && round.best_fitness >= config_.target_score;
+        if (reached && report.target_seconds < 0.0) {
+            report.target_seconds = round.seconds;
+            report.target_episodes = episodes_done;
+        }
+
+        // Exploit: the bottom fraction copies a random top member; explore: perturb the copy
+        if (config_.exploit && !reached && episodes_done < config_.max_episodes && members.size() >= 2) {
+            size_t cut = std::max<size_t>(1, static_cast<size_t>(members.size() * config_.truncation));
+            std::uniform_int_distribution<size_t> pick_source(0, cut - 1);
+            std::bernoulli_distribution coin(0.5);
+            auto clone_start = std::chrono::steady_clock::now();
+            for (size_t i = members.size() - cut; i < members.size(); ++i) {
+                Member& target = members[ranked[i]];
+                const Member& source = members[ranked[pick_source(rng)]];
+
+                target.agent->copyFrom(*source.agent); // Reuses the target's table or network storage
+                target.agent->setSeed(static_cast<unsigned int>(rng()));
+                target.scores = source.scores;
+                target.result.fitness = source.result.fitness;
+                target.result.parent = source.result.id;
+                target.result.exploits++;
+
+                auto factor = [&]() { return coin(rng) ? config_.perturb_factor : 1.0 / config_.perturb_factor; };
+                HyperParameters params = source.result.params;
+                params.learning_rate = std::clamp(params.learning_rate * factor(), 1e-6, 1.0);
+                params.discount_factor = perturbNearOne(params.discount_factor, factor());
+                params.epsilon_decay = perturbNearOne(params.epsilon_decay, factor());
+                target.result.params = params;
+                target.epsilon = std::clamp(source.epsilon * factor(), config_.min_epsilon, 1.0);
+                applyHyperParameters(target);
+                round.exploits++;
+            }
+            report.clone_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - clone_start).count();
+            report.exploits += round.exploits;
+        }
+        report.rounds.push_back(round);
+        if (reached) {
+            break;
+        }
+    }
+
+    for (Member& member : members) {
+        member.result.params.epsilon = member.epsilon;
+        report.members.push_back(member.result);
+    }
+    std::sort(report.members.begin(), report.members.end(), [](const MemberResult& a, const MemberResult& b) {
+        return a.fitness != b.fitness ? a.fitness > b.fitness : a.id < b.id;
+    });
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+} // namespace SnakeGame::RL
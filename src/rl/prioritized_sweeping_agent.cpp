@@ -0,0 +1,316 @@
+#include "rl/prioritized_sweeping_agent.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace SnakeGame::RL {
+
+namespace {
+
+constexpr double DEFAULT_PRIORITY_THRESHOLD = 1e-4;
+constexpr size_t DEFAULT_MAX_PREDECESSORS = 32;
+constexpr size_t BUDGET_CHECK_INTERVAL = 8; // Planning updates between clock reads
+constexpr size_t INITIAL_STATE_SLOTS = 1024; // Power of two
+
+} // namespace
+
+PrioritizedSweepingAgent::PrioritizedSweepingAgent(double learning_rate, double discount_factor,
+                                                   double epsilon, size_t planning_steps)
+    : QLearningAgent(learning_rate, discount_factor, epsilon)
+    , planning_steps_(planning_steps)
+    , planning_budget_(0)
+    , priority_threshold_(DEFAULT_PRIORITY_THRESHOLD)
+    , max_predecessors_(DEFAULT_MAX_PREDECESSORS)
+    , slot_shift_(64)
+    , live_items_(0)
+    , planning_updates_(0)
+    , planning_seconds_(0.0) {
+    rehashStates(INITIAL_STATE_SLOTS);
+}
+
+std::unique_ptr<Agent> PrioritizedSweepingAgent::clone() const {
+    auto copy = std::make_unique<PrioritizedSweepingAgent>(learning_rate_, discount_factor_, epsilon_, planning_steps_);
+    copy->copyFrom(*this);
+    return copy;
+}
+
+void PrioritizedSweepingAgent::copyFrom(const Agent& other) {
+    const auto* source = dynamic_cast<const PrioritizedSweepingAgent*>(&other);
+    if (!source) {
+        throw std::invalid_argument("Cannot copy a different agent type into a PrioritizedSweepingAgent");
+    }
+    QLearningAgent::copyFrom(*source);
+    planning_steps_ = source->planning_steps_;
+    planning_budget_ = source->planning_budget_;
+    priority_threshold_ = source->priority_threshold_;
+    max_predecessors_ = source->max_predecessors_;
+    state_slots_ = source->state_slots_;
+    slot_shift_ = source->slot_shift_;
+    state_keys_ = source->state_keys_;
+    first_predecessor_ = source->first_predecessor_;
+    successor_ = source->successor_;
+    reward_ = source->reward_;
+    next_predecessor_ = source->next_predecessor_;
+    prev_predecessor_ = source->prev_predecessor_;
+    queue_ = source->queue_;
+    queued_priority_ = source->queued_priority_;
+    live_items_ = source->live_items_;
+}
+
+void PrioritizedSweepingAgent::update(const std::vector<double>& state, int action,
+                                      double reward, const std::vector<double>& next_state, bool done) {
+    CanonicalState canonical = encodeState(state);
+    int canonical_action = StateSymmetry::toCanonicalAction(action, canonical.transform);
+
+    uint32_t index = findOrAddState(canonical.key);
+    uint32_t next_index = done ? NONE : findOrAddState(encodeState(next_state).key);
+    uint32_t pair = index * QTable::NUM_ACTIONS + canonical_action;
+    recordTransition(pair, reward, next_index, done);
+
+    // Direct Q-learning update, then let the change flow back through the model
+    backup(pair);
+    queuePredecessors(index);
+    plan();
+}
+
+void PrioritizedSweepingAgent::setPlanningSteps(size_t steps) {
+    planning_steps_ = steps;
+}
+
+void PrioritizedSweepingAgent::setPlanningBudget(std::chrono::microseconds budget) {
+    if (budget.count() < 0) {
+        throw std::invalid_argument("Planning budget must not be negative");
+    }
+    planning_budget_ = budget;
+}
+
+void PrioritizedSweepingAgent::setPriorityThreshold(double threshold) {
+    priority_threshold_ = threshold;
+}
+
+void PrioritizedSweepingAgent::setPredecessorLimit(size_t limit) {
+    if (limit == 0) {
+        throw std::invalid_argument("Predecessor limit must be positive");
+    }
+    max_predecessors_ = limit;
+}
+
+size_t PrioritizedSweepingAgent::getModelSize() const {
+    return state_keys_.size();
+}
+
+size_t PrioritizedSweepingAgent::getModelBytes() const {
+    // Vectors by capacity
+    size_t bytes = state_slots_.capacity() * sizeof(uint32_t)
+                 + state_keys_.capacity() * sizeof(StateKey)
+                 + first_predecessor_.capacity() * sizeof(uint32_t)
+                 + successor_.capacity() * sizeof(uint32_t)
+                 + reward_.capacity() * sizeof(float)
+                 + next_predecessor_.capacity() * sizeof(uint32_t)
+                 + prev_predecessor_.capacity() * sizeof(uint32_t)
+                 + queued_priority_.capacity() * sizeof(float)
+                 + queue_.capacity() * sizeof(QueueItem);
+    return bytes;
+}
+
+size_t PrioritizedSweepingAgent::getQueueSize() const {
+    return live_items_;
+}
+
+size_t PrioritizedSweepingAgent::getPlanningUpdates() const {
+    return planning_updates_;
+}
+
+double PrioritizedSweepingAgent::getPlanningSeconds() const {
+    return planning_seconds_;
+}
+
+double PrioritizedSweepingAgent::getPlanningUpdatesPerSecond() const {
+    return planning_seconds_ > 0.0 ? planning_updates_ / planning_seconds_ : 0.0;
+}
+
+size_t PrioritizedSweepingAgent::homeSlot(StateKey key) const {
+    // Fibonacci hashing, as in QTable
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> slot_shift_);
+}
+
+uint32_t PrioritizedSweepingAgent::findOrAddState(StateKey key) {
+    const size_t mask = state_slots_.size() - 1;
+    size_t slot = homeSlot(key);
+    for (; state_slots_[slot] != NONE; slot = (slot + 1) & mask) {
+        if (state_keys_[state_slots_[slot]] == key) {
+            return state_slots_[slot];
+        }
+    }
+    if (state_keys_.size() >= NONE / QTable::NUM_ACTIONS) {
+        throw std::runtime_error("Planning model is full");
+    }
+
+    const uint32_t index = static_cast<uint32_t>(state_keys_.size());
+    state_slots_[slot] = index;
+    state_keys_.push_back(key);
+    first_predecessor_.push_back(NONE);
+    size_t pairs = state_keys_.size() * QTable::NUM_ACTIONS;
+    successor_.resize(pairs, NONE);
+    reward_.resize(pairs, 0.0f);
+    next_predecessor_.resize(pairs, NONE);
+    prev_predecessor_.resize(pairs, NONE);
+    queued_priority_.resize(pairs, 0.0f);
+
+    // Keep the index at most half full so probe runs stay short
+    if (state_keys_.size() * 2 > state_slots_.size()) {
+        rehashStates(state_slots_.size() * 2);
+    }
+    return index;
+}
+
+void PrioritizedSweepingAgent::rehashStates(size_t slots) {
+    state_slots_.assign(slots, NONE);
+    slot_shift_ = 64;
+    for (size_t capacity = slots; capacity > 1; capacity >>= 1) {
+        slot_shift_--;
+    }
+
+    const size_t mask = slots - 1;
+    for (uint32_t index = 0; index < state_keys_.size(); ++index) {
+        size_t slot = homeSlot(state_keys_[index]);
+        while (state_slots_[slot] != NONE) {
+            slot = (slot + 1) & mask;
+        }
+        state_slots_[slot] = index;
+    }
+}
+
+void PrioritizedSweepingAgent::recordTransition(uint32_t pair, double reward, uint32_t next_state, bool done) {
+    // Only the latest outcome is kept; relinking also moves the pair to the
+    // front of its successor's list, so the most recent predecessors are swept first
+    reward_[pair] = static_cast<float>(reward);
+    if (successor_[pair] != NONE) {
+        unlinkPredecessor(pair);
+    }
+    successor_[pair] = done ? NONE : next_state;
+    if (successor_[pair] != NONE) {
+        linkPredecessor(pair, successor_[pair]);
+    }
+}
+
+void PrioritizedSweepingAgent::linkPredecessor(uint32_t pair, uint32_t state) {
+    uint32_t head = first_predecessor_[state];
+    next_predecessor_[pair] = head;
+    prev_predecessor_[pair] = NONE;
+    if (head != NONE) {
+        prev_predecessor_[head] = pair;
+    }
+    first_predecessor_[state] = pair;
+}
+
+void PrioritizedSweepingAgent::unlinkPredecessor(uint32_t pair) {
+    uint32_t next = next_predecessor_[pair];
+    uint32_t prev = prev_predecessor_[pair];
+    if (prev != NONE) {
+        next_predecessor_[prev] = next;
+    } else {
+        first_predecessor_[successor_[pair]] = next;
+    }
+    if (next != NONE) {
+        prev_predecessor_[next] = prev;
+    }
+    next_predecessor_[pair] = NONE;
+    prev_predecessor_[pair] = NONE;
+}
+
+double PrioritizedSweepingAgent::tdError(uint32_t pair) const {
+    StateKey key = state_keys_[pair / QTable::NUM_ACTIONS];
+    int action = static_cast<int>(pair % QTable::NUM_ACTIONS);
+
+    double target = reward_[pair];
+    if (successor_[pair] != NONE) {
+        target += discount_factor_ * getMaxQValue(state_keys_[successor_[pair]]);
+    }
+
+    QTable::Row scratch;
+    const QTable::Row* row = findRow(key, scratch);
+    return target - (row ? row->q[action] : 0.0);
+}
+
+void PrioritizedSweepingAgent::backup(uint32_t pair) {
+    addToQValue(state_keys_[pair / QTable::NUM_ACTIONS], static_cast<int>(pair % QTable::NUM_ACTIONS),
+                learning_rate_ * tdError(pair));
+}
+
+void PrioritizedSweepingAgent::queuePair(uint32_t pair, double priority) {
+    float value = static_cast<float>(priority);
+    if (priority < priority_threshold_ || value <= queued_priority_[pair]) {
+        return;
+    }
+
+    // A raised priority supersedes the pair's older queue item
+    if (queued_priority_[pair] == 0.0f) {
+        live_items_++;
+    }
+    queued_priority_[pair] = value;
+    queue_.push_back({value, pair});
+    std::push_heap(queue_.begin(), queue_.end());
+
+    if (queue_.size() > 2 * live_items_ + 1024) {
+        compactQueue();
+    }
+}
+
+void PrioritizedSweepingAgent::queuePredecessors(uint32_t state) {
+    uint32_t pair = first_predecessor_[state];
+    for (size_t count = 0; pair != NONE && count < max_predecessors_; ++count) {
+        queuePair(pair, std::abs(tdError(pair)));
+        pair = next_predecessor_[pair];
+    }
+}
+
+bool PrioritizedSweepingAgent::popPair(uint32_t& pair) {
+    while (!queue_.empty()) {
+        std::pop_heap(queue_.begin(), queue_.end());
+        QueueItem item = queue_.back();
+        queue_.pop_back();
+        if (item.priority == queued_priority_[item.pair]) {
+            queued_priority_[item.pair] = 0.0f;
+            live_items_--;
+            pair = item.pair;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PrioritizedSweepingAgent::compactQueue() {
+    queue_.erase(std::remove_if(queue_.begin(), queue_.end(),
+                                [this](const QueueItem& item) {
+                                    return item.priority != queued_priority_[item.pair];
+                                }),
+                 queue_.end());
+    std::make_heap(queue_.begin(), queue_.end());
+}
+
+void PrioritizedSweepingAgent::plan() {
+    if (planning_steps_ == 0 || live_items_ == 0) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + planning_budget_;
+    size_t updates = 0;
+    uint32_t pair;
+    while (updates < planning_steps_ && popPair(pair)) {
+        backup(pair);
+        queuePredecessors(pair / QTable::NUM_ACTIONS);
+        updates++;
+
+        if (planning_budget_.count() > 0 && updates % BUDGET_CHECK_INTERVAL == 0 &&
+            std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+    }
+
+    planning_updates_ += updates;
+    planning_seconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace SnakeGame::RL
@@ -1,18 +1,33 @@
 #include "rl/q_learning_agent.h"
+#include "rl/checkpoint_writer.h"
+#include "rl/delta_checkpoint.h"
+#include "rl/metrics_sink.h"
 #include <algorithm>
+#include <charconv>
 #include <fstream>
 #include <iostream>
-#include <sstream>
 #include <iomanip>
 
 namespace SnakeGame::RL {
 
+namespace {
+
+bool isDeltaCheckpointPath(const std::string& path) {
+    const std::string extension = ".qck";
+    return path.size() >= extension.size() &&
+           path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+} // namespace
+
 QLearningAgent::QLearningAgent(double learning_rate, double discount_factor, double epsilon)
     : learning_rate_(learning_rate)
     , discount_factor_(discount_factor)
     , epsilon_(epsilon)
     , epsilon_decay_(0.995)
     , min_epsilon_(0.01)
+    , use_symmetry_(false)
+    , checkpoint_interval_(0)
     , gen_(rd_())
     , uniform_dist_(0.0, 1.0)
     , total_steps_(0)
@@ -21,39 +36,82 @@ QLearningAgent::QLearningAgent(double learning_rate, double discount_factor, dou
 
 int QLearningAgent::selectAction(const std::vector<double>& state) {
     total_steps_++;
-    std::string state_str = stateToString(state);
+    CanonicalState canonical = encodeState(state);
     
     // Epsilon-greedy action selection
     if (uniform_dist_(gen_) < epsilon_) {
         exploration_steps_++;
         return selectRandomAction();
     } else {
-        return selectGreedyAction(state_str);
+        int action = selectGreedyAction(canonical.key);
+        return StateSymmetry::fromCanonicalAction(action, canonical.transform);
+    }
+}
+
+void QLearningAgent::selectActions(const StateBatch& states, std::vector<int>& actions) {
+    // Number of rows whose table slots are prefetched ahead of the lookup
+    constexpr size_t PREFETCH_DISTANCE = 8;
+    
+    const size_t batch_size = states.size();
+    actions.resize(batch_size);
+    key_scratch_.resize(batch_size);
+    transform_scratch_.assign(batch_size, StateSymmetry::IDENTITY);
+    
+    // Encode every key first so the lookups below can be overlapped
+    StateEncoder::encodeBatch(states, key_scratch_.data());
+    if (use_symmetry_) {
+        for (size_t i = 0; i < batch_size; ++i) {
+            CanonicalState canonical = StateSymmetry::canonicalize(key_scratch_[i]);
+            key_scratch_[i] = canonical.key;
+            transform_scratch_[i] = canonical.transform;
+        }
+    }
+    for (size_t i = 0; i < std::min(batch_size, PREFETCH_DISTANCE); ++i) {
+        prefetchRow(key_scratch_[i]);
+    }
+    
+    for (size_t i = 0; i < batch_size; ++i) {
+        if (i + PREFETCH_DISTANCE < batch_size) {
+            prefetchRow(key_scratch_[i + PREFETCH_DISTANCE]);
+        }
+        
+        total_steps_++;
+        if (uniform_dist_(gen_) < epsilon_) {
+            exploration_steps_++;
+            actions[i] = selectRandomAction();
+        } else {
+            int action = selectGreedyAction(key_scratch_[i]);
+            actions[i] = StateSymmetry::fromCanonicalAction(action, transform_scratch_[i]);
+        }
     }
 }
 
 void QLearningAgent::update(const std::vector<double>& state, int action,
                            double reward, const std::vector<double>& next_state, bool done) {
-    std::string state_str = stateToString(state);
-    std::string next_state_str = stateToString(next_state);
-    
-    // Initialize Q-values if not exists
-    initializeQValue(state_str, action);
+    CanonicalState canonical = encodeState(state);
+    int canonical_action = StateSymmetry::toCanonicalAction(action, canonical.transform);
     
-    // Calculate Q-learning update
-    double current_q = q_table_[state_str][action];
-    double max_next_q = done ? 0.0 : getMaxQValue(next_state_str);
+    // Look up the bootstrap value before inserting, which may rehash the table
+    // (the max over actions does not depend on how the actions are labelled)
+    double max_next_q = done ? 0.0 : getMaxQValue(encodeState(next_state).key);
     double target_q = reward + discount_factor_ * max_next_q;
     
-    // Update Q-value
-    q_table_[state_str][action] = current_q + learning_rate_ * (target_q - current_q);
+    // Update Q-value (unseen states start at zero)
+    if (shared_table_) {
+        shared_table_->update(canonical.key, canonical_action, target_q, learning_rate_);
+        return;
+    }
+    double& current_q = q_table_.findOrInsert(canonical.key).q[canonical_action];
+    current_q += learning_rate_ * (target_q - current_q);
 }
 
 void QLearningAgent::train(Environment& env, size_t episodes) {
     std::cout << "Training Q-Learning agent for " << episodes << " episodes..." << std::endl;
     
-    std::vector<double> episode_rewards;
-    std::vector<double> episode_lengths;
+    RollingWindow episode_rewards(100);
+    RollingWindow episode_lengths(100);
+    QTableStats last_stats = getTableStats();
+    size_t last_checkpoint = 0;
     
     for (size_t episode = 0; episode < episodes; ++episode) {
         auto state = env.reset();
@@ -72,33 +130,59 @@ void QLearningAgent::train(Environment& env, size_t episodes) {
             steps++;
         }
         
-        episode_rewards.push_back(total_reward);
-        episode_lengths.push_back(static_cast<double>(steps));
+        episode_rewards.push(total_reward);
+        episode_lengths.push(static_cast<double>(steps));
         
         // Decay epsilon
         epsilon_ = std::max(min_epsilon_, epsilon_ * epsilon_decay_);
         
-        // Print progress
-        if ((episode + 1) % 100 == 0) {
-            double avg_reward = 0.0;
-            double avg_length = 0.0;
-            size_t recent_episodes = std::min(size_t(100), episode + 1);
+        if (metrics_channel_) {
+            EpisodeMetrics metrics;
+            metrics.episode = episode + 1;
+            metrics.reward = total_reward;
+            metrics.length = static_cast<uint32_t>(steps);
+            std::vector<double> info = env.getInfo();
+            metrics.score = info.empty() ? 0 : static_cast<uint32_t>(info[0]);
+            metrics.epsilon = epsilon_;
+            metrics.table_size = getTableStats().size;
+            metrics_channel_->record(metrics);
+        }
+        
+        // Checkpoints are skipped rather than waited for while the writer is busy
+        if (checkpoint_writer_ && (episode + 1) % checkpoint_interval_ == 0 &&
+            checkpoint_writer_->submit(*this, episode + 1)) {
+            last_checkpoint = episode + 1;
+        }
+        
+        // Print progress (the metrics sink reports on its own thread when attached)
+        if (!metrics_channel_ && (episode + 1) % 100 == 0) {
+            double avg_reward = episode_rewards.mean();
+            double avg_length = episode_lengths.mean();
             
-            for (size_t i = episode + 1 - recent_episodes; i <= episode; ++i) {
-                avg_reward += episode_rewards[i];
-                avg_length += episode_lengths[i];
-            }
-            avg_reward /= recent_episodes;
-            avg_length /= recent_episodes;
+            // Table statistics over the last reporting window
+            QTableStats stats = getTableStats();
+            size_t window_lookups = stats.lookups - last_stats.lookups;
+            double hit_rate = window_lookups == 0 ? 0.0
+                : static_cast<double>(stats.hits - last_stats.hits) / window_lookups * 100.0;
+            last_stats = stats;
             
             std::cout << "Episode " << episode + 1 
                      << " | Avg Reward: " << std::fixed << std::setprecision(2) << avg_reward
                      << " | Avg Length: " << std::fixed << std::setprecision(1) << avg_length
                      << " | Epsilon: " << std::fixed << std::setprecision(3) << epsilon_
-                     << " | Q-table size: " << q_table_.size() << std::endl;
+                     << " | Q-table size: " << stats.size
+                     << " | Mem: " << std::fixed << std::setprecision(1) << stats.bytes_used / (1024.0 * 1024.0) << " MB"
+                     << " | Hit rate: " << std::fixed << std::setprecision(1) << hit_rate << "%"
+                     << " | Evictions: " << stats.evictions << '\n' << std::flush;
         }
     }
     
+    // The final state is always checkpointed, waiting for the writer if needed
+    if (checkpoint_writer_ && last_checkpoint != episodes) {
+        checkpoint_writer_->flush();
+        checkpoint_writer_->submit(*this, episodes);
+    }
+    
     double exploration_rate = static_cast<double>(exploration_steps_) / total_steps_ * 100.0;
     std::cout << "Training completed! Exploration rate: " << std::fixed << std::setprecision(1) 
               << exploration_rate << "%" << std::endl;
@@ -110,8 +194,10 @@ void QLearningAgent::evaluate(Environment& env, size_t episodes) {
     double old_epsilon = epsilon_;
     epsilon_ = 0.0; // No exploration during evaluation
     
-    std::vector<double> episode_rewards;
-    std::vector<double> episode_lengths;
+    // Per-episode lines are rate limited; the averages cover every episode
+    RateLimiter progress_limiter(std::chrono::milliseconds(500));
+    double total_reward_sum = 0.0;
+    double total_length_sum = 0.0;
     
     for (size_t episode = 0; episode < episodes; ++episode) {
         auto state = env.reset();
@@ -127,51 +213,60 @@ void QLearningAgent::evaluate(Environment& env, size_t episodes) {
             steps++;
         }
         
-        episode_rewards.push_back(total_reward);
-        episode_lengths.push_back(static_cast<double>(steps));
+        total_reward_sum += total_reward;
+        total_length_sum += static_cast<double>(steps);
         
-        std::cout << "Eval Episode " << episode + 1 
-                 << " | Reward: " << total_reward 
-                 << " | Length: " << steps << std::endl;
-    }
-    
-    // Calculate statistics
-    double total_reward = 0.0, total_length = 0.0;
-    for (size_t i = 0; i < episodes; ++i) {
-        total_reward += episode_rewards[i];
-        total_length += episode_lengths[i];
+        if (episode == 0 || episode + 1 == episodes || progress_limiter.allow()) {
+            std::cout << "Eval Episode " << episode + 1 
+                     << " | Reward: " << total_reward 
+                     << " | Length: " << steps << '\n';
+        }
     }
     
     std::cout << "Evaluation completed!" << std::endl;
-    std::cout << "Average Reward: " << total_reward / episodes << std::endl;
-    std::cout << "Average Length: " << total_length / episodes << std::endl;
+    std::cout << "Average Reward: " << total_reward_sum / episodes << std::endl;
+    std::cout << "Average Length: " << total_length_sum / episodes << std::endl;
     
     epsilon_ = old_epsilon; // Restore epsilon
 }
 
 void QLearningAgent::save(const std::string& filepath) {
+    if (isDeltaCheckpointPath(filepath)) {
+        if (!delta_writer_ || delta_writer_->getPath() != filepath) {
+            delta_writer_ = std::make_shared<DeltaCheckpointWriter>(filepath);
+        }
+        ModelSnapshot snapshot;
+        takeSnapshot(snapshot);
+        DeltaCheckpointStats stats = delta_writer_->write(snapshot);
+        std::cout << "Q-Learning agent saved to: "
+                  << (stats.base ? filepath : DeltaCheckpointWriter::deltaPath(filepath, stats.sequence))
+                  << " (" << stats.changed_rows << " changed rows, " << stats.bytes << " bytes)" << std::endl;
+        return;
+    }
+    
     std::ofstream file(filepath);
     if (!file.is_open()) {
         throw std::runtime_error("Could not open file for saving: " + filepath);
     }
     
-    // Save hyperparameters
-    file << learning_rate_ << " " << discount_factor_ << " " << epsilon_ << " " 
-         << epsilon_decay_ << " " << min_epsilon_ << std::endl;
-    
-    // Save Q-table
-    file << q_table_.size() << std::endl;
-    for (const auto& state_entry : q_table_) {
-        file << state_entry.first << " " << state_entry.second.size() << std::endl;
-        for (const auto& action_entry : state_entry.second) {
-            file << action_entry.first << " " << action_entry.second << std::endl;
-        }
-    }
+    ModelSnapshot snapshot;
+    takeSnapshot(snapshot);
+    snapshot.write(file);
     
     std::cout << "Q-Learning agent saved to: " << filepath << std::endl;
 }
 
 void QLearningAgent::load(const std::string& filepath) {
+    if (DeltaCheckpointWriter::isDeltaCheckpoint(filepath)) {
+        ModelSnapshot snapshot;
+        DeltaChainInfo info = DeltaCheckpointWriter::load(filepath, snapshot);
+        restoreSnapshot(snapshot);
+        std::cout << "Q-Learning agent loaded from: " << filepath << " (base + "
+                  << info.files - 1 << " deltas)" << std::endl;
+        std::cout << "Q-table size: " << getTableStats().size << " states" << std::endl;
+        return;
+    }
+    
     std::ifstream file(filepath);
     if (!file.is_open()) {
         throw std::runtime_error("Could not open file for loading: " + filepath);
@@ -180,6 +275,11 @@ void QLearningAgent::load(const std::string& filepath) {
     // Load hyperparameters
     file >> learning_rate_ >> discount_factor_ >> epsilon_ >> epsilon_decay_ >> min_epsilon_;
     
+    // Optional flags after the hyperparameters (absent in older models)
+    std::string flags;
+    std::getline(file, flags);
+    use_symmetry_ = flags.find("symmetric") != std::string::npos;
+    
     // Load Q-table
     size_t num_states;
     file >> num_states;
@@ -190,16 +290,118 @@ void QLearningAgent::load(const std::string& filepath) {
         size_t num_actions;
         file >> state >> num_actions;
         
+        // Older models store the state as a comma-separated feature string
+        StateKey key = (state.find(',') != std::string::npos)
+            ? StateEncoder::encode(StateEncoder::parseStateString(state))
+            : std::stoull(state);
+        QTable::Row row{};
+        
         for (size_t j = 0; j < num_actions; ++j) {
             int action;
             double q_value;
             file >> action >> q_value;
-            q_table_[state][action] = q_value;
+            if (action >= 0 && action < QTable::NUM_ACTIONS) {
+                row.q[action] = q_value;
+            }
+        }
+        
+        if (shared_table_) {
+            shared_table_->store(key, row);
+        } else {
+            q_table_.findOrInsert(key) = row;
         }
     }
     
     std::cout << "Q-Learning agent loaded from: " << filepath << std::endl;
-    std::cout << "Q-table size: " << q_table_.size() << " states" << std::endl;
+    std::cout << "Q-table size: " << getTableStats().size << " states" << std::endl;
+}
+
+void QLearningAgent::takeSnapshot(ModelSnapshot& snapshot) const {
+    snapshot.learning_rate = learning_rate_;
+    snapshot.discount_factor = discount_factor_;
+    snapshot.epsilon = epsilon_;
+    snapshot.epsilon_decay = epsilon_decay_;
+    snapshot.min_epsilon = min_epsilon_;
+    snapshot.symmetric = use_symmetry_;
+    
+    snapshot.keys.clear();
+    snapshot.rows.clear();
+    auto copy_row = [&snapshot](StateKey key, const QTable::Row& row) {
+        snapshot.keys.push_back(key);
+        snapshot.rows.push_back(row);
+    };
+    if (shared_table_) {
+        shared_table_->forEach(copy_row);
+    } else {
+        snapshot.keys.reserve(q_table_.size());
+        snapshot.rows.reserve(q_table_.size());
+        q_table_.forEach(copy_row);
+    }
+}
+
+void QLearningAgent::restoreSnapshot(const ModelSnapshot& snapshot) {
+    learning_rate_ = snapshot.learning_rate;
+    discount_factor_ = snapshot.discount_factor;
+    epsilon_ = snapshot.epsilon;
+    epsilon_decay_ = snapshot.epsilon_decay;
+    min_epsilon_ = snapshot.min_epsilon;
+    use_symmetry_ = snapshot.symmetric;
+    
+    q_table_.clear();
+    for (size_t i = 0; i < snapshot.keys.size(); ++i) {
+        if (shared_table_) {
+            shared_table_->store(snapshot.keys[i], snapshot.rows[i]);
+        } else {
+            q_table_.findOrInsert(snapshot.keys[i]) = snapshot.rows[i];
+        }
+    }
+}
+
+void QLearningAgent::setCheckpointWriter(std::shared_ptr<CheckpointWriter> writer, size_t interval_episodes) {
+    if (writer && interval_episodes == 0) {
+        throw std::invalid_argument("Checkpoint interval must be positive");
+    }
+    checkpoint_writer_ = std::move(writer);
+    checkpoint_interval_ = interval_episodes;
+}
+
+void QLearningAgent::setMetricsSink(std::shared_ptr<MetricsSink> sink) {
+    metrics_channel_ = sink ? sink->openChannel() : nullptr;
+    metrics_sink_ = std::move(sink);
+}
+
+void ModelSnapshot::write(std::ostream& out) const {
+    // Save hyperparameters
+    out << learning_rate << " " << discount_factor << " " << epsilon << " "
+        << epsilon_decay << " " << min_epsilon << (symmetric ? " symmetric" : "") << '\n';
+    out << keys.size() << '\n';
+    
+    // Save Q-table: rows are formatted with to_chars (shortest round-trip
+    // values) into a chunk buffer, which is several times faster than
+    // iostream formatting and loses no precision
+    constexpr size_t CHUNK_SIZE = 1 << 16;
+    constexpr size_t MAX_ROW_CHARS = 32 + QTable::NUM_ACTIONS * 32;
+    std::vector<char> buffer(CHUNK_SIZE + MAX_ROW_CHARS);
+    char* const begin = buffer.data();
+    char* pos = begin;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        char* const end = begin + buffer.size();
+        pos = std::to_chars(pos, end, keys[i]).ptr;
+        *pos++ = ' ';
+        pos = std::to_chars(pos, end, QTable::NUM_ACTIONS).ptr;
+        *pos++ = '\n';
+        for (int action = 0; action < QTable::NUM_ACTIONS; ++action) {
+            pos = std::to_chars(pos, end, action).ptr;
+            *pos++ = ' ';
+            pos = std::to_chars(pos, end, rows[i].q[action]).ptr;
+            *pos++ = '\n';
+        }
+        if (static_cast<size_t>(pos - begin) >= CHUNK_SIZE) {
+            out.write(begin, pos - begin);
+            pos = begin;
+        }
+    }
+    out.write(begin, pos - begin);
 }
 
 void QLearningAgent::setLearningRate(double lr) {
@@ -210,6 +412,36 @@ void QLearningAgent::setEpsilon(double epsilon) {
     epsilon_ = epsilon;
 }
 
+void QLearningAgent::setSeed(unsigned int seed) {
+    gen_.seed(seed);
+    uniform_dist_.reset();
+}
+
+std::unique_ptr<Agent> QLearningAgent::clone() const {
+    auto copy = std::make_unique<QLearningAgent>(learning_rate_, discount_factor_, epsilon_);
+    copy->copyFrom(*this);
+    return copy;
+}
+
+void QLearningAgent::copyFrom(const Agent& other) {
+    const auto* source = dynamic_cast<const QLearningAgent*>(&other);
+    if (!source) {
+        throw std::invalid_argument("Cannot copy a different agent type into a QLearningAgent");
+    }
+    copyFrom(*source);
+}
+
+void QLearningAgent::copyFrom(const QLearningAgent& other) {
+    learning_rate_ = other.learning_rate_;
+    discount_factor_ = other.discount_factor_;
+    epsilon_ = other.epsilon_;
+    epsilon_decay_ = other.epsilon_decay_;
+    min_epsilon_ = other.min_epsilon_;
+    use_symmetry_ = other.use_symmetry_;
+    q_table_ = other.q_table_;
+    shared_table_ = other.shared_table_; // A shared table is shared by the copy too
+}
+
 void QLearningAgent::setDiscountFactor(double gamma) {
     discount_factor_ = gamma;
 }
@@ -219,65 +451,117 @@ void QLearningAgent::setEpsilonDecay(double decay) {
 }
 
 double QLearningAgent::getQValue(const std::string& state, int action) const {
-    auto state_it = q_table_.find(state);
-    if (state_it == q_table_.end()) {
+    return getQValue(StateEncoder::encode(StateEncoder::parseStateString(state)), action);
+}
+
+double QLearningAgent::getQValue(StateKey state, int action) const {
+    if (action < 0 || action >= QTable::NUM_ACTIONS) {
         return 0.0;
     }
     
-    auto action_it = state_it->second.find(action);
-    if (action_it == state_it->second.end()) {
+    CanonicalState canonical = canonicalize(state);
+    QTable::Row scratch;
+    const QTable::Row* row = findRow(canonical.key, scratch);
+    if (!row) {
         return 0.0;
     }
     
-    return action_it->second;
+    return row->q[StateSymmetry::toCanonicalAction(action, canonical.transform)];
+}
+
+void QLearningAgent::setQValues(StateKey state, const double q_values[QTable::NUM_ACTIONS]) {
+    CanonicalState canonical = canonicalize(state);
+    QTable::Row row;
+    for (int action = 0; action < QTable::NUM_ACTIONS; ++action) {
+        row.q[StateSymmetry::toCanonicalAction(action, canonical.transform)] = q_values[action];
+    }
+    
+    if (shared_table_) {
+        shared_table_->store(canonical.key, row);
+    } else {
+        q_table_.findOrInsert(canonical.key) = row;
+    }
 }
 
 void QLearningAgent::printQTable() const {
     std::cout << "Q-Table (showing top 10 states):" << std::endl;
     
     size_t count = 0;
-    for (const auto& state_entry : q_table_) {
-        if (count >= 10) break;
+    q_table_.forEach([&count](StateKey key, const QTable::Row& row) {
+        if (count >= 10) return;
         
-        std::cout << "State: " << state_entry.first << std::endl;
-        for (const auto& action_entry : state_entry.second) {
-            std::cout << "  Action " << action_entry.first 
-                     << ": " << std::fixed << std::setprecision(4) << action_entry.second << std::endl;
+        std::cout << "State: " << key << std::endl;
+        for (int action = 0; action < QTable::NUM_ACTIONS; ++action) {
+            std::cout << "  Action " << action 
+                     << ": " << std::fixed << std::setprecision(4) << row.q[action] << std::endl;
         }
         count++;
+    });
+}
+
+QTable& QLearningAgent::getQTable() {
+    return q_table_;
+}
+
+const QTable& QLearningAgent::getQTable() const {
+    return q_table_;
+}
+
+void QLearningAgent::setMemoryBudget(size_t max_bytes, EvictionPolicy policy) {
+    q_table_.setMemoryBudget(max_bytes, policy);
+}
+
+QTableStats QLearningAgent::getTableStats() const {
+    if (shared_table_) {
+        QTableStats stats;
+        stats.size = shared_table_->size();
+        stats.capacity = shared_table_->capacity();
+        stats.bytes_used = shared_table_->bytesUsed();
+        stats.lookups = shared_table_->getLookups();
+        stats.hits = shared_table_->getHits();
+        return stats;
     }
+    return q_table_.getStats();
 }
 
-std::string QLearningAgent::stateToString(const std::vector<double>& state) const {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2);
-    for (size_t i = 0; i < state.size(); ++i) {
-        if (i > 0) oss << ",";
-        oss << state[i];
+void QLearningAgent::setSymmetryCanonicalization(bool enabled) {
+    if (enabled != use_symmetry_ && q_table_.size() > 0) {
+        throw std::logic_error("Symmetry canonicalization must be chosen before the Q-table is populated");
     }
-    return oss.str();
+    use_symmetry_ = enabled;
 }
 
-int QLearningAgent::selectGreedyAction(const std::string& state_str) const {
-    auto state_it = q_table_.find(state_str);
-    if (state_it == q_table_.end()) {
-        return selectRandomAction();
+bool QLearningAgent::isSymmetryCanonicalizationEnabled() const {
+    return use_symmetry_;
+}
+
+void QLearningAgent::useSharedTable(std::shared_ptr<SharedQTable> table) {
+    shared_table_ = std::move(table);
+}
+
+std::shared_ptr<SharedQTable> QLearningAgent::getSharedTable() const {
+    return shared_table_;
+}
+
+CanonicalState QLearningAgent::encodeState(const std::vector<double>& state) const {
+    return canonicalize(StateEncoder::encode(state));
+}
+
+CanonicalState QLearningAgent::canonicalize(StateKey key) const {
+    if (!use_symmetry_) {
+        return {key, StateSymmetry::IDENTITY};
     }
-    
-    int best_action = 0;
-    double best_value = std::numeric_limits<double>::lowest();
-    
-    for (int action = 0; action < 4; ++action) {
-        auto action_it = state_it->second.find(action);
-        double q_value = (action_it != state_it->second.end()) ? action_it->second : 0.0;
-        
-        if (q_value > best_value) {
-            best_value = q_value;
-            best_action = action;
-        }
+    return StateSymmetry::canonicalize(key);
+}
+
+int QLearningAgent::selectGreedyAction(StateKey state) const {
+    QTable::Row scratch;
+    const QTable::Row* row = findRow(state, scratch);
+    if (!row) {
+        return selectRandomAction();
     }
     
-    return best_action;
+    return QTable::argmax(*row);
 }
 
 int QLearningAgent::selectRandomAction() const {
@@ -285,25 +569,37 @@ int QLearningAgent::selectRandomAction() const {
     return action_dist(gen_);
 }
 
-double QLearningAgent::getMaxQValue(const std::string& state_str) const {
-    auto state_it = q_table_.find(state_str);
-    if (state_it == q_table_.end()) {
+double QLearningAgent::getMaxQValue(StateKey state) const {
+    QTable::Row scratch;
+    const QTable::Row* row = findRow(state, scratch);
+    if (!row) {
         return 0.0;
     }
     
-    double max_value = std::numeric_limits<double>::lowest();
-    for (int action = 0; action < 4; ++action) {
-        auto action_it = state_it->second.find(action);
-        double q_value = (action_it != state_it->second.end()) ? action_it->second : 0.0;
-        max_value = std::max(max_value, q_value);
+    return QTable::max(*row);
+}
+
+const QTable::Row* QLearningAgent::findRow(StateKey state, QTable::Row& scratch) const {
+    // Shared rows are copied out, since other processes may be writing them
+    if (shared_table_) {
+        return shared_table_->find(state, scratch) ? &scratch : nullptr;
     }
-    
-    return max_value;
+    return q_table_.find(state);
 }
 
-void QLearningAgent::initializeQValue(const std::string& state_str, int action) {
-    if (q_table_[state_str].find(action) == q_table_[state_str].end()) {
-        q_table_[state_str][action] = 0.0;
+void QLearningAgent::addToQValue(StateKey state, int action, double delta) {
+    if (shared_table_) {
+        shared_table_->add(state, action, delta);
+    } else {
+        q_table_.findOrInsert(state).q[action] += delta;
+    }
+}
+
+void QLearningAgent::prefetchRow(StateKey state) const {
+    if (shared_table_) {
+        shared_table_->prefetch(state);
+    } else {
+        q_table_.prefetch(state);
     }
 }
 
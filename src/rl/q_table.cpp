@@ -0,0 +1,304 @@
+#include "rl/q_table.h"
+#include <algorithm>
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace SnakeGame::RL {
+
+namespace {
+
+// Index of the lowest set bit for every 4-bit mask (0 maps to 0)
+constexpr int FIRST_SET_BIT[16] = {0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0};
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+QTable::QTable(size_t initial_capacity)
+    : size_(0)
+    , mask_(0)
+    , shift_(64)
+    , memory_budget_(0)
+    , max_capacity_(std::numeric_limits<size_t>::max())
+    , policy_(EvictionPolicy::VISIT_COUNT)
+    , clock_hand_(0)
+    , lookups_(0)
+    , hits_(0)
+    , evictions_(0) {
+    rehash(roundUpToPowerOfTwo(std::max(initial_capacity, MIN_CAPACITY)));
+}
+
+const QTable::Row* QTable::find(StateKey key) const {
+    lookups_++;
+    size_t slot = homeSlot(key);
+    while (true) {
+        StateKey stored = keys_[slot];
+        if (stored == key) {
+            hits_++;
+            touch(slot);
+            return &rows_[slot];
+        }
+        if (stored == EMPTY_KEY) {
+            return nullptr;
+        }
+        slot = (slot + 1) & mask_;
+    }
+}
+
+QTable::Row& QTable::findOrInsert(StateKey key) {
+    lookups_++;
+    size_t slot = homeSlot(key);
+    while (keys_[slot] != EMPTY_KEY) {
+        if (keys_[slot] == key) {
+            hits_++;
+            touch(slot);
+            return rows_[slot];
+        }
+        slot = (slot + 1) & mask_;
+    }
+
+    // Make room: grow while under budget, otherwise evict one entry inline
+    if (size_ + 1 > maxEntries(keys_.size())) {
+        if (keys_.size() * 2 <= max_capacity_) {
+            rehash(keys_.size() * 2);
+        } else {
+            evictOne();
+        }
+        slot = homeSlot(key);
+        while (keys_[slot] != EMPTY_KEY) {
+            slot = (slot + 1) & mask_;
+        }
+    }
+
+    keys_[slot] = key;
+    rows_[slot] = Row{};
+    visits_[slot] = 1;
+    size_++;
+    return rows_[slot];
+}
+
+void QTable::prefetch(StateKey key) const {
+#if defined(__GNUC__) || defined(__clang__)
+    size_t slot = homeSlot(key);
+    __builtin_prefetch(&keys_[slot]);
+    __builtin_prefetch(&rows_[slot]);
+#else
+    (void)key;
+#endif
+}
+
+size_t QTable::size() const {
+    return size_;
+}
+
+size_t QTable::capacity() const {
+    return keys_.size();
+}
+
+size_t QTable::bytesUsed() const {
+    return keys_.size() * bytesPerSlot();
+}
+
+void QTable::clear() {
+    std::fill(keys_.begin(), keys_.end(), EMPTY_KEY);
+    std::fill(visits_.begin(), visits_.end(), 0);
+    size_ = 0;
+    clock_hand_ = 0;
+}
+
+void QTable::setMemoryBudget(size_t max_bytes, EvictionPolicy policy) {
+    memory_budget_ = max_bytes;
+    policy_ = policy;
+
+    if (max_bytes == 0) {
+        max_capacity_ = std::numeric_limits<size_t>::max();
+        return;
+    }
+
+    // Largest power-of-two capacity that fits in the budget
+    max_capacity_ = MIN_CAPACITY;
+    while (max_capacity_ * 2 * bytesPerSlot() <= max_bytes) {
+        max_capacity_ *= 2;
+    }
+
+    // Shrink an oversized table, evicting until the survivors fit
+    if (keys_.size() > max_capacity_) {
+        while (size_ > maxEntries(max_capacity_)) {
+            evictOne();
+        }
+        rehash(max_capacity_);
+    }
+}
+
+size_t QTable::getMemoryBudget() const {
+    return memory_budget_;
+}
+
+size_t QTable::bytesPerSlot() {
+    return sizeof(StateKey) + sizeof(Row) + sizeof(uint8_t);
+}
+
+QTableStats QTable::getStats() const {
+    QTableStats stats;
+    stats.size = size_;
+    stats.capacity = keys_.size();
+    stats.bytes_used = bytesUsed();
+    stats.lookups = lookups_;
+    stats.hits = hits_;
+    stats.evictions = evictions_;
+    return stats;
+}
+
+void QTable::resetStats() {
+    lookups_ = 0;
+    hits_ = 0;
+    evictions_ = 0;
+}
+
+int QTable::argmax(const Row& row) {
+#if defined(__AVX__)
+    __m256d values = _mm256_load_pd(row.q);
+    __m256d pairs = _mm256_max_pd(values, _mm256_permute_pd(values, 0x5));
+    __m256d best = _mm256_max_pd(pairs, _mm256_permute2f128_pd(pairs, pairs, 0x1));
+    int mask = _mm256_movemask_pd(_mm256_cmp_pd(values, best, _CMP_EQ_OQ));
+    return FIRST_SET_BIT[mask];
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128d low = _mm_load_pd(row.q);
+    __m128d high = _mm_load_pd(row.q + 2);
+    __m128d best = _mm_max_pd(low, high);
+    best = _mm_max_pd(best, _mm_shuffle_pd(best, best, 0x1));
+    int mask = _mm_movemask_pd(_mm_cmpeq_pd(low, best)) | (_mm_movemask_pd(_mm_cmpeq_pd(high, best)) << 2);
+    return FIRST_SET_BIT[mask];
+#else
+    int best_action = 0;
+    for (int action = 1; action < NUM_ACTIONS; ++action) {
+        if (row.q[action] > row.q[best_action]) {
+            best_action = action;
+        }
+    }
+    return best_action;
+#endif
+}
+
+double QTable::max(const Row& row) {
+    return std::max(std::max(row.q[0], row.q[1]), std::max(row.q[2], row.q[3]));
+}
+
+size_t QTable::homeSlot(StateKey key) const {
+    // Fibonacci hashing spreads the densely packed keys across the table
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+}
+
+void QTable::touch(size_t slot) const {
+    if (policy_ == EvictionPolicy::CLOCK) {
+        visits_[slot] = 1;
+    } else if (visits_[slot] < std::numeric_limits<uint8_t>::max()) {
+        visits_[slot]++;
+    }
+}
+
+size_t QTable::maxEntries(size_t capacity) const {
+    return static_cast<size_t>(MAX_LOAD_FACTOR * static_cast<double>(capacity));
+}
+
+void QTable::rehash(size_t new_capacity) {
+    std::vector<StateKey> old_keys(new_capacity, EMPTY_KEY);
+    std::vector<Row> old_rows(new_capacity);
+    std::vector<uint8_t> old_visits(new_capacity, 0);
+    old_keys.swap(keys_);
+    old_rows.swap(rows_);
+    old_visits.swap(visits_);
+
+    mask_ = new_capacity - 1;
+    shift_ = 64;
+    for (size_t capacity = new_capacity; capacity > 1; capacity >>= 1) {
+        shift_--;
+    }
+    clock_hand_ = 0;
+
+    for (size_t slot = 0; slot < old_keys.size(); ++slot) {
+        if (old_keys[slot] == EMPTY_KEY) {
+            continue;
+        }
+        size_t target = homeSlot(old_keys[slot]);
+        while (keys_[target] != EMPTY_KEY) {
+            target = (target + 1) & mask_;
+        }
+        keys_[target] = old_keys[slot];
+        rows_[target] = old_rows[slot];
+        visits_[target] = old_visits[slot];
+    }
+}
+
+void QTable::evictOne() {
+    if (size_ == 0) {
+        return;
+    }
+
+    // Sweep from the clock hand, aging every entry passed over, and evict the
+    // first unreferenced one; give up after a bounded scan and take the coldest seen
+    size_t victim = keys_.size();
+    uint8_t victim_visits = std::numeric_limits<uint8_t>::max();
+    size_t inspected = 0;
+
+    while (inspected < MAX_EVICTION_SCAN) {
+        size_t slot = clock_hand_;
+        clock_hand_ = (clock_hand_ + 1) & mask_;
+        if (keys_[slot] == EMPTY_KEY) {
+            continue;
+        }
+        inspected++;
+
+        if (visits_[slot] == 0) {
+            victim = slot;
+            break;
+        }
+        if (victim == keys_.size() || visits_[slot] < victim_visits) {
+            victim = slot;
+            victim_visits = visits_[slot];
+        }
+        visits_[slot] = (policy_ == EvictionPolicy::CLOCK) ? 0 : visits_[slot] / 2;
+    }
+
+    eraseSlot(victim);
+    evictions_++;
+}
+
+void QTable::eraseSlot(size_t slot) {
+    // Backward-shift deletion keeps every probe chain contiguous without tombstones
+    size_t hole = slot;
+    size_t next = slot;
+    while (true) {
+        next = (next + 1) & mask_;
+        if (keys_[next] == EMPTY_KEY) {
+            break;
+        }
+
+        size_t home = homeSlot(keys_[next]);
+        bool stays = (hole <= next) ? (hole < home && home <= next)
+                                    : (hole < home || home <= next);
+        if (!stays) {
+            keys_[hole] = keys_[next];
+            rows_[hole] = rows_[next];
+            visits_[hole] = visits_[next];
+            hole = next;
+        }
+    }
+
+    keys_[hole] = EMPTY_KEY;
+    visits_[hole] = 0;
+    size_--;
+}
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,258 @@
+#include "rl/replay_buffer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace SnakeGame::RL {
+
+// SumTree implementation
+SumTree::SumTree(size_t capacity)
+    : capacity_(capacity)
+    , leaf_count_(1) {
+    while (leaf_count_ < capacity_) {
+        leaf_count_ <<= 1;
+    }
+    nodes_.assign(capacity_ > 0 ? 2 * leaf_count_ : 0, 0.0);
+}
+
+void SumTree::update(size_t index, double priority) {
+    if (index >= capacity_) {
+        throw std::out_of_range("SumTree index out of range: " + std::to_string(index));
+    }
+
+    size_t node = index + leaf_count_;
+    double delta = priority - nodes_[node];
+    while (node >= 1) {
+        nodes_[node] += delta;
+        node >>= 1;
+    }
+}
+
+double SumTree::get(size_t index) const {
+    return nodes_[index + leaf_count_];
+}
+
+double SumTree::total() const {
+    return nodes_.empty() ? 0.0 : nodes_[1];
+}
+
+size_t SumTree::find(double prefix_sum) const {
+    size_t node = 1;
+    while (node < leaf_count_) {
+        size_t left = node << 1;
+        if (prefix_sum < nodes_[left] || nodes_[left + 1] <= 0.0) {
+            node = left;
+        } else {
+            prefix_sum -= nodes_[left];
+            node = left + 1;
+        }
+    }
+
+    // Floating-point drift can push the search onto padding leaves
+    return std::min(node - leaf_count_, capacity_ - 1);
+}
+
+size_t SumTree::capacity() const {
+    return capacity_;
+}
+
+size_t SumTree::bytesUsed() const {
+    return nodes_.size() * sizeof(double);
+}
+
+void SumTree::clear() {
+    std::fill(nodes_.begin(), nodes_.end(), 0.0);
+}
+
+// TransitionBatch implementation
+void TransitionBatch::resize(size_t batch_size, size_t state_size) {
+    states.resize(batch_size * state_size);
+    next_states.resize(batch_size * state_size);
+    actions.resize(batch_size);
+    rewards.resize(batch_size);
+    dones.resize(batch_size);
+    indices.resize(batch_size);
+    weights.resize(batch_size);
+}
+
+// ReplayBuffer implementation
+ReplayBuffer::ReplayBuffer(size_t capacity, size_t state_size, SamplingMode mode, double alpha)
+    : capacity_(capacity)
+    , state_size_(state_size)
+    , size_(0)
+    , next_index_(0)
+    , mode_(mode)
+    , alpha_(alpha)
+    , priority_epsilon_(1e-6)
+    , max_priority_(1.0)
+    , states_(capacity * state_size)
+    , next_states_(capacity * state_size)
+    , actions_(capacity)
+    , rewards_(capacity)
+    , dones_(capacity)
+    , priorities_(mode == SamplingMode::PRIORITIZED ? capacity : 0)
+    , gen_(std::random_device{}())
+    , uniform_dist_(0.0, 1.0) {
+    if (capacity == 0 || state_size == 0) {
+        throw std::invalid_argument("ReplayBuffer capacity and state size must be positive");
+    }
+}
+
+void ReplayBuffer::add(const std::vector<double>& state, int action,
+                       double reward, const std::vector<double>& next_state, bool done) {
+    if (state.size() != state_size_ || next_state.size() != state_size_) {
+        throw std::invalid_argument("State size mismatch in ReplayBuffer::add");
+    }
+
+    float* state_row = &states_[next_index_ * state_size_];
+    float* next_state_row = &next_states_[next_index_ * state_size_];
+    for (size_t i = 0; i < state_size_; ++i) {
+        state_row[i] = static_cast<float>(state[i]);
+        next_state_row[i] = static_cast<float>(next_state[i]);
+    }
+
+    // Reuse the float path for the scalar fields and bookkeeping
+    add(nullptr, action, static_cast<float>(reward), nullptr, done);
+}
+
+void ReplayBuffer::add(const float* state, int action,
+                       float reward, const float* next_state, bool done) {
+    size_t slot = next_index_;
+
+    if (state) {
+        std::memcpy(&states_[slot * state_size_], state, state_size_ * sizeof(float));
+    }
+    if (next_state) {
+        std::memcpy(&next_states_[slot * state_size_], next_state, state_size_ * sizeof(float));
+    }
+    actions_[slot] = action;
+    rewards_[slot] = reward;
+    dones_[slot] = done ? 1 : 0;
+
+    // New transitions get the highest priority seen so they are replayed at least once
+    if (mode_ == SamplingMode::PRIORITIZED) {
+        priorities_.update(slot, max_priority_);
+    }
+
+    next_index_ = (next_index_ + 1) % capacity_;
+    size_ = std::min(size_ + 1, capacity_);
+}
+
+void ReplayBuffer::sample(size_t batch_size, TransitionBatch& batch, double beta) {
+    if (size_ == 0) {
+        throw std::runtime_error("Cannot sample from an empty ReplayBuffer");
+    }
+
+    batch.resize(batch_size, state_size_);
+
+    if (mode_ == SamplingMode::UNIFORM) {
+        std::uniform_int_distribution<size_t> index_dist(0, size_ - 1);
+        for (size_t row = 0; row < batch_size; ++row) {
+            size_t slot = index_dist(gen_);
+            copyTransition(slot, row, batch);
+            batch.weights[row] = 1.0f;
+        }
+        return;
+    }
+
+    // Stratified proportional sampling: one draw per equal-mass segment
+    double total = priorities_.total();
+    double segment = total / static_cast<double>(batch_size);
+    double max_weight = 0.0;
+
+    for (size_t row = 0; row < batch_size; ++row) {
+        double prefix = (static_cast<double>(row) + uniform_dist_(gen_)) * segment;
+        size_t slot = std::min(priorities_.find(prefix), size_ - 1);
+        copyTransition(slot, row, batch);
+
+        double probability = priorities_.get(slot) / total;
+        double weight = std::pow(static_cast<double>(size_) * probability, -beta);
+        batch.weights[row] = static_cast<float>(weight);
+        max_weight = std::max(max_weight, weight);
+    }
+
+    // Normalize by the largest weight so updates are only ever scaled down
+    if (max_weight > 0.0) {
+        float inv_max = static_cast<float>(1.0 / max_weight);
+        for (size_t row = 0; row < batch_size; ++row) {
+            batch.weights[row] *= inv_max;
+        }
+    }
+}
+
+void ReplayBuffer::updatePriorities(const size_t* indices, const float* td_errors, size_t count) {
+    if (mode_ != SamplingMode::PRIORITIZED) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        double priority = toPriority(td_errors[i]);
+        priorities_.update(indices[i], priority);
+        max_priority_ = std::max(max_priority_, priority);
+    }
+}
+
+void ReplayBuffer::updatePriorities(const TransitionBatch& batch, const float* td_errors) {
+    updatePriorities(batch.indices.data(), td_errors, batch.indices.size());
+}
+
+size_t ReplayBuffer::size() const {
+    return size_;
+}
+
+size_t ReplayBuffer::capacity() const {
+    return capacity_;
+}
+
+size_t ReplayBuffer::getStateSize() const {
+    return state_size_;
+}
+
+size_t ReplayBuffer::bytesUsed() const {
+    return (states_.size() + next_states_.size()) * sizeof(float)
+         + actions_.size() * sizeof(int)
+         + rewards_.size() * sizeof(float)
+         + dones_.size() * sizeof(uint8_t)
+         + priorities_.bytesUsed();
+}
+
+SamplingMode ReplayBuffer::getSamplingMode() const {
+    return mode_;
+}
+
+bool ReplayBuffer::isFull() const {
+    return size_ == capacity_;
+}
+
+void ReplayBuffer::setSeed(unsigned int seed) {
+    gen_.seed(seed);
+}
+
+void ReplayBuffer::setPriorityEpsilon(double epsilon) {
+    priority_epsilon_ = epsilon;
+}
+
+void ReplayBuffer::clear() {
+    size_ = 0;
+    next_index_ = 0;
+    max_priority_ = 1.0;
+    priorities_.clear();
+}
+
+void ReplayBuffer::copyTransition(size_t slot, size_t row, TransitionBatch& batch) const {
+    std::memcpy(&batch.states[row * state_size_], &states_[slot * state_size_],
+                state_size_ * sizeof(float));
+    std::memcpy(&batch.next_states[row * state_size_], &next_states_[slot * state_size_],
+                state_size_ * sizeof(float));
+    batch.actions[row] = actions_[slot];
+    batch.rewards[row] = rewards_[slot];
+    batch.dones[row] = dones_[slot];
+    batch.indices[row] = slot;
+}
+
+double ReplayBuffer::toPriority(double td_error) const {
+    return std::pow(std::abs(td_error) + priority_epsilon_, alpha_);
+}
+
+} // namespace SnakeGame::RL
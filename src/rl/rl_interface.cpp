@@ -3,6 +3,7 @@
 #include "graphics.h"
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
 
 namespace SnakeGame::RL {
 
@@ -14,9 +15,14 @@ SnakeEnvironment::SnakeEnvironment()
 SnakeEnvironment::SnakeEnvironment(bool headless) 
     : game_(std::make_unique<SnakeGame::Game>())
     , headless_mode_(headless)
+    , live_view_(false)
+    , recording_(false)
+    , seeded_(false)
+    , episode_index_(0)
     , step_count_(0)
     , max_steps_(1000)
     , seed_(0)
+    , episode_seed_(0)
     , apple_reward_(static_cast<double>(RewardType::APPLE_EATEN))
     , collision_penalty_(static_cast<double>(RewardType::COLLISION))
     , time_penalty_(static_cast<double>(RewardType::TIME_PENALTY)) {
@@ -34,9 +40,32 @@ SnakeEnvironment::SnakeEnvironment(bool headless)
 SnakeEnvironment::~SnakeEnvironment() = default;
 
 std::vector<double> SnakeEnvironment::reset() {
+    if (recording_) {
+        recorder_->endEpisode(static_cast<double>(game_->getScore()));
+    }
+    
+    // Seeded runs start every episode from its own derived seed, recorded or not;
+    // unseeded runs only reseed when a recorder needs a seed to replay from
+    if (seeded_) {
+        episode_seed_ = static_cast<unsigned int>(mixSeed(seed_, episode_index_++));
+        game_->setSeed(episode_seed_);
+    } else if (recorder_) {
+        episode_seed_ = std::random_device{}();
+        game_->setSeed(episode_seed_);
+    }
+    
     game_->reset();
     step_count_ = 0;
-    return encodeGameState();
+    if (live_view_) {
+        game_->render();
+    }
+    
+    std::vector<double> state = encodeGameState();
+    if (recorder_) {
+        recorder_->beginEpisode(episode_seed_, max_steps_, state);
+        recording_ = true;
+    }
+    return state;
 }
 
 std::pair<std::vector<double>, double> SnakeEnvironment::step(int action) {
@@ -48,12 +77,22 @@ std::pair<std::vector<double>, double> SnakeEnvironment::step(int action) {
     bool game_continues = game_->performAction(dir);
     
     step_count_++;
+    if (live_view_) {
+        game_->render(); // The graphics backend decides whether this frame is drawn
+    }
     
     double reward = game_->getReward();
     std::vector<double> next_state = encodeGameState();
     
     // Check if episode is done
     bool done = !game_continues || step_count_ >= max_steps_;
+    if (recording_) {
+        recorder_->recordStep(action, reward);
+        if (done) {
+            recorder_->endEpisode(static_cast<double>(game_->getScore()));
+            recording_ = false;
+        }
+    }
     
     return {next_state, reward};
 }
@@ -85,7 +124,13 @@ std::vector<int> SnakeEnvironment::getActionSpace() const {
 
 void SnakeEnvironment::setSeed(unsigned int seed) {
     seed_ = seed;
-    // TODO: Implement proper seeding for all random components
+    seeded_ = true;
+    episode_index_ = 0;
+    game_->setSeed(seed); // The apple is the only random component of the game
+}
+
+unsigned int SnakeEnvironment::getEpisodeSeed() const {
+    return episode_seed_;
 }
 
 std::vector<double> SnakeEnvironment::getInfo() const {
@@ -103,10 +148,32 @@ void SnakeEnvironment::setRewardStructure(double apple_reward, double collision_
     time_penalty_ = time_penalty;
 }
 
+const SnakeGame::Game& SnakeEnvironment::getGame() const {
+    return *game_;
+}
+
 void SnakeEnvironment::setMaxSteps(size_t max_steps) {
     max_steps_ = max_steps;
 }
 
+void SnakeEnvironment::setLiveView(std::unique_ptr<SnakeGame::Graphics> graphics) {
+    live_view_ = graphics != nullptr;
+    headless_mode_ = !live_view_;
+    if (!graphics) {
+        graphics = std::make_unique<SnakeGame::HeadlessGraphics>();
+    }
+    graphics->initialize();
+    game_->setGraphics(std::move(graphics));
+}
+
+void SnakeEnvironment::setRecorder(std::shared_ptr<EpisodeRecorder> recorder) {
+    if (recorder_ && recording_) {
+        recorder_->endEpisode(static_cast<double>(game_->getScore()));
+    }
+    recorder_ = std::move(recorder);
+    recording_ = false;
+}
+
 std::vector<double> SnakeEnvironment::encodeGameState() const {
     return game_->getStateVector();
 }
@@ -121,6 +188,44 @@ Direction SnakeEnvironment::intToDirection(int action) const {
     }
 }
 
+// StateBatch implementation
+StateBatch::StateBatch(size_t batch_size, size_t state_size) {
+    resize(batch_size, state_size);
+}
+
+void StateBatch::resize(size_t batch_size, size_t new_state_size) {
+    state_size = new_state_size;
+    data.resize(batch_size * new_state_size);
+}
+
+void StateBatch::setRow(size_t index, const std::vector<double>& state) {
+    if (state.size() != state_size) {
+        throw std::invalid_argument("State size mismatch in StateBatch::setRow");
+    }
+    std::copy(state.begin(), state.end(), row(index));
+}
+
+// Agent implementation
+void Agent::selectActions(const StateBatch& states, std::vector<int>& actions) {
+    // Fallback: one selectAction call per row
+    const size_t batch_size = states.size();
+    actions.resize(batch_size);
+    
+    std::vector<double> state(states.state_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+        std::copy(states.row(i), states.row(i) + states.state_size, state.begin());
+        actions[i] = selectAction(state);
+    }
+}
+
+std::unique_ptr<Agent> Agent::clone() const {
+    throw std::logic_error("This agent does not support cloning");
+}
+
+void Agent::copyFrom(const Agent& /*other*/) {
+    throw std::logic_error("This agent does not support copying in place");
+}
+
 // RandomAgent implementation
 RandomAgent::RandomAgent() : gen_(rd_()), dist_(0, 3) {
 }
@@ -128,8 +233,36 @@ RandomAgent::RandomAgent() : gen_(rd_()), dist_(0, 3) {
 RandomAgent::RandomAgent(unsigned int seed) : gen_(seed), dist_(0, 3) {
 }
 
+void RandomAgent::setSeed(unsigned int seed) {
+    gen_.seed(seed);
+    dist_.reset();
+}
+
+std::unique_ptr<Agent> RandomAgent::clone() const {
+    // Continues the same action sequence as this agent
+    auto copy = std::make_unique<RandomAgent>();
+    copy->gen_ = gen_;
+    copy->dist_ = dist_;
+    return copy;
+}
+
 int RandomAgent::selectAction(const std::vector<double>& state) {
     return dist_(gen_);
 }
 
+void RandomAgent::selectActions(const StateBatch& states, std::vector<int>& actions) {
+    // Each 32-bit draw yields 16 two-bit actions
+    const size_t batch_size = states.size();
+    actions.resize(batch_size);
+    
+    size_t i = 0;
+    while (i < batch_size) {
+        uint32_t bits = static_cast<uint32_t>(gen_());
+        for (int j = 0; j < 16 && i < batch_size; ++j, ++i) {
+            actions[i] = static_cast<int>(bits & 3u);
+            bits >>= 2;
+        }
+    }
+}
+
 } // namespace SnakeGame::RL
@@ -0,0 +1,361 @@
+#include "rl/shared_q_table.h"
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SnakeGame::RL {
+
+namespace {
+
+constexpr uint64_t SEGMENT_MAGIC = 0x31545141454B4E53ULL; // "SNKEAQT1"
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr uint32_t STATE_INITIALIZING = 0;
+constexpr uint32_t STATE_READY = 1;
+constexpr double MAX_LOAD_FACTOR = 0.9;
+constexpr auto ATTACH_TIMEOUT = std::chrono::seconds(5);
+
+uint64_t layoutChecksum(uint64_t magic, uint32_t version, uint32_t slot_size, uint64_t capacity) {
+    // FNV-1a over the fields that define the layout
+    uint64_t hash = 1469598103934665603ULL;
+    for (uint64_t value : {magic, static_cast<uint64_t>(version), static_cast<uint64_t>(slot_size), capacity}) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // namespace
+
+/**
+ * Segment header; the slots start at the next cache line
+ */
+struct alignas(64) SharedQTable::Header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slot_size;
+    uint64_t capacity;
+    uint64_t checksum;
+    std::atomic<uint32_t> state;
+    std::atomic<uint64_t> size;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared Q-table needs lock-free 64-bit atomics to work across processes");
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "Unexpected atomic layout");
+
+SharedQTable::SharedQTable(const std::string& name, size_t capacity, bool read_only)
+    : name_(name)
+    , read_only_(read_only)
+    , created_(false)
+    , fd_(-1)
+    , mapping_(nullptr)
+    , mapping_size_(0)
+    , header_(nullptr)
+    , slots_(nullptr)
+    , capacity_(0)
+    , mask_(0)
+    , shift_(64)
+    , lookups_(0)
+    , hits_(0) {
+#ifdef _WIN32
+    (void)capacity;
+    throw std::runtime_error("Shared Q-tables require POSIX shared memory");
+#else
+    if (name_.empty() || name_[0] != '/') {
+        name_ = "/" + name_;
+    }
+
+    if (!read_only_) {
+        fd_ = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd_ >= 0) {
+            create(capacity);
+            return;
+        }
+        if (errno != EEXIST) {
+            throw std::runtime_error("Could not create shared Q-table " + name_ + ": " + std::strerror(errno));
+        }
+    }
+
+    fd_ = ::shm_open(name_.c_str(), read_only_ ? O_RDONLY : O_RDWR, 0);
+    if (fd_ < 0) {
+        throw std::runtime_error("Could not open shared Q-table " + name_ + ": " + std::strerror(errno));
+    }
+    attach();
+#endif
+}
+
+SharedQTable::~SharedQTable() {
+#ifndef _WIN32
+    if (mapping_) {
+        ::munmap(mapping_, mapping_size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+}
+
+bool SharedQTable::remove(const std::string& name) {
+#ifdef _WIN32
+    (void)name;
+    return false;
+#else
+    std::string path = (!name.empty() && name[0] == '/') ? name : "/" + name;
+    return ::shm_unlink(path.c_str()) == 0;
+#endif
+}
+
+bool SharedQTable::isSupported() {
+#ifdef _WIN32
+    return false;
+#else
+    return true;
+#endif
+}
+
+bool SharedQTable::find(StateKey key, QTable::Row& row) const {
+    lookups_++;
+    size_t slot = findSlot(key);
+    if (slot == capacity_) {
+        return false;
+    }
+    hits_++;
+    loadRow(slot, row);
+    return true;
+}
+
+void SharedQTable::store(StateKey key, const QTable::Row& row) {
+    size_t slot = claimSlot(key);
+    for (int action = 0; action < QTable::NUM_ACTIONS; ++action) {
+        slots_[slot].q[action].store(toBits(row.q[action]), std::memory_order_relaxed);
+    }
+}
+
+void SharedQTable::update(StateKey key, int action, double target, double learning_rate) {
+    // Re-read and retry if another process changed the value in between
+    std::atomic<uint64_t>& value = slots_[claimSlot(key)].q[action];
+    uint64_t expected = value.load(std::memory_order_relaxed);
+    while (true) {
+        double current = fromBits(expected);
+        uint64_t desired = toBits(current + learning_rate * (target - current));
+        if (value.compare_exchange_weak(expected, desired, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+}
+
+void SharedQTable::add(StateKey key, int action, double delta) {
+    std::atomic<uint64_t>& value = slots_[claimSlot(key)].q[action];
+    uint64_t expected = value.load(std::memory_order_relaxed);
+    while (!value.compare_exchange_weak(expected, toBits(fromBits(expected) + delta), std::memory_order_relaxed)) {
+    }
+}
+
+void SharedQTable::prefetch(StateKey key) const {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&slots_[homeSlot(key)]);
+#else
+    (void)key;
+#endif
+}
+
+size_t SharedQTable::size() const {
+    return header_->size.load(std::memory_order_relaxed);
+}
+
+size_t SharedQTable::capacity() const {
+    return capacity_;
+}
+
+size_t SharedQTable::bytesUsed() const {
+    return mapping_size_;
+}
+
+bool SharedQTable::isReadOnly() const {
+    return read_only_;
+}
+
+bool SharedQTable::createdSegment() const {
+    return created_;
+}
+
+const std::string& SharedQTable::getName() const {
+    return name_;
+}
+
+size_t SharedQTable::getLookups() const {
+    return lookups_;
+}
+
+size_t SharedQTable::getHits() const {
+    return hits_;
+}
+
+void SharedQTable::create(size_t capacity) {
+#ifndef _WIN32
+    created_ = true;
+    size_t rounded = 16;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    setCapacity(rounded);
+
+    size_t bytes = sizeof(Header) + capacity_ * sizeof(Slot);
+    if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+        int error = errno;
+        ::close(fd_);
+        fd_ = -1;
+        ::shm_unlink(name_.c_str());
+        throw std::runtime_error("Could not size shared Q-table " + name_ + ": " + std::strerror(error));
+    }
+    map(bytes);
+
+    // Fresh pages are zero, i.e. every slot is empty and every value is 0.0;
+    // the header becomes visible to other processes only once it is complete
+    header_->magic = SEGMENT_MAGIC;
+    header_->version = FORMAT_VERSION;
+    header_->slot_size = sizeof(Slot);
+    header_->capacity = capacity_;
+    header_->checksum = layoutChecksum(SEGMENT_MAGIC, FORMAT_VERSION, sizeof(Slot), capacity_);
+    header_->size.store(0, std::memory_order_relaxed);
+    header_->state.store(STATE_READY, std::memory_order_release);
+#else
+    (void)capacity;
+#endif
+}
+
+void SharedQTable::attach() {
+#ifndef _WIN32
+    // The creator may still be sizing or filling in the header
+    auto deadline = std::chrono::steady_clock::now() + ATTACH_TIMEOUT;
+    struct stat info;
+    while (true) {
+        if (::fstat(fd_, &info) != 0) {
+            throw std::runtime_error("Could not inspect shared Q-table " + name_ + ": " + std::strerror(errno));
+        }
+        if (static_cast<size_t>(info.st_size) >= sizeof(Header)) {
+            break;
+        }
+        if (std::chrono::steady_clock::now() > deadline) {
+            throw std::runtime_error("Shared Q-table " + name_ + " was never initialized; remove it and retry");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    map(static_cast<size_t>(info.st_size));
+    while (header_->state.load(std::memory_order_acquire) != STATE_READY) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            throw std::runtime_error("Shared Q-table " + name_ + " was never initialized; remove it and retry");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    if (header_->magic != SEGMENT_MAGIC) {
+        throw std::runtime_error("Shared memory segment " + name_ + " is not a Q-table");
+    }
+    if (header_->version != FORMAT_VERSION || header_->slot_size != sizeof(Slot)) {
+        throw std::runtime_error("Shared Q-table " + name_ + " uses format version " +
+                                 std::to_string(header_->version) + ", expected " +
+                                 std::to_string(FORMAT_VERSION));
+    }
+    if (header_->checksum != layoutChecksum(header_->magic, header_->version, header_->slot_size, header_->capacity) ||
+        sizeof(Header) + header_->capacity * sizeof(Slot) > mapping_size_ ||
+        (header_->capacity & (header_->capacity - 1)) != 0) {
+        throw std::runtime_error("Shared Q-table " + name_ + " has a corrupt header");
+    }
+    setCapacity(header_->capacity);
+#endif
+}
+
+void SharedQTable::map(size_t bytes) {
+#ifndef _WIN32
+    int protection = read_only_ ? PROT_READ : (PROT_READ | PROT_WRITE);
+    void* mapping = ::mmap(nullptr, bytes, protection, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Could not map shared Q-table " + name_ + ": " + std::strerror(errno));
+    }
+    mapping_ = mapping;
+    mapping_size_ = bytes;
+    header_ = static_cast<Header*>(mapping);
+    slots_ = reinterpret_cast<Slot*>(static_cast<char*>(mapping) + sizeof(Header));
+#else
+    (void)bytes;
+#endif
+}
+
+void SharedQTable::setCapacity(size_t capacity) {
+    capacity_ = capacity;
+    mask_ = capacity - 1;
+    shift_ = 64;
+    for (size_t c = capacity; c > 1; c >>= 1) {
+        shift_--;
+    }
+}
+
+size_t SharedQTable::homeSlot(StateKey key) const {
+    // Same Fibonacci hashing as QTable
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+}
+
+size_t SharedQTable::findSlot(StateKey key) const {
+    const uint64_t stored_key = ~key;
+    size_t slot = homeSlot(key);
+    for (size_t probes = 0; probes < capacity_; ++probes) {
+        uint64_t stored = slots_[slot].key.load(std::memory_order_acquire);
+        if (stored == stored_key) {
+            return slot;
+        }
+        if (stored == EMPTY_SLOT) {
+            return capacity_;
+        }
+        slot = (slot + 1) & mask_;
+    }
+    return capacity_;
+}
+
+size_t SharedQTable::claimSlot(StateKey key) {
+    if (read_only_) {
+        throw std::logic_error("Shared Q-table " + name_ + " is attached read-only");
+    }
+
+    const uint64_t stored_key = ~key;
+    size_t slot = homeSlot(key);
+    for (size_t probes = 0; probes < capacity_; ++probes) {
+        uint64_t stored = slots_[slot].key.load(std::memory_order_acquire);
+        if (stored == stored_key) {
+            return slot;
+        }
+        if (stored == EMPTY_SLOT) {
+            if (header_->size.load(std::memory_order_relaxed) >= MAX_LOAD_FACTOR * capacity_) {
+                break;
+            }
+            // Another process may claim the slot first, possibly for the same key
+            if (slots_[slot].key.compare_exchange_strong(stored, stored_key, std::memory_order_acq_rel)) {
+                header_->size.fetch_add(1, std::memory_order_relaxed);
+                return slot;
+            }
+            if (stored == stored_key) {
+                return slot;
+            }
+        }
+        slot = (slot + 1) & mask_;
+    }
+    throw std::runtime_error("Shared Q-table " + name_ + " is full; recreate it with a larger capacity");
+}
+
+void SharedQTable::loadRow(size_t slot, QTable::Row& row) const {
+    for (int action = 0; action < QTable::NUM_ACTIONS; ++action) {
+        row.q[action] = fromBits(slots_[slot].q[action].load(std::memory_order_relaxed));
+    }
+}
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,136 @@
+#include "rl/state_encoder.h"
+#include <cmath>
+#include <sstream>
+
+namespace SnakeGame::RL {
+
+namespace {
+
+constexpr double QUANTIZATION_TOLERANCE = 1e-6;
+
+// Recovers an integer grid quantity from a normalized feature, or -1 if the
+// feature is not an exact multiple of 1/scale inside [0, limit)
+long decodeField(double feature, double scale, long offset, long limit) {
+    double scaled = feature * scale;
+    double rounded = std::round(scaled);
+    if (std::abs(scaled - rounded) > QUANTIZATION_TOLERANCE) {
+        return -1;
+    }
+    long value = static_cast<long>(rounded) + offset;
+    return (value >= 0 && value < limit) ? value : -1;
+}
+
+} // namespace
+
+StateKey StateEncoder::encode(const double* state, size_t size) {
+    if (size != FEATURE_COUNT) {
+        return hashState(state, size);
+    }
+
+    constexpr long GRID_X = GameConfig::GRID_SIZE_X;
+    constexpr long GRID_Y = GameConfig::GRID_SIZE_Y;
+
+    // Layout documented in Game::getStateVector
+    long head_x = decodeField(state[0], GRID_X, GRID_X / 2, GRID_X);
+    long head_y = decodeField(state[1], GRID_Y, GRID_Y / 2, GRID_Y);
+    long apple_x = decodeField(state[2], GRID_X, GRID_X / 2, GRID_X);
+    long apple_y = decodeField(state[3], GRID_Y, GRID_Y / 2, GRID_Y);
+    long length = decodeField(state[16], GRID_X * GRID_Y, 0, GRID_X * GRID_Y + 1);
+
+    long direction = -1;
+    for (int i = 0; i < 4; ++i) {
+        if (state[4 + i] == 1.0) {
+            direction = i;
+        }
+    }
+
+    if (head_x < 0 || head_y < 0 || apple_x < 0 || apple_y < 0 || length < 0 || direction < 0) {
+        return hashState(state, size);
+    }
+
+    PackedFields fields;
+    fields.head_x = static_cast<int>(head_x);
+    fields.head_y = static_cast<int>(head_y);
+    fields.apple_x = static_cast<int>(apple_x);
+    fields.apple_y = static_cast<int>(apple_y);
+    fields.direction = static_cast<int>(direction);
+    fields.obstacles = 0;
+    fields.length = static_cast<int>(length);
+    for (int i = 0; i < 4; ++i) {
+        if (state[12 + i] > 0.5) {
+            fields.obstacles |= 1 << i;
+        }
+    }
+
+    return pack(fields);
+}
+
+StateKey StateEncoder::encode(const std::vector<double>& state) {
+    return encode(state.data(), state.size());
+}
+
+void StateEncoder::encodeBatch(const StateBatch& states, StateKey* keys) {
+    const size_t batch_size = states.size();
+    for (size_t i = 0; i < batch_size; ++i) {
+        keys[i] = encode(states.row(i), states.state_size);
+    }
+}
+
+std::vector<double> StateEncoder::parseStateString(const std::string& state_str) {
+    std::vector<double> state;
+    std::istringstream iss(state_str);
+    std::string token;
+    while (std::getline(iss, token, ',')) {
+        state.push_back(std::stod(token));
+    }
+    return state;
+}
+
+bool StateEncoder::isPacked(StateKey key) {
+    return (key & HASHED_KEY_FLAG) == 0;
+}
+
+StateKey StateEncoder::pack(const PackedFields& fields) {
+    StateKey key = 0;
+    int shift = 0;
+    key |= static_cast<StateKey>(fields.head_x) << shift;    shift += COORD_BITS_X;
+    key |= static_cast<StateKey>(fields.head_y) << shift;    shift += COORD_BITS_Y;
+    key |= static_cast<StateKey>(fields.apple_x) << shift;   shift += COORD_BITS_X;
+    key |= static_cast<StateKey>(fields.apple_y) << shift;   shift += COORD_BITS_Y;
+    key |= static_cast<StateKey>(fields.direction) << shift; shift += DIRECTION_BITS;
+    key |= static_cast<StateKey>(fields.obstacles) << shift; shift += OBSTACLE_BITS;
+    key |= static_cast<StateKey>(fields.length) << shift;
+    return key;
+}
+
+StateEncoder::PackedFields StateEncoder::unpack(StateKey key) {
+    auto take = [&key](int bits) {
+        int value = static_cast<int>(key & ((StateKey(1) << bits) - 1));
+        key >>= bits;
+        return value;
+    };
+
+    PackedFields fields;
+    fields.head_x = take(COORD_BITS_X);
+    fields.head_y = take(COORD_BITS_Y);
+    fields.apple_x = take(COORD_BITS_X);
+    fields.apple_y = take(COORD_BITS_Y);
+    fields.direction = take(DIRECTION_BITS);
+    fields.obstacles = take(OBSTACLE_BITS);
+    fields.length = take(LENGTH_BITS);
+    return fields;
+}
+
+StateKey StateEncoder::hashState(const double* state, size_t size) {
+    // FNV-1a over the values quantized to two decimals
+    StateKey hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; ++i) {
+        auto quantized = static_cast<int64_t>(std::llround(state[i] * 100.0));
+        hash ^= static_cast<StateKey>(quantized);
+        hash *= 1099511628211ULL;
+    }
+    // Never produce the all-ones key, which hash tables use as the empty marker
+    return (hash | HASHED_KEY_FLAG) & ~StateKey(1);
+}
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,137 @@
+#include "rl/state_symmetry.h"
+
+namespace SnakeGame::RL {
+
+namespace {
+
+constexpr int GRID_X = GameConfig::GRID_SIZE_X;
+constexpr int GRID_Y = GameConfig::GRID_SIZE_Y;
+constexpr bool SQUARE_GRID = GRID_X == GRID_Y;
+
+// Unit vectors of Direction::UP, DOWN, LEFT, RIGHT (y grows upwards)
+constexpr int DIRECTION_DX[4] = {0, 0, -1, 1};
+constexpr int DIRECTION_DY[4] = {1, -1, 0, 0};
+
+/**
+ * Lookup tables for the 8 transforms. Transform bits: 1 = mirror x,
+ * 2 = mirror y, 4 = swap axes (applied first). Mirroring maps cell i to
+ * GRID - 1 - i, which is the reflection through the board centre.
+ */
+struct SymmetryTables {
+    bool valid[StateSymmetry::NUM_TRANSFORMS];
+    uint8_t cell_x[StateSymmetry::NUM_TRANSFORMS][GRID_X * GRID_Y];
+    uint8_t cell_y[StateSymmetry::NUM_TRANSFORMS][GRID_X * GRID_Y];
+    uint8_t action[StateSymmetry::NUM_TRANSFORMS][4];
+    uint8_t inverse_action[StateSymmetry::NUM_TRANSFORMS][4];
+    uint8_t obstacles[StateSymmetry::NUM_TRANSFORMS][16];
+
+    SymmetryTables() {
+        for (int t = 0; t < StateSymmetry::NUM_TRANSFORMS; ++t) {
+            bool swap = (t & 4) != 0;
+            bool mirror_x = (t & 1) != 0;
+            bool mirror_y = (t & 2) != 0;
+            valid[t] = !swap || SQUARE_GRID;
+            if (!valid[t]) {
+                continue;
+            }
+
+            for (int x = 0; x < GRID_X; ++x) {
+                for (int y = 0; y < GRID_Y; ++y) {
+                    int tx = swap ? y : x;
+                    int ty = swap ? x : y;
+                    if (mirror_x) tx = GRID_X - 1 - tx;
+                    if (mirror_y) ty = GRID_Y - 1 - ty;
+                    cell_x[t][x + y * GRID_X] = static_cast<uint8_t>(tx);
+                    cell_y[t][x + y * GRID_X] = static_cast<uint8_t>(ty);
+                }
+            }
+
+            for (int a = 0; a < 4; ++a) {
+                int dx = swap ? DIRECTION_DY[a] : DIRECTION_DX[a];
+                int dy = swap ? DIRECTION_DX[a] : DIRECTION_DY[a];
+                if (mirror_x) dx = -dx;
+                if (mirror_y) dy = -dy;
+                for (int b = 0; b < 4; ++b) {
+                    if (DIRECTION_DX[b] == dx && DIRECTION_DY[b] == dy) {
+                        action[t][a] = static_cast<uint8_t>(b);
+                        inverse_action[t][b] = static_cast<uint8_t>(a);
+                    }
+                }
+            }
+
+            for (int mask = 0; mask < 16; ++mask) {
+                int mapped = 0;
+                for (int a = 0; a < 4; ++a) {
+                    if (mask & (1 << a)) {
+                        mapped |= 1 << action[t][a];
+                    }
+                }
+                obstacles[t][mask] = static_cast<uint8_t>(mapped);
+            }
+        }
+    }
+};
+
+const SymmetryTables& tables() {
+    static const SymmetryTables instance;
+    return instance;
+}
+
+StateKey transformFields(const StateEncoder::PackedFields& fields, int t, const SymmetryTables& tab) {
+    int head = fields.head_x + fields.head_y * GRID_X;
+    int apple = fields.apple_x + fields.apple_y * GRID_X;
+
+    StateEncoder::PackedFields mapped;
+    mapped.head_x = tab.cell_x[t][head];
+    mapped.head_y = tab.cell_y[t][head];
+    mapped.apple_x = tab.cell_x[t][apple];
+    mapped.apple_y = tab.cell_y[t][apple];
+    mapped.direction = tab.action[t][fields.direction];
+    mapped.obstacles = tab.obstacles[t][fields.obstacles];
+    mapped.length = fields.length;
+    return StateEncoder::pack(mapped);
+}
+
+} // namespace
+
+CanonicalState StateSymmetry::canonicalize(StateKey key) {
+    if (!StateEncoder::isPacked(key)) {
+        return {key, IDENTITY};
+    }
+
+    const SymmetryTables& tab = tables();
+    StateEncoder::PackedFields fields = StateEncoder::unpack(key);
+
+    CanonicalState best = {key, IDENTITY};
+    for (int t = 1; t < NUM_TRANSFORMS; ++t) {
+        if (!tab.valid[t]) {
+            continue;
+        }
+        StateKey candidate = transformFields(fields, t, tab);
+        if (candidate < best.key) {
+            best = {candidate, static_cast<uint8_t>(t)};
+        }
+    }
+    return best;
+}
+
+StateKey StateSymmetry::transform(StateKey key, int transform) {
+    if (!StateEncoder::isPacked(key) || !isValidTransform(transform)) {
+        return key;
+    }
+    return transformFields(StateEncoder::unpack(key), transform, tables());
+}
+
+int StateSymmetry::toCanonicalAction(int action, int transform) {
+    return tables().action[transform][action];
+}
+
+int StateSymmetry::fromCanonicalAction(int action, int transform) {
+    return tables().inverse_action[transform][action];
+}
+
+bool StateSymmetry::isValidTransform(int transform) {
+    return transform >= 0 && transform < NUM_TRANSFORMS && tables().valid[transform];
+}
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,90 @@
+#include "rl/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+
+namespace SnakeGame::RL {
+
+ThreadPool::ThreadPool(size_t num_threads)
+    : task_(nullptr)
+    , generation_(0)
+    , running_(0)
+    , stopping_(false) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads_.reserve(num_threads);
+    for (size_t worker = 0; worker < num_threads; ++worker) {
+        threads_.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    job_ready_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::size() const {
+    return threads_.size();
+}
+
+void ThreadPool::runOnAll(const std::function<void(size_t worker)>& task) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_ = &task;
+    running_ = threads_.size();
+    error_ = nullptr;
+    generation_++;
+    job_ready_.notify_all();
+
+    job_done_.wait(lock, [this] { return running_ == 0; });
+    task_ = nullptr;
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t index, size_t worker)>& body) {
+    std::atomic<size_t> next(0);
+    runOnAll([&](size_t worker) {
+        for (size_t index = next.fetch_add(1, std::memory_order_relaxed); index < count;
+             index = next.fetch_add(1, std::memory_order_relaxed)) {
+            body(index, worker);
+        }
+    });
+}
+
+void ThreadPool::workerLoop(size_t worker) {
+    size_t seen_generation = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        job_ready_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+        if (stopping_) {
+            return;
+        }
+        seen_generation = generation_;
+        const std::function<void(size_t)>* task = task_;
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            (*task)(worker);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        if (error && !error_) {
+            error_ = error;
+        }
+        if (--running_ == 0) {
+            job_done_.notify_all();
+        }
+    }
+}
+
+} // namespace SnakeGame::RL
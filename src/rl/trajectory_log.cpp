@@ -0,0 +1,305 @@
+#include "rl/trajectory_log.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace SnakeGame::RL {
+
+namespace {
+
+constexpr uint64_t TRAJECTORY_MAGIC = 0x31304A52544B4E53ULL; // "SNKTRJ01"
+constexpr uint8_t FLAG_REWARDS = 1;
+
+// Action encoding of SnakeEnvironment::intToDirection
+constexpr Direction ACTION_DIRECTIONS[4] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+
+uint64_t readMagic(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    uint64_t magic = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    return magic;
+}
+
+} // namespace
+
+// TrajectoryWriter implementation
+TrajectoryWriter::TrajectoryWriter(const std::string& filepath, bool record_rewards)
+    : file_(std::fopen(filepath.c_str(), "ab"))
+    , record_rewards_(record_rewards)
+    , seed_(0)
+    , max_steps_(0)
+    , steps_(0)
+    , episodes_(0)
+    , total_steps_(0)
+    , bytes_(0) {
+    if (!file_) {
+        throw std::runtime_error("Could not open file for saving: " + filepath);
+    }
+
+    std::fseek(file_, 0, SEEK_END);
+    if (std::ftell(file_) == 0) {
+        std::fwrite(&TRAJECTORY_MAGIC, sizeof(TRAJECTORY_MAGIC), 1, file_);
+        bytes_ = sizeof(TRAJECTORY_MAGIC);
+    } else if (readMagic(filepath) != TRAJECTORY_MAGIC) {
+        std::fclose(file_);
+        throw std::runtime_error("Not a trajectory log: " + filepath);
+    }
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+    std::fclose(file_);
+}
+
+void TrajectoryWriter::beginEpisode(unsigned int seed, size_t max_steps, const std::vector<double>& initial_state) {
+    seed_ = seed;
+    max_steps_ = max_steps;
+    steps_ = 0;
+    initial_state_.assign(initial_state.begin(), initial_state.end());
+
+    // Capacity survives clear(), so only a longer episode than any before allocates
+    packed_actions_.clear();
+    packed_actions_.reserve((max_steps + 3) / 4);
+    rewards_.clear();
+    if (record_rewards_) {
+        rewards_.reserve(max_steps);
+    }
+}
+
+void TrajectoryWriter::recordStep(int action, double reward) {
+    const size_t slot = steps_ % 4;
+    if (slot == 0) {
+        packed_actions_.push_back(0);
+    }
+    packed_actions_.back() |= static_cast<uint8_t>((action & 3) << (2 * slot));
+    if (record_rewards_) {
+        rewards_.push_back(static_cast<float>(reward));
+    }
+    steps_++;
+}
+
+void TrajectoryWriter::endEpisode(double score) {
+    record_.clear();
+    record_.putVarint(seed_);
+    record_.putVarint(max_steps_);
+    record_.putVarint(steps_);
+    record_.putByte(record_rewards_ ? FLAG_REWARDS : 0);
+    record_.putDouble(score);
+    record_.putVarint(initial_state_.size());
+    record_.putFloats(initial_state_.data(), initial_state_.size());
+    record_.buffer().insert(record_.buffer().end(), packed_actions_.begin(), packed_actions_.end());
+    record_.putFloats(rewards_.data(), rewards_.size());
+
+    // Length prefix, so readers can index records without decoding them
+    uint8_t prefix[10];
+    size_t prefix_size = 0;
+    for (size_t length = record_.size(); ; length >>= 7) {
+        prefix[prefix_size++] = static_cast<uint8_t>(length >= 0x80 ? (length & 0x7F) | 0x80 : length);
+        if (length < 0x80) {
+            break;
+        }
+    }
+
+    if (std::fwrite(prefix, 1, prefix_size, file_) != prefix_size ||
+        std::fwrite(record_.data(), 1, record_.size(), file_) != record_.size()) {
+        throw std::runtime_error("Failed to write trajectory log");
+    }
+    episodes_++;
+    total_steps_ += steps_;
+    bytes_ += prefix_size + record_.size();
+}
+
+void TrajectoryWriter::flush() {
+    std::fflush(file_);
+}
+
+size_t TrajectoryWriter::getEpisodes() const {
+    return episodes_;
+}
+
+size_t TrajectoryWriter::getSteps() const {
+    return total_steps_;
+}
+
+size_t TrajectoryWriter::getBytes() const {
+    return bytes_;
+}
+
+// TrajectoryReader implementation
+TrajectoryReader::TrajectoryReader(const std::string& filepath)
+    : total_steps_(0) {
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open trajectory log: " + filepath);
+    }
+    data_.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(data_.data()), static_cast<std::streamsize>(data_.size()))) {
+        throw std::runtime_error("Could not read trajectory log: " + filepath);
+    }
+
+    ByteReader magic(data_.data(), data_.size());
+    if (data_.size() < sizeof(TRAJECTORY_MAGIC) || magic.getUint64() != TRAJECTORY_MAGIC) {
+        throw std::runtime_error("Not a trajectory log: " + filepath);
+    }
+
+    size_t position = sizeof(TRAJECTORY_MAGIC);
+    while (position < data_.size()) {
+        ByteReader in(data_.data() + position, data_.size() - position);
+        uint64_t length = 0;
+        try {
+            length = in.getVarint();
+        } catch (const std::runtime_error&) {
+            break; // Partial length prefix at the end of the file
+        }
+        if (length > in.remaining()) {
+            break;
+        }
+
+        const size_t offset = position + in.position();
+        ByteReader header(data_.data() + offset, static_cast<size_t>(length));
+        header.getVarint(); // Seed
+        header.getVarint(); // Max steps
+        total_steps_ += static_cast<size_t>(header.getVarint());
+
+        offsets_.push_back(offset);
+        lengths_.push_back(static_cast<size_t>(length));
+        position = offset + static_cast<size_t>(length);
+    }
+}
+
+size_t TrajectoryReader::size() const {
+    return offsets_.size();
+}
+
+EpisodeRecording TrajectoryReader::read(size_t episode) const {
+    if (episode >= offsets_.size()) {
+        throw std::out_of_range("Episode index out of range: " + std::to_string(episode));
+    }
+
+    ByteReader in(data_.data() + offsets_[episode], lengths_[episode]);
+    EpisodeRecording recording;
+    recording.seed = static_cast<unsigned int>(in.getVarint());
+    recording.max_steps = static_cast<size_t>(in.getVarint());
+    const size_t steps = static_cast<size_t>(in.getVarint());
+    const uint8_t flags = in.getByte();
+    recording.score = in.getDouble();
+
+    recording.initial_state.resize(static_cast<size_t>(in.getVarint()));
+    in.getFloats(recording.initial_state.data(), recording.initial_state.size());
+
+    recording.actions.resize(steps);
+    for (size_t step = 0; step < steps; step += 4) {
+        uint8_t packed = in.getByte();
+        for (size_t slot = 0; slot < 4 && step + slot < steps; ++slot) {
+            recording.actions[step + slot] = (packed >> (2 * slot)) & 3;
+        }
+    }
+
+    if (flags & FLAG_REWARDS) {
+        recording.rewards.resize(steps);
+        in.getFloats(recording.rewards.data(), steps);
+    }
+    return recording;
+}
+
+size_t TrajectoryReader::getSteps() const {
+    return total_steps_;
+}
+
+// TrajectoryReplayer implementation
+TrajectoryReplayer::TrajectoryReplayer(EpisodeRecording recording)
+    : recording_(std::move(recording))
+    , step_(0) {
+    restart();
+}
+
+void TrajectoryReplayer::restart() {
+    // Same order as SnakeEnvironment::reset(): seed, then place the first apple
+    game_.setSeed(recording_.seed);
+    game_.reset();
+    step_ = 0;
+}
+
+bool TrajectoryReplayer::advance() {
+    if (step_ >= recording_.actions.size()) {
+        return false;
+    }
+    game_.performAction(ACTION_DIRECTIONS[recording_.actions[step_] & 3]);
+    step_++;
+    return true;
+}
+
+void TrajectoryReplayer::seek(size_t step) {
+    step = std::min(step, recording_.actions.size());
+    if (step < step_) {
+        restart();
+    }
+    while (step_ < step) {
+        advance();
+    }
+}
+
+size_t TrajectoryReplayer::getStep() const {
+    return step_;
+}
+
+size_t TrajectoryReplayer::getLength() const {
+    return recording_.actions.size();
+}
+
+double TrajectoryReplayer::getLastReward() const {
+    return game_.getReward();
+}
+
+const Game& TrajectoryReplayer::getGame() const {
+    return game_;
+}
+
+const EpisodeRecording& TrajectoryReplayer::getRecording() const {
+    return recording_;
+}
+
+bool TrajectoryReplayer::verify(std::string* mismatch) {
+    auto fail = [&](const std::string& message) {
+        if (mismatch) {
+            *mismatch = message;
+        }
+        return false;
+    };
+
+    restart();
+    if (!recording_.initial_state.empty()) {
+        std::vector<double> state = game_.getStateVector();
+        if (state.size() != recording_.initial_state.size()) {
+            return fail("initial state has " + std::to_string(state.size()) + " values, recorded " +
+                        std::to_string(recording_.initial_state.size()));
+        }
+        for (size_t i = 0; i < state.size(); ++i) {
+            if (static_cast<float>(state[i]) != recording_.initial_state[i]) {
+                return fail("initial state differs at value " + std::to_string(i));
+            }
+        }
+    }
+
+    const bool check_rewards = recording_.rewards.size() == recording_.actions.size();
+    while (step_ < recording_.actions.size()) {
+        if (game_.isGameOver()) {
+            return fail("game over at step " + std::to_string(step_) + " of " +
+                        std::to_string(recording_.actions.size()));
+        }
+        advance();
+        float reward = static_cast<float>(game_.getReward());
+        if (check_rewards && reward != recording_.rewards[step_ - 1]) {
+            return fail("step " + std::to_string(step_) + ": reward " + std::to_string(reward) +
+                        ", recorded " + std::to_string(recording_.rewards[step_ - 1]));
+        }
+    }
+
+    if (static_cast<double>(game_.getScore()) != recording_.score) {
+        return fail("final score " + std::to_string(game_.getScore()) + ", recorded " +
+                    std::to_string(recording_.score));
+    }
+    return true;
+}
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,410 @@
+#include "rl/transition_dataset.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SnakeGame::RL {
+
+namespace {
+
+constexpr uint64_t DATASET_MAGIC = 0x313044464F4B4E53ULL; // "SNKOFD01"
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr size_t COLUMN_ALIGNMENT = 64;
+constexpr size_t CHUNK_ALIGNMENT = 4096;
+
+struct FileHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t state_size;
+    uint64_t chunk_rows;
+    uint64_t rows;
+    uint64_t chunks;
+    uint64_t index_offset;      // Chunk index: offset and row count per chunk
+    uint64_t reserved[2];
+};
+static_assert(sizeof(FileHeader) == 64, "Dataset header layout changed");
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Column offsets within a chunk, in the order they are written
+struct ChunkLayout {
+    size_t states;
+    size_t next_states;
+    size_t rewards;
+    size_t actions;
+    size_t dones;
+    size_t end;
+};
+
+ChunkLayout chunkLayout(size_t rows, size_t state_size) {
+    ChunkLayout layout;
+    layout.states = 0;
+    layout.next_states = alignUp(layout.states + rows * state_size * sizeof(float), COLUMN_ALIGNMENT);
+    layout.rewards = alignUp(layout.next_states + rows * state_size * sizeof(float), COLUMN_ALIGNMENT);
+    layout.actions = alignUp(layout.rewards + rows * sizeof(float), COLUMN_ALIGNMENT);
+    layout.dones = alignUp(layout.actions + rows, COLUMN_ALIGNMENT);
+    layout.end = layout.dones + rows;
+    return layout;
+}
+
+} // namespace
+
+// TransitionDatasetWriter implementation
+TransitionDatasetWriter::TransitionDatasetWriter(const std::string& filepath, size_t state_size, size_t chunk_rows)
+    : path_(filepath)
+    , temp_path_(filepath + ".tmp")
+    , file_(nullptr)
+    , state_size_(state_size)
+    , chunk_rows_(chunk_rows)
+    , rows_(0)
+    , bytes_(0)
+    , chunk_fill_(0)
+    , states_(chunk_rows * state_size)
+    , next_states_(chunk_rows * state_size)
+    , rewards_(chunk_rows)
+    , actions_(chunk_rows)
+    , dones_(chunk_rows) {
+    if (state_size == 0 || chunk_rows == 0) {
+        throw std::invalid_argument("Dataset needs a positive state size and chunk size");
+    }
+    file_ = std::fopen(temp_path_.c_str(), "wb");
+    if (!file_) {
+        throw std::runtime_error("Could not open file for saving: " + temp_path_);
+    }
+
+    // The header is rewritten by finish(); chunks start on the next page
+    FileHeader header = {};
+    write(&header, sizeof(header));
+    pad(CHUNK_ALIGNMENT);
+}
+
+TransitionDatasetWriter::~TransitionDatasetWriter() {
+    if (file_) {
+        finalize();
+    }
+}
+
+void TransitionDatasetWriter::add(const std::vector<double>& state, int action, double reward,
+                                  const std::vector<double>& next_state, bool done) {
+    if (state.size() != state_size_ || next_state.size() != state_size_) {
+        throw std::invalid_argument("Transition state size does not match the dataset");
+    }
+    float* state_row = states_.data() + chunk_fill_ * state_size_;
+    float* next_row = next_states_.data() + chunk_fill_ * state_size_;
+    for (size_t i = 0; i < state_size_; ++i) {
+        state_row[i] = static_cast<float>(state[i]);
+        next_row[i] = static_cast<float>(next_state[i]);
+    }
+    nextRow(action, static_cast<float>(reward), done);
+}
+
+void TransitionDatasetWriter::add(const float* state, int action, float reward, const float* next_state, bool done) {
+    std::memcpy(states_.data() + chunk_fill_ * state_size_, state, state_size_ * sizeof(float));
+    std::memcpy(next_states_.data() + chunk_fill_ * state_size_, next_state, state_size_ * sizeof(float));
+    nextRow(action, reward, done);
+}
+
+size_t TransitionDatasetWriter::collect(Environment& env, Agent& agent, size_t transitions) {
+    std::vector<double> state = env.reset();
+    for (size_t written = 0; written < transitions; ++written) {
+        int action = agent.selectAction(state);
+        auto [next_state, reward] = env.step(action);
+        bool done = env.isDone();
+        add(state, action, reward, next_state, done);
+        state = done ? env.reset() : std::move(next_state);
+    }
+    return transitions;
+}
+
+void TransitionDatasetWriter::finish() {
+    if (!file_) {
+        return;
+    }
+    if (!finalize()) {
+        throw std::runtime_error("Failed to write dataset " + path_);
+    }
+}
+
+size_t TransitionDatasetWriter::getRows() const {
+    return rows_;
+}
+
+size_t TransitionDatasetWriter::getChunks() const {
+    return chunk_offsets_.size();
+}
+
+size_t TransitionDatasetWriter::getBytes() const {
+    return bytes_;
+}
+
+void TransitionDatasetWriter::nextRow(int action, float reward, bool done) {
+    if (!file_) {
+        throw std::logic_error("Cannot add transitions to a finished dataset");
+    }
+    rewards_[chunk_fill_] = reward;
+    actions_[chunk_fill_] = static_cast<uint8_t>(action);
+    dones_[chunk_fill_] = done ? 1 : 0;
+    rows_++;
+    if (++chunk_fill_ == chunk_rows_) {
+        writeChunk();
+    }
+}
+
+void TransitionDatasetWriter::writeChunk() {
+    const size_t rows = chunk_fill_;
+    const size_t state_bytes = rows * state_size_ * sizeof(float);
+    chunk_offsets_.push_back(bytes_);
+    chunk_sizes_.push_back(rows);
+
+    write(states_.data(), state_bytes);
+    pad(COLUMN_ALIGNMENT);
+    write(next_states_.data(), state_bytes);
+    pad(COLUMN_ALIGNMENT);
+    write(rewards_.data(), rows * sizeof(float));
+    pad(COLUMN_ALIGNMENT);
+    write(actions_.data(), rows);
+    pad(COLUMN_ALIGNMENT);
+    write(dones_.data(), rows);
+    pad(CHUNK_ALIGNMENT);
+    chunk_fill_ = 0;
+}
+
+void TransitionDatasetWriter::write(const void* data, size_t size) {
+    if (size > 0 && std::fwrite(data, 1, size, file_) != size) {
+        throw std::runtime_error("Failed to write dataset " + temp_path_);
+    }
+    bytes_ += size;
+}
+
+void TransitionDatasetWriter::pad(size_t alignment) {
+    static const uint8_t zeros[CHUNK_ALIGNMENT] = {};
+    write(zeros, alignUp(bytes_, alignment) - bytes_);
+}
+
+bool TransitionDatasetWriter::finalize() {
+    std::FILE* file = file_;
+    bool ok = true;
+    try {
+        if (chunk_fill_ > 0) {
+            writeChunk();
+        }
+
+        FileHeader header = {};
+        header.magic = DATASET_MAGIC;
+        header.version = FORMAT_VERSION;
+        header.state_size = static_cast<uint32_t>(state_size_);
+        header.chunk_rows = chunk_rows_;
+        header.rows = rows_;
+        header.chunks = chunk_offsets_.size();
+        header.index_offset = bytes_;
+        for (size_t i = 0; i < chunk_offsets_.size(); ++i) {
+            uint64_t entry[2] = {chunk_offsets_[i], chunk_sizes_[i]};
+            write(entry, sizeof(entry));
+        }
+        ok = std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    } catch (const std::runtime_error&) {
+        ok = false;
+    }
+
+    file_ = nullptr;
+    ok = std::fclose(file) == 0 && ok;
+    // rename() replaces the destination atomically on POSIX
+    if (!ok || std::rename(temp_path_.c_str(), path_.c_str()) != 0) {
+        std::remove(temp_path_.c_str());
+        return false;
+    }
+    return true;
+}
+
+// TransitionDatasetReader implementation
+TransitionDatasetReader::TransitionDatasetReader(const std::string& filepath)
+    : path_(filepath)
+    , fd_(-1)
+    , mapping_(nullptr)
+    , mapping_size_(0)
+    , state_size_(0)
+    , chunk_rows_(0)
+    , rows_(0)
+    , gen_(std::random_device{}()) {
+#ifdef _WIN32
+    throw std::runtime_error("Transition datasets require POSIX mmap");
+#else
+    fd_ = ::open(filepath.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        throw std::runtime_error("Could not open dataset " + filepath + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (::fstat(fd_, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+        release();
+        throw std::runtime_error("Not a transition dataset: " + filepath);
+    }
+    mapping_size_ = static_cast<size_t>(info.st_size);
+    mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        release();
+        throw std::runtime_error("Could not map dataset " + filepath + ": " + std::strerror(errno));
+    }
+
+    // Validate the header and index before trusting any offset
+    const uint8_t* base = static_cast<const uint8_t*>(mapping_);
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    const bool index_fits = header.index_offset <= mapping_size_ &&
+                            header.chunks <= (mapping_size_ - header.index_offset) / (2 * sizeof(uint64_t));
+    if (header.magic != DATASET_MAGIC || header.version != FORMAT_VERSION || header.state_size == 0 ||
+        header.chunk_rows == 0 || !index_fits) {
+        release();
+        throw std::runtime_error("Not a transition dataset or unsupported version: " + filepath);
+    }
+    state_size_ = header.state_size;
+    chunk_rows_ = static_cast<size_t>(header.chunk_rows);
+    rows_ = static_cast<size_t>(header.rows);
+
+    size_t total_rows = 0;
+    chunks_.resize(static_cast<size_t>(header.chunks));
+    for (size_t i = 0; i < chunks_.size(); ++i) {
+        uint64_t entry[2];
+        std::memcpy(entry, base + header.index_offset + i * sizeof(entry), sizeof(entry));
+        const size_t offset = static_cast<size_t>(entry[0]);
+        const size_t rows = static_cast<size_t>(entry[1]);
+
+        // Every chunk but the last is full, so a row's chunk is row / chunk_rows
+        const bool last = i + 1 == chunks_.size();
+        ChunkLayout layout = chunkLayout(rows, state_size_);
+        if (rows == 0 || rows > chunk_rows_ || (!last && rows != chunk_rows_) || offset % COLUMN_ALIGNMENT != 0 ||
+            offset > header.index_offset || layout.end > header.index_offset - offset) {
+            release();
+            throw std::runtime_error("Dataset " + filepath + " has a corrupt chunk index");
+        }
+
+        DatasetChunk& chunk = chunks_[i];
+        const uint8_t* start = base + offset;
+        chunk.rows = rows;
+        chunk.states = reinterpret_cast<const float*>(start + layout.states);
+        chunk.next_states = reinterpret_cast<const float*>(start + layout.next_states);
+        chunk.rewards = reinterpret_cast<const float*>(start + layout.rewards);
+        chunk.actions = start + layout.actions;
+        chunk.dones = start + layout.dones;
+        total_rows += rows;
+    }
+    if (total_rows != rows_) {
+        release();
+        throw std::runtime_error("Dataset " + filepath + " has a corrupt chunk index");
+    }
+#endif
+}
+
+TransitionDatasetReader::~TransitionDatasetReader() {
+    release();
+}
+
+void TransitionDatasetReader::release() {
+#ifndef _WIN32
+    if (mapping_) {
+        ::munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+}
+
+size_t TransitionDatasetReader::size() const {
+    return rows_;
+}
+
+size_t TransitionDatasetReader::getStateSize() const {
+    return state_size_;
+}
+
+size_t TransitionDatasetReader::getChunkCount() const {
+    return chunks_.size();
+}
+
+const DatasetChunk& TransitionDatasetReader::chunk(size_t index) const {
+    if (index >= chunks_.size()) {
+        throw std::out_of_range("Dataset chunk index out of range: " + std::to_string(index));
+    }
+    return chunks_[index];
+}
+
+size_t TransitionDatasetReader::bytesMapped() const {
+    return mapping_size_;
+}
+
+void TransitionDatasetReader::read(size_t first, size_t count, TransitionBatch& batch) const {
+    if (first > rows_ || count > rows_ - first) {
+        throw std::out_of_range("Dataset rows out of range: " + std::to_string(first) + "+" + std::to_string(count));
+    }
+    batch.resize(count, state_size_);
+
+    // One run per column and chunk
+    size_t row = 0;
+    while (row < count) {
+        const size_t index = first + row;
+        const DatasetChunk& chunk = chunks_[index / chunk_rows_];
+        const size_t local = index % chunk_rows_;
+        const size_t run = std::min(count - row, chunk.rows - local);
+
+        std::memcpy(batch.states.data() + row * state_size_, chunk.states + local * state_size_,
+                    run * state_size_ * sizeof(float));
+        std::memcpy(batch.next_states.data() + row * state_size_, chunk.next_states + local * state_size_,
+                    run * state_size_ * sizeof(float));
+        std::memcpy(batch.rewards.data() + row, chunk.rewards + local, run * sizeof(float));
+        std::memcpy(batch.dones.data() + row, chunk.dones + local, run);
+        for (size_t i = 0; i < run; ++i) {
+            batch.actions[row + i] = chunk.actions[local + i];
+            batch.indices[row + i] = index + i;
+            batch.weights[row + i] = 1.0f;
+        }
+        row += run;
+    }
+}
+
+void TransitionDatasetReader::sample(size_t batch_size, TransitionBatch& batch) {
+    if (rows_ == 0) {
+        throw std::runtime_error("Cannot sample from an empty dataset");
+    }
+    batch.resize(batch_size, state_size_);
+
+    std::uniform_int_distribution<size_t> index_dist(0, rows_ - 1);
+    for (size_t row = 0; row < batch_size; ++row) {
+        batch.indices[row] = index_dist(gen_);
+    }
+    std::sort(batch.indices.begin(), batch.indices.end());
+    for (size_t row = 0; row < batch_size; ++row) {
+        copyRow(batch.indices[row], row, batch);
+    }
+}
+
+void TransitionDatasetReader::setSeed(unsigned int seed) {
+    gen_.seed(seed);
+}
+
+void TransitionDatasetReader::copyRow(size_t index, size_t row, TransitionBatch& batch) const {
+    const DatasetChunk& chunk = chunks_[index / chunk_rows_];
+    const size_t local = index % chunk_rows_;
+    std::memcpy(batch.states.data() + row * state_size_, chunk.states + local * state_size_,
+                state_size_ * sizeof(float));
+    std::memcpy(batch.next_states.data() + row * state_size_, chunk.next_states + local * state_size_,
+                state_size_ * sizeof(float));
+    batch.actions[row] = chunk.actions[local];
+    batch.rewards[row] = chunk.rewards[local];
+    batch.dones[row] = chunk.dones[local];
+    batch.weights[row] = 1.0f;
+}
+
+} // namespace SnakeGame::RL
@@ -0,0 +1,431 @@
+#include "rl/value_iteration_solver.h"
+#include "rl/q_learning_agent.h"
+#include "rl/state_encoder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace SnakeGame::RL {
+
+namespace {
+
+constexpr int NUM_ACTIONS = 4;
+constexpr uint32_t UNVISITED = ~uint32_t(0);
+constexpr uint64_t MAX_BODY_CODES = uint64_t(1) << 27;
+
+// Unit steps of Direction::UP, DOWN, LEFT, RIGHT (y grows upwards)
+constexpr int DIRECTION_DX[NUM_ACTIONS] = {0, 0, -1, 1};
+constexpr int DIRECTION_DY[NUM_ACTIONS] = {1, -1, 0, 0};
+
+int reverseDirection(int direction) {
+    return direction ^ 1; // UP <-> DOWN, LEFT <-> RIGHT
+}
+
+// Runs func(begin, end) over [0, count) split into contiguous chunks
+template <typename Func>
+void parallelFor(size_t count, size_t num_threads, Func&& func) {
+    num_threads = std::max<size_t>(1, std::min(num_threads, count));
+    if (num_threads == 1) {
+        func(size_t(0), count, size_t(0));
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads);
+    size_t chunk = (count + num_threads - 1) / num_threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+        size_t begin = t * chunk;
+        size_t end = std::min(count, begin + chunk);
+        workers.emplace_back([&func, begin, end, t]() { func(begin, end, t); });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace
+
+ValueIterationSolver::ValueIterationSolver(const SolverConfig& config)
+    : config_(config)
+    , cells_(config.board_size * config.board_size)
+    , occupancy_words_(0) {
+    if (config_.board_size < 3 || config_.board_size > 16) {
+        throw std::invalid_argument("Solver board size must be between 3 and 16");
+    }
+    if (config_.max_length < 2 || config_.max_length > cells_ - 2) {
+        throw std::invalid_argument("Solver max length must be between 2 and the board area minus 2");
+    }
+    if (config_.discount_factor < 0.0 || config_.discount_factor >= 1.0) {
+        throw std::invalid_argument("Solver discount factor must be in [0, 1)");
+    }
+
+    occupancy_words_ = (static_cast<size_t>(cells_) + 63) / 64;
+
+    // Bodies of length l occupy codes [offset(l), offset(l + 1)): head + (l - 1) directions
+    length_offsets_.assign(config_.max_length + 2, 0);
+    uint64_t total = 0;
+    for (int length = 2; length <= config_.max_length; ++length) {
+        length_offsets_[length] = total;
+        total += static_cast<uint64_t>(cells_) << (2 * (length - 1));
+        if (total > MAX_BODY_CODES) {
+            throw std::invalid_argument("Solver state space too large; reduce the board size or max length");
+        }
+    }
+    length_offsets_[config_.max_length + 1] = total;
+}
+
+void ValueIterationSolver::enumerate() {
+    codes_.clear();
+    next_body_.clear();
+    grown_body_.clear();
+
+    std::vector<uint32_t> index_of(length_offsets_[config_.max_length + 1], UNVISITED);
+    auto visit = [this, &index_of](uint64_t code) {
+        if (index_of[code] == UNVISITED) {
+            index_of[code] = static_cast<uint32_t>(codes_.size());
+            codes_.push_back(static_cast<uint32_t>(code));
+        }
+        return index_of[code];
+    };
+
+    // Game::reset: head at the origin, one segment to its left, moving right
+    int half = config_.board_size / 2;
+    int start_head = half + half * config_.board_size;
+    visit(encodeBody(2, start_head, static_cast<uint64_t>(Direction::RIGHT)));
+
+    // Breadth-first search; successors are appended in body order
+    std::vector<int> cells(config_.max_length);
+    for (size_t body = 0; body < codes_.size(); ++body) {
+        int length, head;
+        uint64_t directions;
+        decodeBody(codes_[body], length, head, directions);
+        bodyCells(length, head, directions, cells.data());
+
+        int current = static_cast<int>(directions & 3);
+        uint64_t direction_mask = (uint64_t(1) << (2 * (length - 1))) - 1;
+
+        for (int action = 0; action < NUM_ACTIONS; ++action) {
+            // Game::performAction ignores reversals
+            int direction = (action == reverseDirection(current)) ? current : action;
+            int new_head = stepCell(head, direction);
+
+            // The tail has already moved on when the collision is checked
+            bool collision = std::find(cells.begin(), cells.begin() + length - 1, new_head)
+                             != cells.begin() + length - 1;
+            if (collision) {
+                next_body_.push_back(COLLISION);
+                grown_body_.push_back(COLLISION);
+                continue;
+            }
+
+            uint64_t moved = ((directions << 2) | static_cast<uint64_t>(direction)) & direction_mask;
+            uint32_t next = visit(encodeBody(length, new_head, moved));
+
+            // Snake::grow extends the tail straight along the last segment; an
+            // apple can never sit on the cell the tail just left
+            uint32_t grown = next;
+            if (length < config_.max_length && new_head != cells[length - 1]) {
+                uint64_t last = (moved >> (2 * (length - 2))) & 3;
+                grown = visit(encodeBody(length + 1, new_head, moved | (last << (2 * (length - 1)))));
+            }
+
+            next_body_.push_back(next);
+            grown_body_.push_back(grown);
+        }
+    }
+
+    // Per-body occupancy, used to skip impossible apple cells and to respawn apples
+    size_t num_bodies = codes_.size();
+    heads_.resize(num_bodies);
+    free_cells_.resize(num_bodies);
+    occupancy_.assign(num_bodies * occupancy_words_, 0);
+    for (size_t body = 0; body < num_bodies; ++body) {
+        int length, head;
+        uint64_t directions;
+        decodeBody(codes_[body], length, head, directions);
+        bodyCells(length, head, directions, cells.data());
+
+        heads_[body] = static_cast<uint16_t>(head);
+        uint64_t* words = &occupancy_[body * occupancy_words_];
+        for (int i = 0; i < length; ++i) {
+            words[cells[i] / 64] |= uint64_t(1) << (cells[i] % 64);
+        }
+        int occupied = 0;
+        for (size_t w = 0; w < occupancy_words_; ++w) {
+            for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1) {
+                occupied++;
+            }
+        }
+        free_cells_[body] = static_cast<uint16_t>(cells_ - occupied);
+    }
+
+    values_.assign(num_bodies * cells_, 0.0f);
+    next_values_.assign(num_bodies * cells_, 0.0f);
+    mean_free_values_.assign(num_bodies, 0.0f);
+}
+
+SolverStats ValueIterationSolver::solve() {
+    if (codes_.empty()) {
+        enumerate();
+    }
+
+    size_t num_threads = threadCount();
+    std::cout << "Solving " << config_.board_size << "x" << config_.board_size
+              << " board (max length " << config_.max_length << "): "
+              << getNumBodies() << " bodies, " << getNumStates() << " states, "
+              << std::fixed << std::setprecision(1) << bytesUsed() / (1024.0 * 1024.0) << " MB, "
+              << num_threads << " threads" << std::endl;
+
+    SolverStats stats;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<double> residuals(num_threads);
+
+    while (stats.sweeps < config_.max_sweeps) {
+        parallelFor(codes_.size(), num_threads, [this](size_t begin, size_t end, size_t) {
+            computeMeanFreeValues(begin, end);
+        });
+
+        std::fill(residuals.begin(), residuals.end(), 0.0);
+        parallelFor(codes_.size(), num_threads, [this, &residuals](size_t begin, size_t end, size_t t) {
+            residuals[t] = sweep(begin, end);
+        });
+        values_.swap(next_values_);
+
+        stats.sweeps++;
+        stats.residual = *std::max_element(residuals.begin(), residuals.end());
+        stats.converged = stats.residual < config_.tolerance;
+
+        if (config_.report_interval > 0 && (stats.sweeps % config_.report_interval == 0 || stats.converged)) {
+            std::cout << "Sweep " << stats.sweeps
+                      << " | Residual: " << std::scientific << std::setprecision(3) << stats.residual
+                      << " | Start value: " << std::fixed << std::setprecision(3) << getStartValue() << std::endl;
+        }
+        if (stats.converged) {
+            break;
+        }
+    }
+
+    // Bring the respawn expectations in line with the final values
+    parallelFor(codes_.size(), num_threads, [this](size_t begin, size_t end, size_t) {
+        computeMeanFreeValues(begin, end);
+    });
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.num_bodies = getNumBodies();
+    stats.num_states = getNumStates();
+    stats.bytes_used = bytesUsed();
+
+    std::cout << (stats.converged ? "Converged" : "Stopped") << " after " << stats.sweeps << " sweeps in "
+              << std::fixed << std::setprecision(2) << stats.seconds << " s ("
+              << std::setprecision(1) << stats.sweeps * static_cast<double>(stats.num_states) / stats.seconds / 1e6
+              << " M state updates/sec)" << std::endl;
+    return stats;
+}
+
+double ValueIterationSolver::getStartValue() const {
+    if (codes_.empty()) {
+        return 0.0;
+    }
+
+    // The first apple is placed uniformly on a free cell of the start body
+    double sum = 0.0;
+    for (int cell = 0; cell < cells_; ++cell) {
+        if (!isOccupied(0, cell)) {
+            sum += values_[cell];
+        }
+    }
+    return sum / free_cells_[0];
+}
+
+void ValueIterationSolver::getQValues(size_t body, int apple_cell, double q_values[4]) const {
+    for (int action = 0; action < NUM_ACTIONS; ++action) {
+        q_values[action] = qValue(body, apple_cell, action);
+    }
+}
+
+int ValueIterationSolver::getBestAction(size_t body, int apple_cell) const {
+    double q_values[NUM_ACTIONS];
+    getQValues(body, apple_cell, q_values);
+    return static_cast<int>(std::max_element(q_values, q_values + NUM_ACTIONS) - q_values);
+}
+
+bool ValueIterationSolver::canExportPolicy() const {
+    return GameConfig::GRID_SIZE_X == GameConfig::GRID_SIZE_Y &&
+           config_.board_size == GameConfig::GRID_SIZE_X;
+}
+
+size_t ValueIterationSolver::exportPolicy(QLearningAgent& agent) const {
+    if (!canExportPolicy()) {
+        throw std::logic_error("Solver board does not match the game board; policy cannot be exported");
+    }
+
+    // Several bodies share one feature key; the agent gets their average Q-values
+    struct Projection {
+        double q[NUM_ACTIONS] = {0.0, 0.0, 0.0, 0.0};
+        size_t count = 0;
+    };
+    std::unordered_map<StateKey, Projection> projected;
+
+    const int size = config_.board_size;
+    for (size_t body = 0; body < codes_.size(); ++body) {
+        int length, head;
+        uint64_t directions;
+        decodeBody(codes_[body], length, head, directions);
+        int head_x = head % size;
+        int head_y = head / size;
+
+        StateEncoder::PackedFields fields;
+        fields.head_x = head_x;
+        fields.head_y = head_y;
+        fields.direction = static_cast<int>(directions & 3);
+        fields.length = length;
+
+        // Game::getStateVector checks neighbours without wrapping
+        fields.obstacles = 0;
+        for (int direction = 0; direction < NUM_ACTIONS; ++direction) {
+            int x = head_x + DIRECTION_DX[direction];
+            int y = head_y + DIRECTION_DY[direction];
+            if (x >= 0 && x < size && y >= 0 && y < size && isOccupied(body, x + y * size)) {
+                fields.obstacles |= 1 << direction;
+            }
+        }
+
+        for (int apple = 0; apple < cells_; ++apple) {
+            if (isOccupied(body, apple)) {
+                continue;
+            }
+            fields.apple_x = apple % size;
+            fields.apple_y = apple / size;
+
+            Projection& entry = projected[StateEncoder::pack(fields)];
+            for (int action = 0; action < NUM_ACTIONS; ++action) {
+                entry.q[action] += qValue(body, apple, action);
+            }
+            entry.count++;
+        }
+    }
+
+    for (auto& [key, entry] : projected) {
+        for (double& q : entry.q) {
+            q /= static_cast<double>(entry.count);
+        }
+        agent.setQValues(key, entry.q);
+    }
+    return projected.size();
+}
+
+size_t ValueIterationSolver::getNumBodies() const {
+    return codes_.size();
+}
+
+size_t ValueIterationSolver::getNumStates() const {
+    size_t states = 0;
+    for (uint16_t free : free_cells_) {
+        states += free;
+    }
+    return states;
+}
+
+size_t ValueIterationSolver::bytesUsed() const {
+    return codes_.size() * sizeof(uint32_t) + heads_.size() * sizeof(uint16_t) +
+           occupancy_.size() * sizeof(uint64_t) + free_cells_.size() * sizeof(uint16_t) +
+           (next_body_.size() + grown_body_.size()) * sizeof(uint32_t) +
+           (values_.size() + next_values_.size() + mean_free_values_.size()) * sizeof(float);
+}
+
+const SolverConfig& ValueIterationSolver::getConfig() const {
+    return config_;
+}
+
+uint64_t ValueIterationSolver::encodeBody(int length, int head, uint64_t directions) const {
+    return length_offsets_[length] + static_cast<uint64_t>(head) + directions * cells_;
+}
+
+void ValueIterationSolver::decodeBody(uint64_t code, int& length, int& head, uint64_t& directions) const {
+    length = 2;
+    while (code >= length_offsets_[length + 1]) {
+        length++;
+    }
+    code -= length_offsets_[length];
+    head = static_cast<int>(code % cells_);
+    directions = code / cells_;
+}
+
+void ValueIterationSolver::bodyCells(int length, int head, uint64_t directions, int* cells) const {
+    // Direction i is the move that took segment i onto segment i - 1
+    cells[0] = head;
+    for (int i = 1; i < length; ++i) {
+        cells[i] = stepCell(cells[i - 1], reverseDirection(static_cast<int>(directions & 3)));
+        directions >>= 2;
+    }
+}
+
+int ValueIterationSolver::stepCell(int cell, int direction) const {
+    const int size = config_.board_size;
+    int x = (cell % size + DIRECTION_DX[direction] + size) % size;
+    int y = (cell / size + DIRECTION_DY[direction] + size) % size;
+    return x + y * size;
+}
+
+bool ValueIterationSolver::isOccupied(size_t body, int cell) const {
+    return (occupancy_[body * occupancy_words_ + cell / 64] >> (cell % 64)) & 1;
+}
+
+double ValueIterationSolver::qValue(size_t body, int apple_cell, int action) const {
+    uint32_t next = next_body_[body * NUM_ACTIONS + action];
+    if (next == COLLISION) {
+        return config_.collision_penalty;
+    }
+    if (heads_[next] == apple_cell) {
+        uint32_t grown = grown_body_[body * NUM_ACTIONS + action];
+        return config_.apple_reward + config_.discount_factor * mean_free_values_[grown];
+    }
+    return config_.time_penalty + config_.discount_factor * values_[static_cast<size_t>(next) * cells_ + apple_cell];
+}
+
+void ValueIterationSolver::computeMeanFreeValues(size_t begin, size_t end) {
+    for (size_t body = begin; body < end; ++body) {
+        const float* row = &values_[body * cells_];
+        double sum = 0.0;
+        for (int cell = 0; cell < cells_; ++cell) {
+            if (!isOccupied(body, cell)) {
+                sum += row[cell];
+            }
+        }
+        mean_free_values_[body] = static_cast<float>(sum / free_cells_[body]);
+    }
+}
+
+double ValueIterationSolver::sweep(size_t begin, size_t end) {
+    double residual = 0.0;
+    for (size_t body = begin; body < end; ++body) {
+        float* row = &next_values_[body * cells_];
+        const float* old_row = &values_[body * cells_];
+        for (int apple = 0; apple < cells_; ++apple) {
+            if (isOccupied(body, apple)) {
+                continue;
+            }
+            double best = qValue(body, apple, 0);
+            for (int action = 1; action < NUM_ACTIONS; ++action) {
+                best = std::max(best, qValue(body, apple, action));
+            }
+            residual = std::max(residual, std::abs(best - static_cast<double>(old_row[apple])));
+            row[apple] = static_cast<float>(best);
+        }
+    }
+    return residual;
+}
+
+size_t ValueIterationSolver::threadCount() const {
+    if (config_.num_threads > 0) {
+        return config_.num_threads;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+} // namespace SnakeGame::RL
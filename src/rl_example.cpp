@@ -1,32 +1,182 @@
+#include "include/apple.h"
+#include "include/graphics.h"
+#include "include/snake.h"
 #include "include/rl/rl_interface.h"
 #include "include/rl/q_learning_agent.h"
+#include "include/rl/eligibility_trace_agent.h"
+#include "include/rl/prioritized_sweeping_agent.h"
+#include "include/rl/replay_buffer.h"
+#include "include/rl/checkpoint_writer.h"
+#include "include/rl/delta_checkpoint.h"
+#include "include/rl/dqn_agent.h"
+#include "include/rl/episode_exporter.h"
+#include "include/rl/es_agent.h"
+#include "include/rl/distributed_trainer.h"
+#include "include/rl/evaluation_engine.h"
+#include "include/rl/hyperparameter_sweep.h"
+#include "include/rl/pixel_renderer.h"
+#include "include/rl/population_trainer.h"
+#include "include/rl/metrics_sink.h"
+#include "include/rl/trajectory_log.h"
+#include "include/rl/transition_dataset.h"
+#include "include/rl/value_iteration_solver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <random>
+#include <sstream>
 #include <string>
+#include <thread>
 
 using namespace SnakeGame::RL;
 
 void printUsage(const char* program_name) {
     std::cout << "Usage: " << program_name << " [command] [options]" << std::endl;
     std::cout << "Commands:" << std::endl;
-    std::cout << "  train [episodes]     - Train Q-Learning agent (default: 1000 episodes)" << std::endl;
+    std::cout << "  train [episodes] [mb] [--symmetry] [--checkpoint N] [--delta] [--metrics file] [--watch fps]" << std::endl;
+    std::cout << "        [--record file]" << std::endl;
+    std::cout << "                       - Train Q-Learning agent (default: 1000 episodes, unbounded table)" << std::endl;
+    std::cout << "                         --symmetry shares one table entry across rotated/mirrored states" << std::endl;
+    std::cout << "                         --checkpoint N writes q_checkpoint_*.txt every N episodes in the background" << std::endl;
+    std::cout << "                         --delta writes them as q_checkpoint.qck plus changed-row deltas instead" << std::endl;
+    std::cout << "                         --metrics file logs every episode in the background (.bin for binary, else CSV)" << std::endl;
+    std::cout << "                         --watch fps shows the training game in the terminal at up to fps frames/s" << std::endl;
+    std::cout << "                         --record file appends every episode to a replayable trajectory log" << std::endl;
     std::cout << "  evaluate [episodes]  - Evaluate trained agent (default: 10 episodes)" << std::endl;
     std::cout << "  demo                 - Quick demo with random agent" << std::endl;
     std::cout << "  compare              - Compare random vs Q-Learning agent" << std::endl;
+    std::cout << "  train-dqn [episodes] - Train DQN agent on 16 batched envs (default: 2000 episodes)" << std::endl;
+    std::cout << "  bench-replay [cap]   - Benchmark replay buffer sampling (default: 1048576)" << std::endl;
+    std::cout << "  bench-dqn [threads]  - Benchmark DQN forward/backward throughput" << std::endl;
+    std::cout << "  collect-dataset [transitions] [file] [--random]" << std::endl;
+    std::cout << "                       - Write an offline transition dataset from the trained agent (epsilon 0.1)" << std::endl;
+    std::cout << "  bench-dataset [transitions] [batch] - Offline dataset write, scan and mmap sampling in GB/s" << std::endl;
+    std::cout << "  bench-select [batch] - Benchmark batched vs per-call action selection (default: 1024)" << std::endl;
+    std::cout << "  solve [size] [len] [threads] - Exact value iteration on a small board (default: game board, length 5)" << std::endl;
+    std::cout << "  train-shared [episodes] [name] [slots]" << std::endl;
+    std::cout << "                       - Train into a shared-memory Q-table (run several at once)" << std::endl;
+    std::cout << "  evaluate-shared [episodes] [name] - Evaluate greedily from a shared Q-table (read-only)" << std::endl;
+    std::cout << "  remove-shared [name] - Delete a shared Q-table segment" << std::endl;
+    std::cout << "  bench-traces [score] [episodes] [lambda]" << std::endl;
+    std::cout << "                       - Time for Q-learning vs Q(lambda)/SARSA(lambda) to reach an average score" << std::endl;
+    std::cout << "  bench-planning [episodes] [k] [budget_us]" << std::endl;
+    std::cout << "                       - Q-learning vs prioritized sweeping with k planning updates per step" << std::endl;
+    std::cout << "  bench-checkpoint [episodes] [interval] [runs]" << std::endl;
+    std::cout << "                       - Training throughput with and without background checkpoints" << std::endl;
+    std::cout << "  bench-delta [episodes] [interval] - Full text vs delta checkpoint sizes during training" << std::endl;
+    std::cout << "  compact-checkpoint [path] - Merge a .qck base and its deltas into a new base" << std::endl;
+    std::cout << "  evaluate-parallel [episodes] [threads] [report] - Seeded parallel evaluation with a JSON report" << std::endl;
+    std::cout << "  bench-eval [episodes] - Evaluation time and result equality for 1-8 threads" << std::endl;
+    std::cout << "  export-episodes [episodes] [skip] [--ppm] [--random] [--dir D] [--threads N] [--log file]" << std::endl;
+    std::cout << "                       - Replay greedy (or logged) episodes offline into episode_*.gif (or PPM frames)" << std::endl;
+    std::cout << "  replay [file] [episode] [step] - Verify a logged episode and show the board at a step" << std::endl;
+    std::cout << "  bench-record [episodes] - Trajectory logging overhead, bytes/step and replay speed (default: 20000)" << std::endl;
+    std::cout << "  bench-metrics [records] - Per-record logging cost: synchronous stream vs metrics sink" << std::endl;
+    std::cout << "  bench-console [steps] [fps] - Step cost of a diffed, throttled terminal view (default: 1000000, 30)" << std::endl;
+    std::cout << "  bench-pixels [frames] [size] [--rgb] [--stack N]" << std::endl;
+    std::cout << "                       - Pixel observation rendering and frame stacking rate (default: 1000000, 84, 4)" << std::endl;
+    std::cout << "  sweep [grid|random] [episodes] [threads] [lr=a,b] [gamma=..] [epsilon=..] [decay=..]" << std::endl;
+    std::cout << "        [--trials N] [--eta N] [--csv file]" << std::endl;
+    std::cout << "                       - Parallel hyperparameter search with successive halving (default: grid, 2700)" << std::endl;
+    std::cout << "  train-es [generations] [population] [--mlp] - Train an evolution-strategies policy (default: 50, 256)" << std::endl;
+    std::cout << "  bench-es [generations] [population] [--mlp] - ES episodes/s per generation for 1..N threads" << std::endl;
+    std::cout << "  bench-pbt [score] [population] [episodes] [threads] [--dqn]" << std::endl;
+    std::cout << "                       - Time to a target score: population-based training vs independent runs" << std::endl;
+    std::cout << "  train-distributed [workers] [episodes] [sync] [--dqn]" << std::endl;
+    std::cout << "                       - Train in worker processes synced through a parameter server" << std::endl;
+    std::cout << "                         (default: 4 workers, 1000 episodes each, sync every 50 episodes)" << std::endl;
 }
 
-void trainQLearningAgent(int episodes = 1000) {
+void trainQLearningAgent(int episodes = 1000, size_t memory_mb = 0, bool use_symmetry = false,
+                         size_t checkpoint_interval = 0, bool delta_checkpoints = false,
+                         const std::string& metrics_path = "", double watch_fps = 0.0,
+                         const std::string& record_path = "") {
     std::cout << "=== Training Q-Learning Agent ===" << std::endl;
     
     // Create environment and agent
     SnakeEnvironment env(true); // headless mode for faster training
     QLearningAgent agent(0.1, 0.95, 0.3); // lr=0.1, gamma=0.95, epsilon=0.3
     
+    // Optionally cap the Q-table, evicting rarely visited states when full
+    if (memory_mb > 0) {
+        agent.setMemoryBudget(memory_mb * 1024 * 1024, EvictionPolicy::VISIT_COUNT);
+        std::cout << "Q-table memory budget: " << memory_mb << " MB" << std::endl;
+    }
+    
+    // Optionally store one entry per rotation/reflection class of states
+    if (use_symmetry) {
+        agent.setSymmetryCanonicalization(true);
+        std::cout << "Symmetry canonicalization enabled" << std::endl;
+    }
+    
+    // Optionally checkpoint periodically without pausing training for the disk
+    std::shared_ptr<CheckpointWriter> checkpoints;
+    if (checkpoint_interval > 0) {
+        CheckpointConfig config;
+        config.format = delta_checkpoints ? CheckpointFormat::DELTA : CheckpointFormat::TEXT;
+        checkpoints = std::make_shared<CheckpointWriter>(config);
+        agent.setCheckpointWriter(checkpoints, checkpoint_interval);
+        std::cout << "Checkpointing every " << checkpoint_interval << " episodes" << std::endl;
+    }
+    
+    // Optionally log every episode on a background thread instead of printing every 100
+    std::shared_ptr<MetricsSink> metrics;
+    if (!metrics_path.empty()) {
+        MetricsConfig config;
+        config.path = metrics_path;
+        bool binary = metrics_path.size() >= 4 && metrics_path.compare(metrics_path.size() - 4, 4, ".bin") == 0;
+        config.format = binary ? MetricsFormat::BINARY : MetricsFormat::CSV;
+        metrics = std::make_shared<MetricsSink>(config);
+        agent.setMetricsSink(metrics);
+        std::cout << "Logging episode metrics to " << metrics_path << std::endl;
+    }
+    
+    // Optionally show the training game in the terminal, a few frames per second
+    if (watch_fps > 0.0) {
+        SnakeGame::ConsoleConfig config;
+        config.max_fps = watch_fps;
+        env.setLiveView(std::make_unique<SnakeGame::ConsoleGraphics>(config));
+    }
+    
+    // Optionally log every episode as its seed and actions, for exact replay later
+    std::shared_ptr<TrajectoryWriter> trajectories;
+    if (!record_path.empty()) {
+        trajectories = std::make_shared<TrajectoryWriter>(record_path);
+        env.setRecorder(trajectories);
+        std::cout << "Recording trajectories to " << record_path << std::endl;
+    }
+    
     // Configure environment
     env.setMaxSteps(500);
     env.setRewardStructure(10.0, -100.0, -1.0); // apple, collision, time penalty
     
     // Train the agent
     agent.train(env, episodes);
+    env.setLiveView(nullptr);
+    if (trajectories) {
+        env.setRecorder(nullptr);
+        trajectories->flush();
+        std::cout << "Trajectories recorded: " << trajectories->getEpisodes() << " episodes, "
+                  << trajectories->getSteps() << " steps, " << trajectories->getBytes() << " bytes" << std::endl;
+    }
+    if (checkpoints) {
+        checkpoints->flush();
+        CheckpointStats stats = checkpoints->getStats();
+        std::cout << "Checkpoints written: " << stats.written << " (skipped " << stats.skipped
+                  << ", failed " << stats.failed << "), latest: " << stats.last_path << std::endl;
+    }
+    if (metrics) {
+        metrics->flush();
+        std::cout << "Episode metrics written: " << metrics->getWritten()
+                  << " (dropped " << metrics->getDropped() << ", write failures "
+                  << metrics->getWriteFailures() << ")" << std::endl;
+        agent.setMetricsSink(nullptr);
+        metrics.reset();
+    }
     
     // Save the trained model
     agent.save("q_learning_model.txt");
@@ -145,6 +295,1397 @@ void compareAgents() {
     }
 }
 
+void trainDQNAgent(int episodes = 2000) {
+    std::cout << "=== Training DQN Agent ===" << std::endl;
+    
+    // Many headless environments share one batched forward pass per step
+    const size_t num_envs = 16;
+    std::vector<std::unique_ptr<SnakeEnvironment>> envs;
+    std::vector<Environment*> env_ptrs;
+    for (size_t i = 0; i < num_envs; ++i) {
+        envs.push_back(std::make_unique<SnakeEnvironment>(true));
+        envs.back()->setMaxSteps(500);
+        env_ptrs.push_back(envs.back().get());
+    }
+    
+    DQNAgent agent;
+    agent.trainVectorized(env_ptrs, episodes);
+    
+    agent.save("dqn_model.txt");
+    std::cout << "Model saved as 'dqn_model.txt'" << std::endl;
+}
+
+void benchmarkReplayBuffer(size_t capacity = 1 << 20) {
+    std::cout << "=== Replay Buffer Benchmark ===" << std::endl;
+    
+    const size_t state_size = 17;
+    const size_t batch_size = 256;
+    const size_t num_batches = 4000;
+    
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> value_dist(-1.0f, 1.0f);
+    std::vector<float> state(state_size);
+    std::vector<float> next_state(state_size);
+    std::vector<float> td_errors(batch_size);
+    
+    for (SamplingMode mode : {SamplingMode::UNIFORM, SamplingMode::PRIORITIZED}) {
+        const char* name = (mode == SamplingMode::UNIFORM) ? "Uniform" : "Prioritized";
+        ReplayBuffer buffer(capacity, state_size, mode);
+        buffer.setSeed(42);
+        
+        // Fill the buffer
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < capacity; ++i) {
+            for (size_t j = 0; j < state_size; ++j) {
+                state[j] = value_dist(gen);
+                next_state[j] = value_dist(gen);
+            }
+            buffer.add(state.data(), static_cast<int>(i % 4), value_dist(gen), next_state.data(), i % 100 == 0);
+        }
+        double fill_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        // Sample and update priorities
+        TransitionBatch batch;
+        double sample_seconds = 0.0;
+        double update_seconds = 0.0;
+        for (size_t b = 0; b < num_batches; ++b) {
+            start = std::chrono::steady_clock::now();
+            buffer.sample(batch_size, batch);
+            sample_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            
+            for (size_t i = 0; i < batch_size; ++i) {
+                td_errors[i] = value_dist(gen) * 10.0f;
+            }
+            start = std::chrono::steady_clock::now();
+            buffer.updatePriorities(batch, td_errors.data());
+            update_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        
+        double samples = static_cast<double>(batch_size * num_batches);
+        std::cout << name << " (capacity " << capacity << ", "
+                  << std::fixed << std::setprecision(1) << buffer.bytesUsed() / (1024.0 * 1024.0) << " MB)" << std::endl;
+        std::cout << "  Insert:  " << std::setprecision(2) << capacity / fill_seconds / 1e6 << " M transitions/sec" << std::endl;
+        std::cout << "  Sample:  " << samples / sample_seconds / 1e6 << " M samples/sec" << std::endl;
+        if (mode == SamplingMode::PRIORITIZED) {
+            std::cout << "  Update:  " << samples / update_seconds / 1e6 << " M priority updates/sec" << std::endl;
+        }
+    }
+}
+
+void collectDataset(size_t transitions, const std::string& path, bool use_random) {
+    std::cout << "=== Collecting " << transitions << " Transitions into " << path << " ===" << std::endl;
+    
+    std::unique_ptr<Agent> agent = std::make_unique<RandomAgent>();
+    if (!use_random) {
+        auto q_agent = std::make_unique<QLearningAgent>();
+        q_agent->load("q_learning_model.txt");
+        q_agent->setEpsilon(0.1); // Some exploration, so the data covers more than the greedy path
+        agent = std::move(q_agent);
+    }
+    
+    SnakeEnvironment env(true);
+    env.setMaxSteps(500);
+    TransitionDatasetWriter writer(path, env.reset().size());
+    auto start = std::chrono::steady_clock::now();
+    writer.collect(env, *agent, transitions);
+    writer.finish();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::fixed << std::setprecision(2) << "Wrote " << writer.getRows() << " transitions in "
+              << writer.getChunks() << " chunks (" << writer.getBytes() / (1024.0 * 1024.0) << " MB) in "
+              << std::setprecision(3) << seconds << " s" << std::endl;
+}
+
+void benchmarkDataset(size_t rows, size_t batch_size) {
+    std::cout << "=== Offline Dataset Benchmark (" << rows << " transitions, batch " << batch_size << ") ===" << std::endl;
+    const std::string path = "bench_dataset.bin";
+    const std::string copy_path = "bench_dataset_copy.bin";
+    auto secondsSince = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    
+    // Streamed straight from a random-agent environment
+    SnakeEnvironment env(true);
+    env.setMaxSteps(500);
+    env.setSeed(3);
+    RandomAgent agent;
+    agent.setSeed(5);
+    const size_t state_size = env.reset().size();
+    const size_t row_bytes = 2 * state_size * sizeof(float) + sizeof(float) + 2; // Column payload per transition
+    const double payload = static_cast<double>(rows * row_bytes);
+    
+    auto start = std::chrono::steady_clock::now();
+    size_t file_bytes = 0;
+    {
+        TransitionDatasetWriter writer(path, state_size);
+        writer.collect(env, agent, rows);
+        writer.finish();
+        file_bytes = writer.getBytes();
+    }
+    double seconds = secondsSince(start);
+    std::cout << std::fixed << std::setprecision(2) << "Collect from env:   " << std::setw(8) << rows / seconds / 1e6
+              << " M transitions/s | " << std::setw(6) << payload / seconds / 1e9 << " GB/s | File: "
+              << file_bytes / (1024.0 * 1024.0) << " MB (" << row_bytes << " bytes/transition)" << std::endl;
+    
+    // Writer alone: stream the mapped rows into a second file (page cache, no fsync)
+    TransitionDatasetReader reader(path);
+    start = std::chrono::steady_clock::now();
+    {
+        TransitionDatasetWriter writer(copy_path, state_size);
+        for (size_t c = 0; c < reader.getChunkCount(); ++c) {
+            const DatasetChunk& chunk = reader.chunk(c);
+            for (size_t r = 0; r < chunk.rows; ++r) {
+                writer.add(chunk.states + r * state_size, chunk.actions[r], chunk.rewards[r],
+                           chunk.next_states + r * state_size, chunk.dones[r] != 0);
+            }
+        }
+        writer.finish();
+    }
+    seconds = secondsSince(start);
+    std::cout << "Write:              " << std::setw(8) << rows / seconds / 1e6 << " M transitions/s | "
+              << std::setw(6) << payload / seconds / 1e9 << " GB/s" << std::endl;
+    
+    // Sequential scan in large blocks, checked against the copy
+    TransitionDatasetReader copy(copy_path);
+    TransitionBatch batch, copy_batch;
+    const size_t block = 65536;
+    bool identical = copy.size() == reader.size();
+    start = std::chrono::steady_clock::now();
+    for (size_t first = 0; first < rows; first += block) {
+        reader.read(first, std::min(block, rows - first), batch);
+    }
+    seconds = secondsSince(start);
+    for (size_t first = 0; identical && first < rows; first += block) {
+        size_t count = std::min(block, rows - first);
+        reader.read(first, count, batch);
+        copy.read(first, count, copy_batch);
+        identical = batch.states == copy_batch.states && batch.next_states == copy_batch.next_states &&
+                    batch.actions == copy_batch.actions && batch.rewards == copy_batch.rewards &&
+                    batch.dones == copy_batch.dones;
+    }
+    std::cout << "Sequential read:    " << std::setw(8) << rows / seconds / 1e6 << " M transitions/s | "
+              << std::setw(6) << payload / seconds / 1e9 << " GB/s | Copy " << (identical ? "identical" : "DIFFERENT")
+              << std::endl;
+    
+    // Random minibatches from the mapping vs an in-memory replay buffer holding the same rows
+    const size_t num_batches = 4000;
+    const double samples = static_cast<double>(num_batches * batch_size);
+    reader.setSeed(7);
+    start = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < num_batches; ++b) {
+        reader.sample(batch_size, batch);
+    }
+    seconds = secondsSince(start);
+    std::cout << "Sample (mmap):      " << std::setw(8) << samples / seconds / 1e6 << " M samples/s     | "
+              << std::setw(6) << samples * row_bytes / seconds / 1e9 << " GB/s" << std::endl;
+    
+    ReplayBuffer buffer(rows, state_size);
+    buffer.setSeed(7);
+    for (size_t c = 0; c < reader.getChunkCount(); ++c) {
+        const DatasetChunk& chunk = reader.chunk(c);
+        for (size_t r = 0; r < chunk.rows; ++r) {
+            buffer.add(chunk.states + r * state_size, chunk.actions[r], chunk.rewards[r],
+                       chunk.next_states + r * state_size, chunk.dones[r] != 0);
+        }
+    }
+    start = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < num_batches; ++b) {
+        buffer.sample(batch_size, batch);
+    }
+    seconds = secondsSince(start);
+    std::cout << "Sample (in memory): " << std::setw(8) << samples / seconds / 1e6 << " M samples/s     | "
+              << std::setw(6) << samples * row_bytes / seconds / 1e9 << " GB/s" << std::endl;
+    
+    std::remove(path.c_str());
+    std::remove(copy_path.c_str());
+}
+
+void benchmarkDQN(size_t num_threads) {
+    std::cout << "=== DQN Throughput Benchmark [" << MLP::simdBackend() << "] ===" << std::endl;
+    
+    const std::vector<size_t> layer_sizes = {17, 64, 64, 4};
+    const size_t batch_size = 256;
+    const size_t iterations = 2000;
+    
+    std::vector<float> input(batch_size * layer_sizes.front());
+    std::vector<float> output_grad(batch_size * layer_sizes.back());
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (float& x : input) x = dist(gen);
+    for (float& g : output_grad) g = dist(gen) / batch_size;
+    
+    // Each worker owns a network copy; returns {forward seconds, backward seconds}
+    auto run = [&](MLP& network) {
+        double forward_seconds = 0.0, backward_seconds = 0.0;
+        for (size_t i = 0; i < iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            network.forward(input.data(), batch_size);
+            auto mid = std::chrono::steady_clock::now();
+            network.zeroGradients();
+            network.backward(output_grad.data(), batch_size);
+            auto end = std::chrono::steady_clock::now();
+            forward_seconds += std::chrono::duration<double>(mid - start).count();
+            backward_seconds += std::chrono::duration<double>(end - mid).count();
+        }
+        return std::make_pair(forward_seconds, backward_seconds);
+    };
+    
+    const double samples = static_cast<double>(batch_size * iterations);
+    
+    MLP single(layer_sizes, 1);
+    auto [forward_seconds, backward_seconds] = run(single);
+    std::cout << "Single core (batch " << batch_size << ", " << single.getParameterCount() << " params)" << std::endl;
+    std::cout << "  Forward:  " << std::fixed << std::setprecision(0) << samples / forward_seconds << " samples/sec" << std::endl;
+    std::cout << "  Backward: " << samples / backward_seconds << " samples/sec" << std::endl;
+    
+    // Forward and backward run as separate all-thread phases, timed by wall clock
+    std::vector<MLP> networks(num_threads, single);
+    auto timeParallel = [&](auto pass) {
+        std::vector<std::thread> workers;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t t = 0; t < num_threads; ++t) {
+            workers.emplace_back([&, t]() {
+                for (size_t i = 0; i < iterations; ++i) {
+                    pass(networks[t]);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    double parallel_forward = timeParallel([&](MLP& network) { network.forward(input.data(), batch_size); });
+    // Backward reuses the activations of each network's last forward pass
+    double parallel_backward = timeParallel([&](MLP& network) {
+        network.zeroGradients();
+        network.backward(output_grad.data(), batch_size);
+    });
+    std::cout << num_threads << " thread(s)" << std::endl;
+    std::cout << "  Forward:  " << samples * num_threads / parallel_forward << " samples/sec" << std::endl;
+    std::cout << "  Backward: " << samples * num_threads / parallel_backward << " samples/sec" << std::endl;
+}
+
+void benchmarkActionSelection(size_t batch_size) {
+    std::cout << "=== Action Selection Benchmark (batch " << batch_size << ") ===" << std::endl;
+    
+    // Collect realistic observations from random rollouts
+    SnakeEnvironment env(true);
+    env.setMaxSteps(200);
+    RandomAgent explorer(42);
+    std::vector<std::vector<double>> states;
+    StateBatch batch(batch_size, env.getStateSpaceSize());
+    auto state = env.reset();
+    for (size_t i = 0; i < batch_size; ++i) {
+        if (env.isDone()) {
+            state = env.reset();
+        }
+        states.push_back(state);
+        batch.setRow(i, state);
+        state = env.step(explorer.selectAction(state)).first;
+    }
+    
+    // Give the tabular agent a populated table to look up
+    QLearningAgent q_agent(0.1, 0.95, 0.3);
+    std::cout << "Populating Q-table..." << std::endl;
+    {
+        std::streambuf* old_buffer = std::cout.rdbuf(nullptr);
+        q_agent.train(env, 2000);
+        std::cout.rdbuf(old_buffer);
+    }
+    q_agent.setEpsilon(0.05);
+    
+    RandomAgent random_agent(7);
+    DQNAgent dqn_agent;
+    dqn_agent.setEpsilon(0.05);
+    
+    const size_t repetitions = std::max<size_t>(1, (1 << 22) / batch_size);
+    std::vector<int> actions(batch_size);
+    
+    auto measure = [&](const char* name, Agent& agent, size_t reps) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < reps; ++r) {
+            for (size_t i = 0; i < batch_size; ++i) {
+                actions[i] = agent.selectAction(states[i]);
+            }
+        }
+        double per_call = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < reps; ++r) {
+            agent.selectActions(batch, actions);
+        }
+        double batched = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        double decisions = static_cast<double>(reps * batch_size);
+        std::cout << std::left << std::setw(12) << name << std::right
+                  << " per-call: " << std::fixed << std::setprecision(2) << std::setw(8) << decisions / per_call / 1e6 << " M/s"
+                  << " | batched: " << std::setw(8) << decisions / batched / 1e6 << " M/s"
+                  << " | speedup: " << std::setprecision(2) << per_call / batched << "x" << std::endl;
+    };
+    
+    measure("Random", random_agent, repetitions);
+    measure("Q-Learning", q_agent, repetitions);
+    measure("DQN", dqn_agent, std::max<size_t>(1, repetitions / 16));
+}
+
+void solveExactly(int board_size, int max_length, size_t num_threads) {
+    std::cout << "=== Exact Value Iteration ===" << std::endl;
+    
+    SolverConfig config;
+    config.board_size = board_size;
+    config.max_length = max_length;
+    config.num_threads = num_threads;
+    
+    ValueIterationSolver solver(config);
+    SolverStats stats = solver.solve();
+    std::cout << "Optimal start value: " << std::fixed << std::setprecision(3) << solver.getStartValue()
+              << " (residual " << std::scientific << std::setprecision(2) << stats.residual << ")" << std::endl;
+    
+    if (!solver.canExportPolicy()) {
+        std::cout << "Board differs from the game board; policy not exported" << std::endl;
+        return;
+    }
+    
+    // Greedy tabular agent acting on the projected optimal Q-values
+    QLearningAgent agent(0.1, config.discount_factor, 0.0);
+    size_t keys = solver.exportPolicy(agent);
+    agent.save("q_solver_model.txt");
+    std::cout << "Exported " << keys << " state keys to 'q_solver_model.txt'" << std::endl;
+    
+    const int num_episodes = 100;
+    SnakeEnvironment env(true);
+    env.setMaxSteps(500);
+    double total_score = 0.0;
+    for (int episode = 0; episode < num_episodes; ++episode) {
+        auto state = env.reset();
+        while (!env.isDone()) {
+            state = env.step(agent.selectAction(state)).first;
+        }
+        total_score += env.getInfo()[0];
+    }
+    std::cout << "Solver policy average score over " << num_episodes << " episodes: "
+              << std::fixed << std::setprecision(2) << total_score / num_episodes << std::endl;
+}
+
+void trainDistributed(size_t num_workers, size_t episodes, size_t sync_interval, bool use_dqn) {
+    std::cout << "=== Distributed Training ===" << std::endl;
+    
+    DistributedConfig config;
+    config.algorithm = use_dqn ? DistributedAlgorithm::DQN : DistributedAlgorithm::Q_LEARNING;
+    config.num_workers = num_workers;
+    config.episodes_per_worker = episodes;
+    config.sync_interval = sync_interval;
+    config.model_path = use_dqn ? "dqn_model.txt" : "q_learning_model.txt";
+    
+    DistributedTrainer trainer(config);
+    trainer.run();
+    std::cout << "Model saved as '" << config.model_path << "'" << std::endl;
+}
+
+void trainSharedQLearningAgent(int episodes, const std::string& name, size_t slots) {
+    std::cout << "=== Training Q-Learning Agent (shared table " << name << ") ===" << std::endl;
+    
+    // Every process started with the same name trains the same table
+    auto table = std::make_shared<SharedQTable>(name, slots);
+    std::cout << (table->createdSegment() ? "Created" : "Attached to") << " shared Q-table with "
+              << table->capacity() << " slots (" << table->size() << " states)" << std::endl;
+    
+    SnakeEnvironment env(true);
+    QLearningAgent agent(0.1, 0.95, 0.3);
+    agent.useSharedTable(table);
+    env.setMaxSteps(500);
+    agent.train(env, episodes);
+    
+    std::cout << "Shared Q-table now holds " << table->size() << " states" << std::endl;
+}
+
+void evaluateSharedQLearningAgent(int episodes, const std::string& name) {
+    std::cout << "=== Evaluating Q-Learning Agent (shared table " << name << ") ===" << std::endl;
+    
+    // Read-only attachment: lookups read the shared pages directly
+    auto table = std::make_shared<SharedQTable>(name, 0, true);
+    QLearningAgent agent(0.1, 0.95, 0.0);
+    agent.useSharedTable(table);
+    
+    SnakeEnvironment env(true);
+    env.setMaxSteps(500);
+    double total_score = 0.0;
+    for (int episode = 0; episode < episodes; ++episode) {
+        auto state = env.reset();
+        while (!env.isDone()) {
+            state = env.step(agent.selectAction(state)).first;
+        }
+        total_score += env.getInfo()[0];
+    }
+    std::cout << "States: " << table->size() << " | Average score over " << episodes << " episodes: "
+              << std::fixed << std::setprecision(2) << total_score / episodes << std::endl;
+}
+
+void benchmarkEligibilityTraces(double target_score, size_t max_episodes, double lambda) {
+    std::cout << "=== Eligibility Trace Benchmark (target: " << target_score
+              << " avg score over 100 episodes, lambda " << lambda << ") ===" << std::endl;
+    
+    // Trains until the rolling average score reaches the target, with the same
+    // exploration schedule for every agent
+    auto run = [&](const char* name, QLearningAgent& agent) {
+        SnakeEnvironment env(true);
+        env.setMaxSteps(500);
+        
+        const size_t window = 100;
+        std::vector<double> scores;
+        double window_sum = 0.0;
+        double epsilon = 0.3;
+        size_t steps = 0;
+        bool reached = false;
+        
+        auto start = std::chrono::steady_clock::now();
+        while (scores.size() < max_episodes && !reached) {
+            agent.setEpsilon(epsilon);
+            auto state = env.reset();
+            while (!env.isDone()) {
+                int action = agent.selectAction(state);
+                auto [next_state, reward] = env.step(action);
+                agent.update(state, action, reward, next_state, env.isDone());
+                state = next_state;
+                steps++;
+            }
+            epsilon = std::max(0.01, epsilon * 0.995);
+            
+            scores.push_back(env.getInfo()[0]);
+            window_sum += scores.back();
+            if (scores.size() > window) {
+                window_sum -= scores[scores.size() - 1 - window];
+            }
+            reached = scores.size() >= window && window_sum / window >= target_score;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        std::cout << std::left << std::setw(14) << name << std::right
+                  << (reached ? " reached" : " missed ") << " after " << std::setw(6) << scores.size() << " episodes"
+                  << " | " << std::setw(9) << steps << " steps"
+                  << " | " << std::fixed << std::setprecision(2) << std::setw(7) << seconds << " s"
+                  << " | Avg score: " << window_sum / std::min(window, scores.size())
+                  << " | Q-table size: " << agent.getTableStats().size << std::endl;
+    };
+    
+    QLearningAgent q_learning(0.1, 0.95, 0.3);
+    EligibilityTraceAgent watkins(0.1, 0.95, 0.3, lambda, TraceMode::WATKINS_Q);
+    EligibilityTraceAgent sarsa(0.1, 0.95, 0.3, lambda, TraceMode::SARSA);
+    run("Q-learning", q_learning);
+    run("Q(lambda)", watkins);
+    run("SARSA(lambda)", sarsa);
+}
+
+void benchmarkPlanning(size_t episodes, size_t planning_steps, long budget_us) {
+    std::cout << "=== Planning Benchmark (" << episodes << " episodes, " << planning_steps
+              << " planning updates per step";
+    if (budget_us > 0) {
+        std::cout << ", " << budget_us << " us budget";
+    }
+    std::cout << ") ===" << std::endl;
+    
+    // Same exploration schedule for both agents; scores are the last 100 episodes
+    auto run = [&](const char* name, QLearningAgent& agent) {
+        SnakeEnvironment env(true);
+        env.setMaxSteps(500);
+        
+        const size_t window = std::min<size_t>(100, episodes);
+        double window_sum = 0.0;
+        double epsilon = 0.3;
+        size_t steps = 0;
+        
+        auto start = std::chrono::steady_clock::now();
+        for (size_t episode = 0; episode < episodes; ++episode) {
+            agent.setEpsilon(epsilon);
+            auto state = env.reset();
+            while (!env.isDone()) {
+                int action = agent.selectAction(state);
+                auto [next_state, reward] = env.step(action);
+                agent.update(state, action, reward, next_state, env.isDone());
+                state = next_state;
+                steps++;
+            }
+            epsilon = std::max(0.01, epsilon * 0.995);
+            if (episode + window >= episodes) {
+                window_sum += env.getInfo()[0];
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        std::cout << std::left << std::setw(20) << name << std::right
+                  << " | " << std::setw(8) << steps << " real steps"
+                  << " | " << std::fixed << std::setprecision(2) << std::setw(6) << seconds << " s"
+                  << " | Avg score: " << window_sum / window
+                  << " | Q-table size: " << agent.getTableStats().size << std::endl;
+    };
+    
+    QLearningAgent q_learning(0.1, 0.95, 0.3);
+    PrioritizedSweepingAgent sweeping(0.1, 0.95, 0.3, planning_steps);
+    sweeping.setPlanningBudget(std::chrono::microseconds(budget_us));
+    run("Q-learning", q_learning);
+    run("Prioritized sweeping", sweeping);
+    
+    std::cout << "Planning updates: " << sweeping.getPlanningUpdates()
+              << " | " << std::fixed << std::setprecision(2) << sweeping.getPlanningUpdatesPerSecond() / 1e6
+              << " M updates/s | Model: " << sweeping.getModelSize() << " states, "
+              << std::setprecision(1) << sweeping.getModelBytes() / (1024.0 * 1024.0) << " MB"
+              << " | Queued: " << sweeping.getQueueSize() << std::endl;
+}
+
+void benchmarkCheckpoints(size_t episodes, size_t interval, size_t runs) {
+    const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "=== Checkpoint Benchmark (" << episodes << " episodes, checkpoint every "
+              << interval << ", " << runs << " runs, " << cores << " cores) ===" << std::endl;
+    
+    // Identical training runs; the second hands a snapshot to the writer every interval episodes
+    auto run = [&](const char* name, CheckpointWriter* writer) {
+        SnakeEnvironment env(true);
+        env.setMaxSteps(500);
+        QLearningAgent agent(0.1, 0.95, 0.3);
+        size_t steps = 0;
+        
+        auto start = std::chrono::steady_clock::now();
+        for (size_t episode = 0; episode < episodes; ++episode) {
+            auto state = env.reset();
+            while (!env.isDone()) {
+                int action = agent.selectAction(state);
+                auto [next_state, reward] = env.step(action);
+                agent.update(state, action, reward, next_state, env.isDone());
+                state = next_state;
+                steps++;
+            }
+            if (writer && (episode + 1) % interval == 0) {
+                writer->submit(agent, episode + 1);
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        std::cout << std::left << std::setw(18) << name << std::right
+                  << " | " << std::fixed << std::setprecision(2) << std::setw(6) << seconds << " s"
+                  << " | " << std::setprecision(0) << std::setw(9) << steps / seconds << " steps/s"
+                  << " | Q-table size: " << agent.getTableStats().size << std::endl;
+        return steps / seconds;
+    };
+    
+    // Alternate the two runs, so drift in machine load hits both alike
+    CheckpointConfig config;
+    config.prefix = "bench_checkpoint";
+    config.keep_last = 2;
+    std::vector<double> ratios;
+    for (size_t r = 0; r < runs; ++r) {
+        double baseline = run("No checkpoints", nullptr);
+        CheckpointWriter writer(config);
+        double checkpointed = run("Background writer", &writer);
+        writer.flush();
+        
+        CheckpointStats stats = writer.getStats();
+        ratios.push_back(checkpointed / baseline * 100.0);
+        std::cout << "Throughput: " << std::fixed << std::setprecision(1) << ratios.back()
+                  << "% of baseline | Written: " << stats.written << " | Skipped: " << stats.skipped
+                  << " | Snapshot: " << std::setprecision(2) << stats.snapshot_seconds * 1000.0 << " ms total"
+                  << " | Writer: " << stats.write_seconds * 1000.0 << " ms total" << std::endl;
+        
+        // Leave no benchmark files behind
+        for (size_t episode = interval; episode <= episodes; episode += interval) {
+            std::remove(writer.pathFor(episode).c_str());
+        }
+    }
+    
+    std::sort(ratios.begin(), ratios.end());
+    std::cout << "Throughput over " << runs << " runs: " << std::fixed << std::setprecision(1)
+              << "min " << ratios.front() << "% | median " << ratios[ratios.size() / 2]
+              << "% | max " << ratios.back() << "% of baseline" << std::endl;
+    if (cores == 1) {
+        // Snapshots are the only cost on the training thread; here the
+        // writer's formatting also competes with training for the one core
+        std::cout << "Single core: the writer thread's time is taken from training" << std::endl;
+    }
+}
+
+void benchmarkDeltaCheckpoints(size_t episodes, size_t interval) {
+    std::cout << "=== Delta Checkpoint Benchmark (" << episodes << " episodes, checkpoint every "
+              << interval << ") ===" << std::endl;
+    
+    const std::string text_path = "bench_delta.txt";
+    const std::string delta_path = "bench_delta.qck";
+    SnakeEnvironment env(true);
+    env.setMaxSteps(500);
+    QLearningAgent agent(0.1, 0.95, 0.3);
+    DeltaCheckpointWriter delta_writer(delta_path, DeltaCheckpointWriter::DEFAULT_QUANTIZATION_STEP, episodes);
+    ModelSnapshot snapshot;
+    
+    size_t text_bytes = 0, delta_bytes = 0;
+    double text_seconds = 0.0, delta_seconds = 0.0;
+    for (size_t episode = 1; episode <= episodes; ++episode) {
+        auto state = env.reset();
+        while (!env.isDone()) {
+            int action = agent.selectAction(state);
+            auto [next_state, reward] = env.step(action);
+            agent.update(state, action, reward, next_state, env.isDone());
+            state = next_state;
+        }
+        // The last episode always checkpoints, like train(), so there is a chain to replay
+        if (episode % interval != 0 && episode != episodes) {
+            continue;
+        }
+        
+        // Same snapshot both ways: full text dump vs changed rows only
+        agent.takeSnapshot(snapshot);
+        auto start = std::chrono::steady_clock::now();
+        std::ofstream text(text_path);
+        snapshot.write(text);
+        size_t text_size = static_cast<size_t>(text.tellp());
+        text.close();
+        auto middle = std::chrono::steady_clock::now();
+        DeltaCheckpointStats stats = delta_writer.write(snapshot);
+        auto end = std::chrono::steady_clock::now();
+        
+        text_bytes += text_size;
+        delta_bytes += stats.bytes;
+        text_seconds += std::chrono::duration<double>(middle - start).count();
+        delta_seconds += std::chrono::duration<double>(end - middle).count();
+        std::cout << "Episode " << std::setw(6) << episode << " | Rows: " << std::setw(7) << snapshot.keys.size()
+                  << " | Text: " << std::setw(9) << text_size << " B"
+                  << " | " << (stats.base ? "Base: " : "Delta:") << std::setw(9) << stats.bytes << " B"
+                  << " (" << stats.changed_rows << " changed, " << stats.removed_rows << " removed)" << std::endl;
+    }
+    
+    // Replay the chain and check it against the last snapshot
+    ModelSnapshot restored;
+    DeltaChainInfo info = DeltaCheckpointWriter::load(delta_path, restored);
+    double max_error = 0.0;
+    bool same_keys = restored.keys.size() == snapshot.keys.size();
+    if (same_keys) {
+        QTable reference;
+        for (size_t i = 0; i < snapshot.keys.size(); ++i) {
+            reference.findOrInsert(snapshot.keys[i]) = snapshot.rows[i];
+        }
+        for (size_t i = 0; i < restored.keys.size() && same_keys; ++i) {
+            const QTable::Row* row = reference.find(restored.keys[i]);
+            same_keys = row != nullptr;
+            for (int action = 0; same_keys && action < QTable::NUM_ACTIONS; ++action) {
+                max_error = std::max(max_error, std::abs(row->q[action] - restored.rows[i].q[action]));
+            }
+        }
+    }
+    
+    std::cout << std::fixed << std::setprecision(2)
+              << "Total written: text " << text_bytes / (1024.0 * 1024.0) << " MB in " << text_seconds * 1000.0
+              << " ms | delta " << delta_bytes / (1024.0 * 1024.0) << " MB in " << delta_seconds * 1000.0
+              << " ms incl. fsync (" << std::setprecision(1) << static_cast<double>(text_bytes) / std::max<size_t>(1, delta_bytes)
+              << "x smaller)" << std::endl;
+    std::cout << "Chain replay: " << info.files << " files, " << restored.keys.size() << " rows, "
+              << (same_keys ? "keys match" : "KEYS DIFFER") << ", max value error "
+              << std::scientific << std::setprecision(2) << max_error << std::endl;
+    
+    DeltaChainInfo compacted = DeltaCheckpointWriter::compact(delta_path);
+    std::ifstream base(delta_path, std::ios::binary | std::ios::ate);
+    std::cout << "Compacted " << compacted.files << " files (" << std::fixed << std::setprecision(2)
+              << compacted.bytes / (1024.0 * 1024.0) << " MB) into one base of "
+              << static_cast<size_t>(base.tellg()) / (1024.0 * 1024.0) << " MB" << std::endl;
+    
+    // Leave no benchmark files behind
+    std::remove(text_path.c_str());
+    std::remove(delta_path.c_str());
+}
+
+void printEvaluationSummary(const EvaluationReport& report) {
+    std::cout << std::left << std::setw(12) << report.agent_name << std::right << std::fixed << std::setprecision(3)
+              << " | Score: " << report.score.mean << " [" << report.score.ci_low << ", " << report.score.ci_high << "]"
+              << " median " << std::setprecision(1) << report.score.median << " p95 " << report.score.p95
+              << " | Length: " << report.length.mean << " | Reward: " << report.reward.mean
+              << " | " << std::setprecision(2) << report.seconds << " s on " << report.threads << " threads" << std::endl;
+}
+
+void evaluateInParallel(size_t episodes, size_t threads, const std::string& report_path) {
+    std::cout << "=== Parallel Evaluation (" << episodes << " episodes) ===" << std::endl;
+    
+    // Workers get private copies of the loaded model
+    QLearningAgent loaded;
+    loaded.load("q_learning_model.txt");
+    auto snapshot = std::make_shared<ModelSnapshot>();
+    loaded.takeSnapshot(*snapshot);
+    
+    EvaluationConfig config;
+    config.episodes = episodes;
+    config.num_threads = threads;
+    EvaluationEngine engine(config);
+    
+    EvaluationReport random_report = engine.evaluate([]() { return std::make_unique<RandomAgent>(); }, "random");
+    EvaluationReport q_report = engine.evaluate([snapshot]() {
+        auto agent = std::make_unique<QLearningAgent>();
+        agent->restoreSnapshot(*snapshot);
+        return agent;
+    }, "q-learning");
+    
+    printEvaluationSummary(random_report);
+    printEvaluationSummary(q_report);
+    q_report.writeJson(report_path);
+    std::cout << "Report written to " << report_path << std::endl;
+}
+
+void exportEpisodeVideos(size_t episodes, const ExportConfig& config, bool use_random, const std::string& log_path) {
+    std::cout << "=== Exporting " << episodes << " Episodes ("
+              << (config.format == ExportFormat::GIF ? "GIF" : "PPM sequence") << ", every "
+              << config.frame_skip << " step(s)) ===" << std::endl;
+    
+    AgentFactory make_agent = []() { return std::make_unique<RandomAgent>(); };
+    if (!use_random && log_path.empty()) {
+        QLearningAgent loaded;
+        loaded.load("q_learning_model.txt");
+        auto snapshot = std::make_shared<ModelSnapshot>();
+        loaded.takeSnapshot(*snapshot);
+        make_agent = [snapshot]() {
+            auto agent = std::make_unique<QLearningAgent>();
+            agent->restoreSnapshot(*snapshot);
+            return agent;
+        };
+    }
+    
+    EpisodeExporter exporter(config);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<EpisodeRecording> recordings;
+    if (log_path.empty()) {
+        recordings = exporter.record(make_agent, episodes);
+    } else {
+        // Episodes already logged by train --record need no agent at all
+        TrajectoryReader log(log_path);
+        for (size_t i = 0; i < std::min(episodes, log.size()); ++i) {
+            recordings.push_back(log.read(i));
+        }
+    }
+    double record_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    start = std::chrono::steady_clock::now();
+    std::vector<ExportResult> results = exporter.exportEpisodes(recordings);
+    double export_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    size_t frames = 0, bytes = 0, steps = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const ExportResult& result = results[i];
+        frames += result.frames;
+        bytes += result.bytes;
+        steps += result.steps;
+        if (i < 10) {
+            std::cout << "  " << result.path << " | Score: " << result.score << " | Steps: " << result.steps
+                      << " | Frames: " << result.frames << " | " << result.bytes / 1024 << " KB" << std::endl;
+        }
+    }
+    if (results.size() > 10) {
+        std::cout << "  ... " << results.size() - 10 << " more" << std::endl;
+    }
+    std::cout << std::fixed << std::setprecision(3) << "Recorded " << steps << " steps in " << record_seconds
+              << " s; exported " << frames << " frames (" << std::setprecision(2) << bytes / (1024.0 * 1024.0)
+              << " MB) in " << std::setprecision(3) << export_seconds << " s = " << std::setprecision(0)
+              << frames / export_seconds << " frames/s" << std::endl;
+}
+
+void replayTrajectory(const std::string& path, size_t episode, size_t step) {
+    TrajectoryReader log(path);
+    std::cout << "=== Replaying episode " << episode << " of " << log.size() << " in " << path << " ===" << std::endl;
+    
+    TrajectoryReplayer replayer(log.read(episode));
+    const EpisodeRecording& recording = replayer.getRecording();
+    std::cout << "Seed: " << recording.seed << " | Steps: " << recording.actions.size()
+              << " | Score: " << recording.score << std::endl;
+    
+    std::string mismatch;
+    if (replayer.verify(&mismatch)) {
+        std::cout << "Replay matches the recording" << std::endl;
+    } else {
+        std::cout << "Replay DIFFERS: " << mismatch << std::endl;
+    }
+    
+    // Board after the requested step, top row first
+    replayer.seek(step);
+    const SnakeGame::Game& game = replayer.getGame();
+    std::vector<std::string> rows(SnakeGame::GameConfig::GRID_SIZE_Y, std::string(SnakeGame::GameConfig::GRID_SIZE_X, '.'));
+    auto mark = [&](const SnakeGame::Position& pos, char symbol) {
+        int column = pos[0] + SnakeGame::GameConfig::GRID_SIZE_X / 2;
+        int row = SnakeGame::GameConfig::GRID_SIZE_Y / 2 - 1 - pos[1];
+        if (column >= 0 && column < SnakeGame::GameConfig::GRID_SIZE_X && row >= 0 && row < SnakeGame::GameConfig::GRID_SIZE_Y) {
+            rows[row][column] = symbol;
+        }
+    };
+    mark(game.getApple().getPosition(), '*');
+    const auto& body = game.getSnake().getAllPositions();
+    for (size_t i = body.size(); i-- > 0;) {
+        mark(body[i], i == 0 ? '@' : '#');
+    }
+    std::cout << "Step " << replayer.getStep() << " | Score: " << game.getScore()
+              << (game.isGameOver() ? " | Game over" : "") << std::endl;
+    for (const std::string& row : rows) {
+        std::cout << "  " << row << std::endl;
+    }
+}
+
+void benchmarkTrajectoryRecording(size_t episodes) {
+    std::cout << "=== Trajectory Recording Benchmark (" << episodes << " random-agent episodes) ===" << std::endl;
+    const std::string path = "bench_trajectories.trj";
+    
+    double baseline = 0.0;
+    auto run = [&](const char* name, bool record, bool rewards) {
+        std::remove(path.c_str());
+        SnakeEnvironment env(true);
+        env.setMaxSteps(500);
+        env.setSeed(7);
+        std::shared_ptr<TrajectoryWriter> writer;
+        if (record) {
+            writer = std::make_shared<TrajectoryWriter>(path, rewards);
+            env.setRecorder(writer);
+        }
+        RandomAgent agent;
+        agent.setSeed(11);
+        
+        size_t steps = 0;
+        std::vector<double> scores;
+        scores.reserve(episodes);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t episode = 0; episode < episodes; ++episode) {
+            auto state = env.reset();
+            while (!env.isDone()) {
+                state = env.step(agent.selectAction(state)).first;
+                steps++;
+            }
+            scores.push_back(env.getInfo()[0]);
+        }
+        if (writer) {
+            env.setRecorder(nullptr);
+            writer->flush();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double ns_per_step = seconds * 1e9 / steps;
+        if (!record) {
+            baseline = ns_per_step;
+        }
+        
+        std::cout << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(0)
+                  << " | " << std::setw(9) << steps / seconds << " steps/s | " << std::setprecision(1)
+                  << std::setw(6) << ns_per_step << " ns/step | Overhead: " << std::setw(5) << ns_per_step - baseline << " ns";
+        if (writer) {
+            std::cout << " | " << std::setprecision(3) << static_cast<double>(writer->getBytes()) / steps
+                      << " bytes/step, " << writer->getBytes() / 1024 << " KB";
+        }
+        std::cout << std::endl;
+        return scores;
+    };
+    
+    // Recording must not change what a seeded run plays
+    std::vector<double> unrecorded = run("No recorder", false, false);
+    bool same_scores = run("Actions + rewards", true, true) == unrecorded;
+    same_scores = run("Actions only", true, false) == unrecorded && same_scores;
+    std::cout << "Recorded scores " << (same_scores ? "match" : "DIFFER FROM") << " the unrecorded run" << std::endl;
+    
+    // Read the last log back and replay every episode against it
+    auto start = std::chrono::steady_clock::now();
+    TrajectoryReader log(path);
+    std::vector<EpisodeRecording> recordings;
+    for (size_t i = 0; i < log.size(); ++i) {
+        recordings.push_back(log.read(i));
+    }
+    double read_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    start = std::chrono::steady_clock::now();
+    size_t verified = 0;
+    std::string mismatch, first_mismatch;
+    for (EpisodeRecording& recording : recordings) {
+        TrajectoryReplayer replayer(std::move(recording));
+        if (replayer.verify(&mismatch)) {
+            verified++;
+        } else if (first_mismatch.empty()) {
+            first_mismatch = mismatch;
+        }
+    }
+    double replay_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setprecision(3) << "Read " << log.size() << " episodes in " << read_seconds
+              << " s; replayed " << log.getSteps() << " steps in " << replay_seconds << " s = "
+              << std::setprecision(0) << log.getSteps() / replay_seconds << " steps/s; verified "
+              << verified << "/" << log.size() << std::endl;
+    if (!first_mismatch.empty()) {
+        std::cout << "First mismatch: " << first_mismatch << std::endl;
+    }
+    std::remove(path.c_str());
+    if (!same_scores || verified != log.size()) {
+        throw std::runtime_error("Recorded episodes do not reproduce the unrecorded run");
+    }
+}
+
+void benchmarkEvaluation(size_t episodes) {
+    std::cout << "=== Evaluation Benchmark (" << episodes << " episodes, random agent) ===" << std::endl;
+    
+    // Reports must match across thread counts apart from timing fields
+    auto metrics = [](const EvaluationReport& report) {
+        std::string json = report.toJson();
+        return json.substr(json.find("\"metrics\""));
+    };
+    
+    std::string reference;
+    for (size_t threads : {1, 2, 4, 8}) {
+        EvaluationConfig config;
+        config.episodes = episodes;
+        config.num_threads = threads;
+        EvaluationEngine engine(config);
+        EvaluationReport report = engine.evaluate([]() { return std::make_unique<RandomAgent>(); }, "random");
+        
+        if (reference.empty()) {
+            reference = metrics(report);
+        }
+        std::cout << std::setw(2) << threads << " threads | " << std::fixed << std::setprecision(3)
+                  << std::setw(7) << report.seconds << " s | "
+                  << std::setprecision(0) << std::setw(8) << episodes / report.seconds << " episodes/s | Mean score: "
+                  << std::setprecision(4) << report.score.mean
+                  << (metrics(report) == reference ? " | identical" : " | DIFFERENT") << std::endl;
+    }
+}
+
+void benchmarkMetrics(size_t records) {
+    std::cout << "=== Metrics Logging Benchmark (" << records << " records) ===" << std::endl;
+    
+    // Stand-in for per-episode results
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> reward_dist(-100.0, 50.0);
+    std::vector<EpisodeMetrics> samples(1024);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i].reward = reward_dist(rng);
+        samples[i].length = static_cast<uint32_t>(rng() % 500);
+        samples[i].score = static_cast<uint32_t>(rng() % 10);
+        samples[i].epsilon = 0.3;
+        samples[i].table_size = 10000 + i;
+    }
+    
+    auto report = [&](const char* name, double producer_seconds, double total_seconds, size_t dropped) {
+        std::cout << std::left << std::setw(22) << name << std::right << std::fixed
+                  << " | Producer: " << std::setprecision(1) << std::setw(7) << producer_seconds * 1e9 / records << " ns/record"
+                  << " | Total: " << std::setprecision(3) << std::setw(6) << total_seconds << " s"
+                  << " | Dropped: " << dropped << std::endl;
+    };
+    
+    // Baseline: the training thread formats and flushes every line itself
+    const std::string sync_path = "bench_metrics_sync.csv";
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::ofstream file(sync_path);
+        file << "source,episode,reward,length,score,epsilon,table_size" << std::endl;
+        for (size_t i = 0; i < records; ++i) {
+            const EpisodeMetrics& m = samples[i % samples.size()];
+            file << 0 << "," << i + 1 << "," << m.reward << "," << m.length << "," << m.score << ","
+                 << m.epsilon << "," << m.table_size << std::endl;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report("Synchronous std::endl", seconds, seconds, 0);
+    }
+    
+    // The training thread only enqueues; formatting and I/O happen on the sink's thread.
+    // Paced runs wait for the writer every half queue, as slower real episodes would;
+    // the burst run never waits and shows records being dropped instead of blocking.
+    auto run = [&](const char* name, MetricsFormat format, bool paced) {
+        MetricsConfig config;
+        config.path = format == MetricsFormat::CSV ? "bench_metrics_async.csv" : "bench_metrics_async.bin";
+        config.format = format;
+        config.console_interval = std::chrono::milliseconds(0);
+        
+        auto start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::duration producer_time{0};
+        size_t dropped = 0;
+        {
+            MetricsSink sink(config);
+            auto channel = sink.openChannel();
+            const size_t batch = paced ? config.queue_capacity / 2 : records;
+            for (size_t first = 0; first < records; first += batch) {
+                size_t last = std::min(records, first + batch);
+                auto produce_start = std::chrono::steady_clock::now();
+                for (size_t i = first; i < last; ++i) {
+                    EpisodeMetrics m = samples[i % samples.size()];
+                    m.episode = i + 1;
+                    channel->record(m);
+                }
+                producer_time += std::chrono::steady_clock::now() - produce_start;
+                sink.flush();
+            }
+            dropped = sink.getDropped();
+            if (sink.getWriteFailures() > 0) {
+                std::cout << "  write failures: " << sink.getWriteFailures() << std::endl;
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::ifstream written(config.path, std::ios::binary | std::ios::ate);
+        report(name, std::chrono::duration<double>(producer_time).count(), seconds, dropped);
+        std::cout << "  file size: " << std::setprecision(2)
+                  << static_cast<size_t>(written.tellg()) / (1024.0 * 1024.0) << " MB" << std::endl;
+        std::remove(config.path.c_str());
+    };
+    run("Metrics sink (CSV)", MetricsFormat::CSV, true);
+    run("Metrics sink (binary)", MetricsFormat::BINARY, true);
+    run("Burst, no pacing (CSV)", MetricsFormat::CSV, false);
+    
+    std::ifstream sync_file(sync_path, std::ios::binary | std::ios::ate);
+    std::cout << "Synchronous file size: " << std::setprecision(2)
+              << static_cast<size_t>(sync_file.tellg()) / (1024.0 * 1024.0) << " MB" << std::endl;
+    std::remove(sync_path.c_str());
+}
+
+void benchmarkConsoleView(size_t steps, double fps) {
+#ifdef _WIN32
+    const char* null_device = "NUL";
+#else
+    const char* null_device = "/dev/null";
+#endif
+    std::cout << "=== Console Live View Benchmark (" << steps << " random-agent steps, output to "
+              << null_device << ") ===" << std::endl;
+    
+    std::FILE* sink = std::fopen(null_device, "w");
+    if (!sink) {
+        throw std::runtime_error(std::string("Could not open ") + null_device);
+    }
+    
+    double baseline = 0.0;
+    auto run = [&](const char* name, bool view, double max_fps, bool diff) {
+        SnakeEnvironment env(true);
+        env.setMaxSteps(500);
+        env.setSeed(3);
+        SnakeGame::ConsoleGraphics* console = nullptr;
+        if (view) {
+            SnakeGame::ConsoleConfig config;
+            config.max_fps = max_fps;
+            config.diff = diff;
+            config.output = sink;
+            auto graphics = std::make_unique<SnakeGame::ConsoleGraphics>(config);
+            console = graphics.get();
+            env.setLiveView(std::move(graphics));
+        }
+        RandomAgent agent;
+        agent.setSeed(5);
+        
+        auto start = std::chrono::steady_clock::now();
+        auto state = env.reset();
+        for (size_t step = 0; step < steps; ++step) {
+            state = env.step(agent.selectAction(state)).first;
+            if (env.isDone()) {
+                state = env.reset();
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double ns_per_step = seconds * 1e9 / steps;
+        if (!view) {
+            baseline = ns_per_step;
+        }
+        
+        std::cout << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(0)
+                  << " | " << std::setw(9) << steps / seconds << " steps/s | " << std::setprecision(1)
+                  << std::setw(7) << ns_per_step << " ns/step | Overhead: " << std::setw(7) << ns_per_step - baseline << " ns";
+        if (console) {
+            SnakeGame::ConsoleStats stats = console->getStats();
+            size_t frames = std::max<size_t>(1, stats.frames_written);
+            std::cout << " | Frames: " << std::setw(7) << stats.frames_written << " | " << std::setprecision(1)
+                      << std::setw(6) << static_cast<double>(stats.bytes_written) / frames << " bytes/frame, "
+                      << static_cast<double>(stats.cells_written) / frames << " cells/frame";
+        }
+        std::cout << std::endl;
+        env.setLiveView(nullptr);
+    };
+    
+    run("Headless", false, 0.0, true);
+    std::ostringstream throttled;
+    throttled << "Diffed, " << fps << " fps";
+    run(throttled.str().c_str(), true, fps, true);
+    run("Diffed, every step", true, 0.0, true);
+    run("Full redraw, every step", true, 0.0, false);
+    std::fclose(sink);
+}
+
+void benchmarkPixels(size_t frames, size_t size, bool rgb, size_t depth) {
+    std::cout << "=== Pixel Observation Benchmark (" << frames << " frames, " << size << "x" << size
+              << (rgb ? " RGB" : " grayscale") << ", stack of " << depth << ", 16 envs) ===" << std::endl;
+    
+    PixelConfig config;
+    config.width = size;
+    config.height = size;
+    config.format = rgb ? PixelFormat::RGB : PixelFormat::GRAYSCALE;
+    
+    // Same seeds in both runs, so the observation checksums must agree
+    uint64_t reference = 0;
+    auto run = [&](const char* name, bool incremental) {
+        const size_t num_envs = 16;
+        std::vector<std::unique_ptr<SnakeEnvironment>> envs;
+        std::vector<std::unique_ptr<PixelRenderer>> renderers;
+        std::vector<std::unique_ptr<FrameStack>> stacks;
+        std::vector<std::vector<double>> states;
+        for (size_t i = 0; i < num_envs; ++i) {
+            envs.push_back(std::make_unique<SnakeEnvironment>(true));
+            envs[i]->setMaxSteps(500);
+            envs[i]->setSeed(static_cast<unsigned int>(i + 1));
+            states.push_back(envs[i]->reset());
+            renderers.push_back(std::make_unique<PixelRenderer>(config));
+            stacks.push_back(std::make_unique<FrameStack>(renderers[i]->frameSize(), depth));
+            stacks[i]->reset(renderers[i]->render(envs[i]->getGame()));
+        }
+        RandomAgent agent;
+        agent.setSeed(11);
+        
+        uint64_t checksum = 0;
+        size_t rendered = 0;
+        std::chrono::steady_clock::duration render_time{0};
+        auto start = std::chrono::steady_clock::now();
+        while (rendered < frames) {
+            for (size_t i = 0; i < num_envs; ++i) {
+                states[i] = envs[i]->step(agent.selectAction(states[i])).first;
+            }
+            
+            auto render_start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < num_envs; ++i) {
+                if (!incremental) {
+                    renderers[i]->invalidate();
+                }
+                stacks[i]->push(renderers[i]->render(envs[i]->getGame()));
+            }
+            render_time += std::chrono::steady_clock::now() - render_start;
+            rendered += num_envs;
+            
+            for (size_t i = 0; i < num_envs; ++i) {
+                const uint8_t* observation = stacks[i]->observation();
+                checksum = checksum * 31 + observation[(rendered * 7919 + i) % stacks[i]->observationSize()];
+                if (envs[i]->isDone()) {
+                    states[i] = envs[i]->reset();
+                    stacks[i]->reset(renderers[i]->render(envs[i]->getGame()));
+                }
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double render_seconds = std::chrono::duration<double>(render_time).count();
+        size_t cells = 0;
+        for (const auto& renderer : renderers) {
+            cells += renderer->getCellsPainted();
+        }
+        if (reference == 0) {
+            reference = checksum;
+        }
+        
+        std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(0)
+                  << " | Render+stack: " << std::setw(9) << rendered / render_seconds << " frames/s ("
+                  << std::setprecision(1) << std::setw(5) << render_seconds * 1e9 / rendered << " ns)"
+                  << " | With env steps: " << std::setprecision(0) << std::setw(8) << rendered / seconds << " frames/s"
+                  << " | Cells/frame: " << std::setprecision(1) << std::setw(5) << static_cast<double>(cells) / rendered
+                  << (checksum == reference ? " | identical" : " | DIFFERENT") << std::endl;
+    };
+    run("Incremental", true);
+    run("Full repaint", false);
+}
+
+std::vector<double> parseValueList(const std::string& text) {
+    std::vector<double> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        values.push_back(std::stod(item));
+    }
+    return values;
+}
+
+void runSweep(int argc, char* argv[]) {
+    // Positional: mode, episodes, threads; key=value lists replace the default search space
+    std::vector<std::string> positional;
+    SweepSpace space;
+    SweepConfig config;
+    config.max_episodes = 2700;
+    size_t trials = 27;
+    size_t min_episodes = 0;
+    std::string csv_path;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t equals = arg.find('=');
+        if (arg == "--trials" && i + 1 < argc) {
+            trials = std::stoul(argv[++i]);
+        } else if (arg == "--eta" && i + 1 < argc) {
+            config.eta = std::stoul(argv[++i]);
+        } else if (arg == "--min" && i + 1 < argc) {
+            min_episodes = std::stoul(argv[++i]);
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (equals != std::string::npos) {
+            std::string key = arg.substr(0, equals);
+            std::vector<double> values = parseValueList(arg.substr(equals + 1));
+            if (key == "lr") {
+                space.learning_rates = values;
+            } else if (key == "gamma") {
+                space.discount_factors = values;
+            } else if (key == "epsilon") {
+                space.epsilons = values;
+            } else if (key == "decay") {
+                space.epsilon_decays = values;
+            } else {
+                throw std::invalid_argument("Unknown sweep parameter: " + key);
+            }
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    std::string mode = (positional.size() > 0) ? positional[0] : "grid";
+    if (positional.size() > 1) {
+        config.max_episodes = std::stoul(positional[1]);
+    }
+    config.num_threads = (positional.size() > 2) ? std::stoul(positional[2]) : 0;
+    
+    // By default the first cut happens after three rungs' worth of halving
+    config.min_episodes = min_episodes > 0 ? min_episodes
+        : std::max<size_t>(1, config.max_episodes / (config.eta * config.eta * config.eta));
+    
+    std::vector<HyperParameters> configurations;
+    if (mode == "grid") {
+        configurations = space.grid();
+    } else if (mode == "random") {
+        configurations = space.sample(trials, config.seed);
+    } else {
+        throw std::invalid_argument("Sweep mode must be grid or random: " + mode);
+    }
+    
+    SweepRunner runner(config);
+    std::cout << "=== Hyperparameter Sweep (" << mode << ", " << configurations.size() << " configurations, "
+              << config.min_episodes << "-" << config.max_episodes << " episodes, eta " << config.eta << ") ===" << std::endl;
+    SweepReport report = runner.run(configurations);
+    
+    std::cout << report.toTable();
+    std::cout << report.rungs << " rungs in " << std::fixed << std::setprecision(2) << report.seconds << " s on "
+              << report.threads << " threads | Worker utilization: " << std::setprecision(1)
+              << report.busy_seconds / (report.seconds * report.threads) * 100.0 << "%" << std::endl;
+    if (!csv_path.empty()) {
+        report.writeCsv(csv_path);
+        std::cout << "Summary written to " << csv_path << std::endl;
+    }
+}
+
+void benchmarkPopulationTraining(double target_score, size_t population, size_t max_episodes,
+                                 size_t threads, bool use_dqn) {
+    std::cout << "=== Population-Based Training Benchmark (" << (use_dqn ? "DQN" : "Q-learning") << ", "
+              << population << " members, target " << target_score << " avg score) ===" << std::endl;
+    
+    // Both runs start from the same random hyperparameters
+    SweepSpace space;
+    PopulationAgentFactory make_agent;
+    if (use_dqn) {
+        space.learning_rates = {1e-4, 3e-3};
+        space.discount_factors = {0.9, 0.99};
+        space.epsilons = {0.5, 1.0};
+        space.epsilon_decays = {0.99, 0.999};
+        make_agent = [](const HyperParameters& params, unsigned int seed) {
+            DQNConfig config;
+            config.learning_rate = params.learning_rate;
+            config.discount_factor = params.discount_factor;
+            config.epsilon = params.epsilon;
+            config.replay_capacity = 20000;
+            config.seed = seed;
+            return std::make_unique<DQNAgent>(17, 4, config);
+        };
+    } else {
+        space.learning_rates = {0.01, 0.5};
+        space.discount_factors = {0.8, 0.99};
+        space.epsilons = {0.05, 0.5};
+        space.epsilon_decays = {0.99, 0.9995};
+        make_agent = [](const HyperParameters& params, unsigned int seed) {
+            auto agent = std::make_unique<QLearningAgent>(params.learning_rate, params.discount_factor, params.epsilon);
+            agent->setSeed(seed);
+            return agent;
+        };
+    }
+    std::vector<HyperParameters> initial = space.sample(population, 42);
+    
+    auto run = [&](const char* name, bool exploit) {
+        PopulationConfig config;
+        config.max_episodes = max_episodes;
+        config.ready_episodes = use_dqn ? 50 : 100;
+        config.target_score = target_score;
+        config.exploit = exploit;
+        config.num_threads = threads;
+        PopulationTrainer trainer(config);
+        PopulationReport report = trainer.run(make_agent, initial);
+        
+        const MemberResult& best = report.members.front();
+        std::cout << std::left << std::setw(18) << name << std::right << std::fixed << std::setprecision(2)
+                  << " | Best fitness: " << std::setw(5) << best.fitness << " | Time to target: ";
+        if (report.target_seconds >= 0.0) {
+            std::cout << std::setw(6) << report.target_seconds << " s (" << report.target_episodes << " episodes each)";
+        } else {
+            std::cout << "not reached in " << report.seconds << " s";
+        }
+        std::cout << " | Exploits: " << report.exploits << " (clone " << std::setprecision(1)
+                  << report.clone_seconds * 1000.0 << " ms)"
+                  << " | Utilization: " << report.busy_seconds / (report.seconds * report.threads) * 100.0 << "%"
+                  << std::endl;
+        std::cout << "  best: lr " << std::setprecision(4) << best.params.learning_rate
+                  << ", gamma " << best.params.discount_factor << ", epsilon " << best.params.epsilon
+                  << ", decay " << best.params.epsilon_decay << std::endl;
+        return report.target_seconds;
+    };
+    
+    double independent = run("Independent runs", false);
+    double pbt = run("PBT", true);
+    if (independent > 0.0 && pbt > 0.0) {
+        std::cout << "Speedup to target: " << std::setprecision(2) << independent / pbt << "x" << std::endl;
+    }
+}
+
+ESConfig makeESConfig(size_t population, bool use_mlp) {
+    ESConfig config;
+    config.population = population;
+    if (use_mlp) {
+        config.hidden_layers = {32};
+    }
+    return config;
+}
+
+void trainESAgent(size_t generations, size_t population, bool use_mlp) {
+    std::cout << "=== Training ES Agent (" << (use_mlp ? "MLP" : "linear") << " policy) ===" << std::endl;
+    
+    ESAgent agent(17, 4, makeESConfig(population, use_mlp));
+    SnakeEnvironment env(true);
+    env.setMaxSteps(500);
+    env.setRewardStructure(10.0, -100.0, -1.0);
+    
+    agent.train(env, generations * population);
+    agent.evaluate(env, 100);
+    agent.save("es_model.txt");
+    std::cout << "Model saved as 'es_model.txt'" << std::endl;
+}
+
+void benchmarkES(size_t generations, size_t population, bool use_mlp) {
+    std::cout << "=== ES Scaling Benchmark (" << generations << " generations of " << population << " episodes, "
+              << (use_mlp ? "MLP" : "linear") << " policy) ===" << std::endl;
+    
+    // Same seeds everywhere, so every thread count must end with the same policy
+    std::vector<size_t> thread_counts = {1};
+    for (size_t threads = 2; threads <= std::max(2u, std::thread::hardware_concurrency()); threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    
+    double baseline = 0.0;
+    std::vector<float> reference;
+    for (size_t threads : thread_counts) {
+        ESConfig config = makeESConfig(population, use_mlp);
+        config.num_threads = threads;
+        ESAgent agent(17, 4, config);
+        agent.runGeneration(); // Warm-up: creates workers and environments
+        
+        size_t episodes = 0, steps = 0;
+        double seconds = 0.0, mean_score = 0.0;
+        for (size_t generation = 0; generation < generations; ++generation) {
+            ESGenerationStats stats = agent.runGeneration();
+            episodes += stats.episodes;
+            steps += stats.steps;
+            seconds += stats.seconds;
+            mean_score = stats.mean_score;
+        }
+        double rate = episodes / seconds;
+        if (baseline == 0.0) {
+            baseline = rate;
+            reference = agent.getPolicy().getParameters();
+        }
+        std::cout << std::setw(2) << threads << " threads | " << std::fixed << std::setprecision(0)
+                  << std::setw(8) << rate << " episodes/s | " << std::setw(9) << steps / seconds << " steps/s | "
+                  << std::setprecision(3) << std::setw(6) << seconds / generations << " s/generation | Scaling: "
+                  << std::setprecision(2) << rate / baseline << "x | Mean score: " << mean_score
+                  << (agent.getPolicy().getParameters() == reference ? " | identical" : " | DIFFERENT") << std::endl;
+    }
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 2) {
         printUsage(argv[0]);
@@ -155,8 +1696,36 @@ int main(int argc, char* argv[]) {
     
     try {
         if (command == "train") {
-            int episodes = (argc > 2) ? std::stoi(argv[2]) : 1000;
-            trainQLearningAgent(episodes);
+            // Flags may appear anywhere after the command
+            std::vector<std::string> positional;
+            bool use_symmetry = false;
+            size_t checkpoint_interval = 0;
+            bool delta_checkpoints = false;
+            std::string metrics_path;
+            double watch_fps = 0.0;
+            std::string record_path;
+            for (int i = 2; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == "--symmetry") {
+                    use_symmetry = true;
+                } else if (arg == "--checkpoint" && i + 1 < argc) {
+                    checkpoint_interval = std::stoul(argv[++i]);
+                } else if (arg == "--delta") {
+                    delta_checkpoints = true;
+                } else if (arg == "--metrics" && i + 1 < argc) {
+                    metrics_path = argv[++i];
+                } else if (arg == "--watch" && i + 1 < argc) {
+                    watch_fps = std::stod(argv[++i]);
+                } else if (arg == "--record" && i + 1 < argc) {
+                    record_path = argv[++i];
+                } else {
+                    positional.push_back(arg);
+                }
+            }
+            int episodes = (positional.size() > 0) ? std::stoi(positional[0]) : 1000;
+            size_t memory_mb = (positional.size() > 1) ? std::stoul(positional[1]) : 0;
+            trainQLearningAgent(episodes, memory_mb, use_symmetry, checkpoint_interval, delta_checkpoints, metrics_path,
+                                watch_fps, record_path);
         } else if (command == "evaluate") {
             int episodes = (argc > 2) ? std::stoi(argv[2]) : 10;
             evaluateQLearningAgent(episodes);
@@ -164,6 +1733,192 @@ int main(int argc, char* argv[]) {
             runDemo();
         } else if (command == "compare") {
             compareAgents();
+        } else if (command == "train-dqn") {
+            int episodes = (argc > 2) ? std::stoi(argv[2]) : 2000;
+            trainDQNAgent(episodes);
+        } else if (command == "collect-dataset") {
+            std::vector<std::string> positional;
+            bool use_random = false;
+            for (int i = 2; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == "--random") {
+                    use_random = true;
+                } else {
+                    positional.push_back(arg);
+                }
+            }
+            size_t transitions = (positional.size() > 0) ? std::stoul(positional[0]) : 1000000;
+            std::string path = (positional.size() > 1) ? positional[1] : "transitions.ofd";
+            collectDataset(transitions, path, use_random);
+        } else if (command == "bench-dataset") {
+            size_t transitions = (argc > 2) ? std::stoul(argv[2]) : 2000000;
+            size_t batch_size = (argc > 3) ? std::stoul(argv[3]) : 256;
+            benchmarkDataset(transitions, batch_size);
+        } else if (command == "bench-dqn") {
+            size_t threads = (argc > 2) ? std::stoul(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+            benchmarkDQN(threads);
+        } else if (command == "bench-select") {
+            size_t batch_size = (argc > 2) ? std::stoul(argv[2]) : 1024;
+            benchmarkActionSelection(batch_size);
+        } else if (command == "solve") {
+            int board_size = (argc > 2) ? std::stoi(argv[2]) : SnakeGame::GameConfig::GRID_SIZE_X;
+            int max_length = (argc > 3) ? std::stoi(argv[3]) : 5;
+            size_t threads = (argc > 4) ? std::stoul(argv[4]) : 0;
+            solveExactly(board_size, max_length, threads);
+        } else if (command == "train-shared") {
+            int episodes = (argc > 2) ? std::stoi(argv[2]) : 1000;
+            std::string name = (argc > 3) ? argv[3] : "/snake_q_table";
+            size_t slots = (argc > 4) ? std::stoul(argv[4]) : (1 << 21);
+            trainSharedQLearningAgent(episodes, name, slots);
+        } else if (command == "evaluate-shared") {
+            int episodes = (argc > 2) ? std::stoi(argv[2]) : 100;
+            std::string name = (argc > 3) ? argv[3] : "/snake_q_table";
+            evaluateSharedQLearningAgent(episodes, name);
+        } else if (command == "remove-shared") {
+            std::string name = (argc > 2) ? argv[2] : "/snake_q_table";
+            std::cout << (SharedQTable::remove(name) ? "Removed " : "No shared Q-table named ") << name << std::endl;
+        } else if (command == "bench-traces") {
+            double target_score = (argc > 2) ? std::stod(argv[2]) : 3.8;
+            size_t max_episodes = (argc > 3) ? std::stoul(argv[3]) : 20000;
+            double lambda = (argc > 4) ? std::stod(argv[4]) : 0.7;
+            benchmarkEligibilityTraces(target_score, max_episodes, lambda);
+        } else if (command == "bench-planning") {
+            size_t episodes = (argc > 2) ? std::stoul(argv[2]) : 2000;
+            size_t planning_steps = (argc > 3) ? std::stoul(argv[3]) : 10;
+            long budget_us = (argc > 4) ? std::stol(argv[4]) : 0;
+            benchmarkPlanning(std::max<size_t>(1, episodes), planning_steps, budget_us);
+        } else if (command == "bench-checkpoint") {
+            size_t episodes = (argc > 2) ? std::stoul(argv[2]) : 20000;
+            size_t interval = (argc > 3) ? std::stoul(argv[3]) : 5000;
+            size_t runs = (argc > 4) ? std::stoul(argv[4]) : 5;
+            benchmarkCheckpoints(episodes, std::max<size_t>(1, interval), std::max<size_t>(1, runs));
+        } else if (command == "bench-delta") {
+            size_t episodes = (argc > 2) ? std::stoul(argv[2]) : 10000;
+            size_t interval = (argc > 3) ? std::stoul(argv[3]) : 1000;
+            benchmarkDeltaCheckpoints(std::max<size_t>(1, episodes), std::max<size_t>(1, interval));
+        } else if (command == "compact-checkpoint") {
+            std::string path = (argc > 2) ? argv[2] : "q_checkpoint.qck";
+            DeltaChainInfo info = DeltaCheckpointWriter::compact(path);
+            std::cout << "Compacted " << info.files << " checkpoint files into " << path << std::endl;
+        } else if (command == "evaluate-parallel") {
+            size_t episodes = (argc > 2) ? std::stoul(argv[2]) : 10000;
+            size_t threads = (argc > 3) ? std::stoul(argv[3]) : 0;
+            std::string report_path = (argc > 4) ? argv[4] : "evaluation_report.json";
+            evaluateInParallel(episodes, threads, report_path);
+        } else if (command == "export-episodes") {
+            std::vector<std::string> positional;
+            ExportConfig config;
+            bool use_random = false;
+            std::string log_path;
+            for (int i = 2; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == "--ppm") {
+                    config.format = ExportFormat::PPM_SEQUENCE;
+                } else if (arg == "--random") {
+                    use_random = true;
+                } else if (arg == "--dir" && i + 1 < argc) {
+                    config.directory = argv[++i];
+                } else if (arg == "--threads" && i + 1 < argc) {
+                    config.num_threads = std::stoul(argv[++i]);
+                } else if (arg == "--log" && i + 1 < argc) {
+                    log_path = argv[++i];
+                } else {
+                    positional.push_back(arg);
+                }
+            }
+            size_t episodes = (positional.size() > 0) ? std::stoul(positional[0]) : 8;
+            config.frame_skip = (positional.size() > 1) ? std::stoul(positional[1]) : 1;
+            exportEpisodeVideos(episodes, config, use_random, log_path);
+        } else if (command == "replay") {
+            std::string path = (argc > 2) ? argv[2] : "trajectories.trj";
+            size_t episode = (argc > 3) ? std::stoul(argv[3]) : 0;
+            size_t step = (argc > 4) ? std::stoul(argv[4]) : static_cast<size_t>(-1);
+            replayTrajectory(path, episode, step);
+        } else if (command == "bench-record") {
+            size_t episodes = (argc > 2) ? std::stoul(argv[2]) : 20000;
+            benchmarkTrajectoryRecording(episodes);
+        } else if (command == "bench-eval") {
+            size_t episodes = (argc > 2) ? std::stoul(argv[2]) : 10000;
+            benchmarkEvaluation(episodes);
+        } else if (command == "train-es" || command == "bench-es") {
+            std::vector<std::string> positional;
+            bool use_mlp = false;
+            for (int i = 2; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == "--mlp") {
+                    use_mlp = true;
+                } else {
+                    positional.push_back(arg);
+                }
+            }
+            bool bench = command == "bench-es";
+            size_t generations = (positional.size() > 0) ? std::stoul(positional[0]) : (bench ? 3 : 50);
+            size_t population = (positional.size() > 1) ? std::stoul(positional[1]) : 256;
+            if (bench) {
+                benchmarkES(generations, population, use_mlp);
+            } else {
+                trainESAgent(generations, population, use_mlp);
+            }
+        } else if (command == "bench-pbt") {
+            std::vector<std::string> positional;
+            bool use_dqn = false;
+            for (int i = 2; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == "--dqn") {
+                    use_dqn = true;
+                } else {
+                    positional.push_back(arg);
+                }
+            }
+            double target_score = (positional.size() > 0) ? std::stod(positional[0]) : (use_dqn ? 4.5 : 4.0);
+            size_t population = (positional.size() > 1) ? std::stoul(positional[1]) : (use_dqn ? 4 : 8);
+            size_t episodes = (positional.size() > 2) ? std::stoul(positional[2]) : (use_dqn ? 300 : 5000);
+            size_t threads = (positional.size() > 3) ? std::stoul(positional[3]) : 0;
+            benchmarkPopulationTraining(target_score, population, episodes, threads, use_dqn);
+        } else if (command == "sweep") {
+            runSweep(argc, argv);
+        } else if (command == "bench-console") {
+            size_t steps = (argc > 2) ? std::stoul(argv[2]) : 1000000;
+            double fps = (argc > 3) ? std::stod(argv[3]) : 30.0;
+            benchmarkConsoleView(steps, fps);
+        } else if (command == "bench-pixels") {
+            std::vector<std::string> positional;
+            bool rgb = false;
+            size_t depth = 4;
+            for (int i = 2; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == "--rgb") {
+                    rgb = true;
+                } else if (arg == "--stack" && i + 1 < argc) {
+                    depth = std::stoul(argv[++i]);
+                } else {
+                    positional.push_back(arg);
+                }
+            }
+            size_t frames = (positional.size() > 0) ? std::stoul(positional[0]) : 1000000;
+            size_t size = (positional.size() > 1) ? std::stoul(positional[1]) : 84;
+            benchmarkPixels(frames, size, rgb, depth);
+        } else if (command == "bench-metrics") {
+            size_t records = (argc > 2) ? std::stoul(argv[2]) : 1000000;
+            benchmarkMetrics(records);
+        } else if (command == "train-distributed") {
+            std::vector<std::string> positional;
+            bool use_dqn = false;
+            for (int i = 2; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == "--dqn") {
+                    use_dqn = true;
+                } else {
+                    positional.push_back(arg);
+                }
+            }
+            size_t workers = (positional.size() > 0) ? std::stoul(positional[0]) : 4;
+            size_t episodes = (positional.size() > 1) ? std::stoul(positional[1]) : 1000;
+            size_t sync_interval = (positional.size() > 2) ? std::stoul(positional[2]) : 50;
+            trainDistributed(workers, episodes, sync_interval, use_dqn);
+        } else if (command == "bench-replay") {
+            size_t capacity = (argc > 2) ? std::stoul(argv[2]) : (1 << 20);
+            benchmarkReplayBuffer(capacity);
         } else {
             std::cout << "Unknown command: " << command << std::endl;
             printUsage(argv[0]);